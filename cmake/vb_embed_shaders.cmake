@@ -0,0 +1,139 @@
+# Compile shaders at build time and embed SPIR-V into a target
+#
+# vb_embed_shaders(<target>
+#     [HEADER <file name>]      # Generated header, default: <target>_shaders.hpp
+#     [COMPILER <executable>]   # Default: glslc from Vulkan SDK
+#     SHADER <name> <source> [<compile option>...]
+#     [SHADER <name> <source> [<compile option>...]]...
+# )
+#
+# Generated header defines in namespace named after the header (e.g. vector_addition_shaders):
+#   alignas(4) inline constexpr std::uint32_t <name>[] = {...};
+#   inline constexpr vb::EmbeddedShader kRegistry[] = {{"<name>", <name>}, ...};
+# Use vb::EmbeddedSource(shader) as PipelineStage::source to create pipelines without file I/O.
+# Names are made valid C identifiers. Sources are relative to current source directory.
+
+set(VB_EMBED_SPIRV_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/vb_embed_spirv.cmake)
+
+if(Vulkan_GLSLC_EXECUTABLE)
+	set(VB_GLSLC_EXECUTABLE ${Vulkan_GLSLC_EXECUTABLE})
+else()
+	find_program(VB_GLSLC_EXECUTABLE glslc)
+endif()
+
+function(vb_embed_shaders target)
+	set(header ${target}_shaders.hpp)
+	set(compiler ${VB_GLSLC_EXECUTABLE})
+	set(shaders)
+
+	# Collect SHADER groups as "|" separated strings
+	set(current_key)
+	set(group)
+	foreach(arg IN LISTS ARGN)
+		if(arg STREQUAL "SHADER")
+			if(group)
+				list(JOIN group "|" group_string)
+				list(APPEND shaders "${group_string}")
+			endif()
+			set(current_key SHADER)
+			set(group)
+		elseif(arg STREQUAL "HEADER" OR arg STREQUAL "COMPILER")
+			set(current_key ${arg})
+		elseif(current_key STREQUAL "HEADER")
+			set(header ${arg})
+			set(current_key)
+		elseif(current_key STREQUAL "COMPILER")
+			set(compiler ${arg})
+			set(current_key)
+		elseif(current_key STREQUAL "SHADER")
+			list(APPEND group "${arg}")
+		else()
+			message(FATAL_ERROR "vb_embed_shaders: unexpected argument ${arg}")
+		endif()
+	endforeach()
+	if(group)
+		list(JOIN group "|" group_string)
+		list(APPEND shaders "${group_string}")
+	endif()
+	if(NOT shaders)
+		message(FATAL_ERROR "vb_embed_shaders: no SHADER given for ${target}")
+	endif()
+	if(NOT compiler)
+		message(FATAL_ERROR "vb_embed_shaders: shader compiler not found")
+	endif()
+
+	set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders)
+	get_filename_component(header_name ${header} NAME_WE)
+	string(MAKE_C_IDENTIFIER ${header_name} header_namespace)
+	get_filename_component(compiler_name ${compiler} NAME_WE)
+
+	set(arrays)
+	set(registry)
+	set(inc_files)
+	foreach(shader IN LISTS shaders)
+		string(REPLACE "|" ";" shader "${shader}")
+		list(POP_FRONT shader name source)
+		if(NOT source)
+			message(FATAL_ERROR "vb_embed_shaders: SHADER ${name} has no source")
+		endif()
+		string(MAKE_C_IDENTIFIER ${name} name)
+		get_filename_component(source ${source} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+		set(spv ${out_dir}/${name}.spv)
+		set(inc ${out_dir}/${name}.spv.inc)
+
+		# Rebuild when included files change
+		set(depfile_args)
+		set(depfile_options)
+		if(compiler_name STREQUAL "glslc")
+			set(depfile_args DEPFILE ${spv}.d)
+			set(depfile_options -MD -MF ${spv}.d -MT ${spv})
+		endif()
+
+		add_custom_command(
+			OUTPUT ${spv}
+			COMMAND ${CMAKE_COMMAND} -E make_directory ${out_dir}
+			COMMAND ${compiler} ${source} -o ${spv} ${depfile_options} ${shader}
+			DEPENDS ${source}
+			${depfile_args}
+			COMMENT "Compiling SPIR-V: ${name}"
+			VERBATIM
+			COMMAND_EXPAND_LISTS
+		)
+		add_custom_command(
+			OUTPUT ${inc}
+			COMMAND ${CMAKE_COMMAND} -DINPUT=${spv} -DOUTPUT=${inc} -P ${VB_EMBED_SPIRV_SCRIPT}
+			DEPENDS ${spv} ${VB_EMBED_SPIRV_SCRIPT}
+			COMMENT "Embedding SPIR-V: ${name}"
+			VERBATIM
+		)
+		list(APPEND inc_files ${inc})
+		string(APPEND arrays "alignas(4) inline constexpr std::uint32_t ${name}[] = {\n#include \"${target}_shaders/${name}.spv.inc\"\n};\n\n")
+		string(APPEND registry "\t{\"${name}\", ${name}},\n")
+	endforeach()
+
+	file(CONFIGURE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${header} CONTENT
+"// Generated by vb_embed_shaders() for ${target}, do not edit
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <cstdint>
+#endif
+
+#ifndef VB_BUILD_CPP_MODULE
+#include <vulkan_backend/embedded_shader.hpp>
+#endif
+
+#ifndef VB_NAMESPACE
+#define VB_NAMESPACE vb
+#endif
+
+namespace ${header_namespace} {
+${arrays}inline constexpr VB_NAMESPACE::EmbeddedShader kRegistry[] = {
+${registry}};
+} // namespace ${header_namespace}
+" @ONLY)
+
+	add_custom_target(${target}_embedded_shaders DEPENDS ${inc_files})
+	add_dependencies(${target} ${target}_embedded_shaders)
+	target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+endfunction()
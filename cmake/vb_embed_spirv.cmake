@@ -0,0 +1,15 @@
+# Script mode helper of vb_embed_shaders()
+# cmake -DINPUT=<file.spv> -DOUTPUT=<file.spv.inc> -P vb_embed_spirv.cmake
+# Writes SPIR-V words as comma separated hex literals to be included in an array initializer
+
+file(READ "${INPUT}" hex HEX)
+string(LENGTH "${hex}" length)
+math(EXPR remainder "${length} % 8")
+if(length EQUAL 0 OR NOT remainder EQUAL 0)
+	message(FATAL_ERROR "${INPUT} is not a SPIR-V binary")
+endif()
+
+# SPIR-V is stored as little-endian words
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," words "${hex}")
+string(REGEX REPLACE "((0x........,)(0x........,)(0x........,)(0x........,)(0x........,)(0x........,)(0x........,)(0x........,))" "\\1\n" words "${words}")
+file(WRITE "${OUTPUT}" "${words}\n")
@@ -0,0 +1,213 @@
+#ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_BUILD_CPP_MODULE
+#include <vulkan_backend/core.hpp>
+#else
+import vulkan_backend;
+#endif
+
+// Command buffers from a CommandAllocator submitted three ways:
+//   upload:   one buffer per chunk, collected by SubmitBatch and submitted with one submit2
+//   readback: one buffer per thread, submitted concurrently through QueueSubmitter
+//   render:   rendering scope recorded in parallel into secondary buffers with RenderParallel
+// No shaders, the image is cleared by the load op and copied back to check each frame
+
+vb::QueueInfo constexpr queue_info = {.flags = vk::QueueFlagBits::eGraphics};
+
+int main() {
+	int constexpr			kVectorSize	 = 64 * 1024;
+	int constexpr			kChunkCount	 = 8;
+	int constexpr			kChunkSize	 = kVectorSize / kChunkCount;
+	int constexpr			kThreadCount = 4;
+	std::uint32_t constexpr kImageSize	 = 256;
+	int constexpr			kFrameCount	 = 3;
+
+	vb::SetLogLevel(vb::LogLevel::Trace);
+
+	vb::Instance instance({.optional_layers = {{vb::kValidationLayerName}}});
+
+	// Select physical device with graphics queue
+	std::vector<vb::PhysicalDevice> physical_devices;
+	physical_devices.reserve(instance.GetPhysicalDevices().size());
+	vb::PhysicalDevice* physical_device = nullptr;
+	for (auto& vk_device : instance.GetPhysicalDevices()) {
+		auto& current_device = physical_devices.emplace_back(vk_device);
+		current_device.GetDetails();
+		if (current_device.SupportsQueue(queue_info)) {
+			physical_device = &current_device;
+			break;
+		}
+	}
+	if (physical_device == nullptr) {
+		std::printf("No physical device with graphics queue support found\n");
+		return 1;
+	}
+
+	// Tickets are timeline semaphore values, rendering is dynamic
+	vk::PhysicalDeviceFeatures2		   features2{};
+	vk::PhysicalDeviceVulkan12Features vulkan12_features{.timelineSemaphore = vk::True};
+	vk::PhysicalDeviceVulkan13Features vulkan13_features{.synchronization2 = vk::True, .dynamicRendering = vk::True};
+	void* feature_chain[] = {&features2, &vulkan12_features, &vulkan13_features};
+	vb::SetupStructureChain(feature_chain);
+
+	std::uint32_t const queue_family = physical_device->FindQueueFamilyIndex(queue_info);
+	vb::Device device(instance, *physical_device,
+					  {.queues	  = {{{.queueFamilyIndex = queue_family, .queueCount = 1}}},
+					   .features2 = &features2});
+
+	vb::Queue const& queue = *device.GetQueue(queue_info);
+
+	vb::CommandAllocator allocator(device, {.frames_in_flight = 2});
+
+	vb::Buffer source(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = vk::BufferUsageFlagBits::eTransferSrc},
+		.memory		 = vb::Memory::eCPU,
+		.name		 = "Source",
+	});
+	vb::Buffer device_buffer(device, {
+		.create_info = {.size  = kVectorSize * sizeof(int),
+						.usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst},
+		.name		 = "Device",
+	});
+	vb::Buffer readback(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = vk::BufferUsageFlagBits::eTransferDst},
+		.memory		 = vb::Memory::eCPU,
+		.name		 = "Readback",
+	});
+	int* source_data = reinterpret_cast<int*>(source.GetMappedData());
+	std::iota(source_data, source_data + kVectorSize, 0);
+
+	// Upload: chunks are copied by separate command buffers, flushed together
+	{
+		vb::SubmitBatch batch(queue);
+		for (int i = 0; i < kChunkCount; ++i) {
+			std::uint32_t const offset = i * kChunkSize * sizeof(int);
+			vb::Command&		cmd	   = allocator.AllocatePrimary(queue_family);
+			cmd.Begin();
+			cmd.Copy(device_buffer, source, kChunkSize * sizeof(int), offset, offset);
+			cmd.End();
+			batch.Add(cmd);
+		}
+		queue.Wait(batch.Flush());
+		vb::SubmitBatchStats const& stats = batch.GetStats();
+		std::printf("Upload: %u command buffers in %u submits\n", stats.command_buffers, stats.flushes);
+	}
+	allocator.NextFrame();
+
+	// Readback: each thread records and submits its part, tickets are waited for after join
+	{
+		vb::QueueSubmitter submitter(queue);
+		std::vector<vb::SubmitTicket> tickets(kThreadCount);
+		std::vector<std::thread>	  threads;
+		for (int t = 0; t < kThreadCount; ++t) {
+			threads.emplace_back([&, t] {
+				int constexpr kPartSize = kVectorSize / kThreadCount;
+				std::uint32_t const offset	  = t * kPartSize * sizeof(int);
+				vb::Command&		cmd		  = allocator.AllocatePrimary(queue_family);
+				cmd.Begin();
+				// Writes of the upload submission are made visible to this one
+				cmd.Barrier(vb::MemoryBarrier{
+					.srcStageMask  = vk::PipelineStageFlagBits2::eCopy,
+					.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+					.dstStageMask  = vk::PipelineStageFlagBits2::eCopy,
+					.dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+				});
+				cmd.Copy(readback, device_buffer, kPartSize * sizeof(int), offset, offset);
+				cmd.End();
+				tickets[t] = submitter.Submit(cmd);
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		for (auto const& ticket : tickets) {
+			queue.Wait(ticket);
+		}
+		vb::QueueSubmitterStats const stats = submitter.GetStats();
+		std::printf("Readback: %llu submissions in %llu submits\n", static_cast<unsigned long long>(stats.submissions),
+					static_cast<unsigned long long>(stats.submit_calls));
+	}
+	allocator.NextFrame();
+
+	int const* readback_data = reinterpret_cast<int const*>(readback.GetMappedData());
+	if (std::memcmp(readback_data, source_data, kVectorSize * sizeof(int)) != 0) {
+		std::printf("Readback does not match source\n");
+		return 1;
+	}
+
+	vb::Image image(device, {
+		.create_info = {
+			.imageType	 = vk::ImageType::e2D,
+			.format		 = vk::Format::eR8G8B8A8Unorm,
+			.extent		 = {kImageSize, kImageSize, 1},
+			.mipLevels	 = 1,
+			.arrayLayers = 1,
+			.samples	 = vk::SampleCountFlagBits::e1,
+			.usage		 = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+		},
+		.aspect = vk::ImageAspectFlagBits::eColor,
+		.name	= "Color",
+	});
+	vb::Buffer pixels(device, {
+		.create_info = {.size = kImageSize * kImageSize * 4, .usage = vk::BufferUsageFlagBits::eTransferDst},
+		.memory		 = vb::Memory::eCPU,
+		.name		 = "Pixels",
+	});
+
+	// Render: rows of the image are split between secondary buffers, each sets its own scissor
+	for (int frame = 0; frame < kFrameCount; ++frame) {
+		float const red = frame % 2 == 0 ? 1.0f : 0.0f;
+		vb::RenderingInfo::ColorAttachment const color_attachments[] = {{
+			.color_image = image,
+			.clear_value = {{{red, 1.0f - red, 0.0f, 1.0f}}},
+		}};
+
+		std::atomic<std::uint32_t> recorded_rows = 0;
+		vb::Command&			   cmd			 = allocator.AllocatePrimary(queue_family);
+		cmd.Begin();
+		cmd.Access(image, vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite,
+				   vk::ImageLayout::eColorAttachmentOptimal);
+		cmd.RenderParallel({.color_attachments = color_attachments}, allocator, kImageSize,
+						   [&](vb::Command& secondary, std::size_t begin, std::size_t end) {
+							   secondary.SetViewport({0.0f, 0.0f, float(kImageSize), float(kImageSize)});
+							   secondary.SetScissor({{0, static_cast<std::int32_t>(begin)},
+													 {kImageSize, static_cast<std::uint32_t>(end - begin)}});
+							   recorded_rows += static_cast<std::uint32_t>(end - begin);
+						   });
+		cmd.Access(image, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead,
+				   vk::ImageLayout::eTransferSrcOptimal);
+		cmd.Copy(pixels, image, 0, {}, {kImageSize, kImageSize, 1});
+		cmd.End();
+		queue.Wait(cmd.Submit(queue));
+
+		std::uint8_t const	expected[4] = {std::uint8_t(red * 255), std::uint8_t((1.0f - red) * 255), 0, 255};
+		std::uint8_t const* data		= reinterpret_cast<std::uint8_t const*>(pixels.GetMappedData());
+		for (std::uint32_t i = 0; i < kImageSize * kImageSize; ++i) {
+			if (std::memcmp(data + i * 4, expected, sizeof(expected)) != 0) {
+				std::printf("Frame %d: pixel %u does not match clear color\n", frame, i);
+				return 1;
+			}
+		}
+		if (recorded_rows != kImageSize) {
+			std::printf("Frame %d: %u rows recorded instead of %u\n", frame, recorded_rows.load(), kImageSize);
+			return 1;
+		}
+		allocator.NextFrame();
+	}
+
+	vb::CommandAllocatorStats const stats = allocator.GetStats();
+	std::printf("Allocator: %u pools, %u primary and %u secondary buffers, %llu pool resets\n", stats.pools,
+				stats.primary_buffers, stats.secondary_buffers, static_cast<unsigned long long>(stats.pool_resets));
+	std::printf("Success!\n");
+	return 0;
+}
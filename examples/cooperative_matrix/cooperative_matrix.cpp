@@ -9,6 +9,7 @@ import std;
 import vulkan_backend;
 #endif
 
+#include "cooperative_matrix_shaders.hpp"
 #include "util.hpp"
 #include "float16_t.hpp"
 #include "matrix.hpp"
@@ -149,20 +150,31 @@ void RunTest(TestParams const& params) {
 		.outputD = matD.deviceBuffer.GetAddress(),
 	};
 
-	char spv_file[256];
-	std::snprintf(spv_file, sizeof(spv_file) - 1, "cooperative_matrix_%c%llu_%c%llu.comp.spv",
+	// Shader variants are compiled at build time by vb_embed_shaders()
+	char shader_name[256];
+	std::snprintf(shader_name, sizeof(shader_name) - 1, "cooperative_matrix_%c%llu_%c%llu",
 				  TypeToString<AType>()[0], sizeof(AType) * 8, TypeToString<ResultType>()[0],
 				  sizeof(ResultType) * 8);
+	vb::EmbeddedShader const shader = vb::FindEmbeddedShader(cooperative_matrix_shaders::kRegistry, shader_name);
+	if (shader.code.empty()) {
+		std::printf("Shader %s is not embedded\n", shader_name);
+		return;
+	}
 
-	vb::Pipeline pipeline(device, {
+	// Variants with the same specialization constants share one pipeline
+	auto pipeline = device.GetComputePipelineCache().GetOrCreate({
 	  .stages = {{{
 		  .stage			   = vk::ShaderStageFlagBits::eCompute,
-		  .source			   = {spv_file, vb::Source::Type::FileSpirV},
+		  .source			   = vb::EmbeddedSource(shader),
 		  .specialization_info = vb::util::MakeSpecializationInfo(specData),
 	  }}},
 	  .layout = params.pipeline_layout,
 	  .name = "Cooperative Matrix",
   });
+	if (!pipeline) {
+		std::printf("Failed to create pipeline for %s\n", shader_name);
+		return;
+	}
 
 	// Record and submit command buffer
 	cmd.Begin();
@@ -172,8 +184,8 @@ void RunTest(TestParams const& params) {
 	cmd.Barrier(matA.deviceBuffer);
 	cmd.Barrier(matB.deviceBuffer);
 	cmd.Barrier(matC.deviceBuffer);
-	cmd.BindPipeline(pipeline);
-	cmd.PushConstants(pipeline,  &constants, sizeof(constants));
+	cmd.BindPipeline(*pipeline);
+	cmd.PushConstants(*pipeline, &constants, sizeof(constants));
 	cmd.Dispatch(params.N / tileN, params.M / tileM, 1);
 	cmd.Barrier(matD.deviceBuffer);
 	cmd.Copy(matD.hostBuffer, matD.deviceBuffer);
@@ -240,6 +252,7 @@ int main(int argc, char* argv[]) {
 		.storageBuffer8BitAccess = vk::True,
 		.shaderFloat16			 = vk::True,
 		.shaderInt8				 = vk::True,
+		.timelineSemaphore		 = vk::True,
 		.bufferDeviceAddress	 = vk::True,
 		.vulkanMemoryModel		 = vk::True,
 	};
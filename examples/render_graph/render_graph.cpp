@@ -0,0 +1,287 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_BUILD_CPP_MODULE
+#include <vulkan_backend/core.hpp>
+#else
+import vulkan_backend;
+#endif
+
+// SPIR-V compiled at build time by vb_embed_shaders(), otherwise shader is compiled at runtime
+#if __has_include("render_graph_shaders.hpp")
+#include "render_graph_shaders.hpp"
+#define EMBEDDED_SHADERS
+#endif
+
+// Chain of vector additions declared as render graph passes:
+//   sum = a + b, other = b + b, doubled = sum + sum, plus = doubled + other, result = plus + plus
+// Sum and Other are independent and share a barrier batch, Unused pass is culled and
+// plus reuses memory of sum. A second graph clears an image in a raster pass and copies it back,
+// commands of the passes declare the same accesses as the graph and must not add barriers.
+// No surface is needed, so it runs headless (including lavapipe)
+
+vb::QueueInfo constexpr queue_info = {.flags = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute};
+
+int main() {
+	int constexpr kVectorSize	 = 64 * 1024;
+	int constexpr kWorkgroupSize = 16;
+	int constexpr kFrameCount	 = 2;
+
+	vb::SetLogLevel(vb::LogLevel::Trace);
+
+	vb::Instance instance({.optional_layers = {{vb::kValidationLayerName}}});
+
+	// Select physical device with graphics and compute queue
+	std::vector<vb::PhysicalDevice> physical_devices;
+	physical_devices.reserve(instance.GetPhysicalDevices().size());
+	vb::PhysicalDevice* physical_device = nullptr;
+	for (auto& vk_device : instance.GetPhysicalDevices()) {
+		auto& current_device = physical_devices.emplace_back(vk_device);
+		current_device.GetDetails();
+		if (current_device.SupportsQueue(queue_info)) {
+			physical_device = &current_device;
+			break;
+		}
+	}
+	if (physical_device == nullptr) {
+		std::printf("No physical device with graphics and compute queue support found\n");
+		return 1;
+	}
+
+	// Buffers are passed to the shader by device address
+	vk::PhysicalDeviceFeatures2		   features2{};
+	vk::PhysicalDeviceVulkan12Features vulkan12_features{.timelineSemaphore = vk::True, .bufferDeviceAddress = vk::True};
+	vk::PhysicalDeviceVulkan13Features vulkan13_features{.synchronization2 = vk::True, .dynamicRendering = vk::True};
+	void* feature_chain[] = {&features2, &vulkan12_features, &vulkan13_features};
+	vb::SetupStructureChain(feature_chain);
+
+	vb::Device device(instance, *physical_device,
+					  {.queues	  = {{{.queueFamilyIndex = physical_device->FindQueueFamilyIndex(queue_info),
+									   .queueCount		 = 1}}},
+					   .features2 = &features2});
+
+	vb::Queue const& queue = *device.GetQueue(queue_info);
+
+	std::vector<int> vector_a(kVectorSize);
+	std::vector<int> vector_b(kVectorSize);
+	std::iota(std::begin(vector_a), std::end(vector_a), 0);
+	std::fill(std::begin(vector_b), std::end(vector_b), 1);
+
+	vk::BufferUsageFlags const storage_usage =
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress;
+	vb::StagingBuffer staging_buffer(device, kVectorSize * sizeof(int) * 2);
+	vb::Buffer device_buffer_a(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = storage_usage | vk::BufferUsageFlagBits::eTransferDst},
+		.name		 = "A",
+	});
+	vb::Buffer device_buffer_b(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = storage_usage | vk::BufferUsageFlagBits::eTransferDst},
+		.name		 = "B",
+	});
+	vb::Buffer device_buffer_result(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = storage_usage | vk::BufferUsageFlagBits::eTransferSrc},
+		.name		 = "Result",
+	});
+	vb::Buffer cpu_buffer_result(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = vk::BufferUsageFlagBits::eTransferDst},
+		.memory		 = vb::Memory::eCPU,
+	});
+
+	// Cleared by the raster pass and copied to pixels
+	std::uint32_t constexpr kImageSize = 64;
+	vb::Image color_image(device, {
+		.create_info = {
+			.imageType	 = vk::ImageType::e2D,
+			.format		 = vk::Format::eR8G8B8A8Unorm,
+			.extent		 = {kImageSize, kImageSize, 1},
+			.mipLevels	 = 1,
+			.arrayLayers = 1,
+			.samples	 = vk::SampleCountFlagBits::e1,
+			.usage		 = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+		},
+		.aspect = vk::ImageAspectFlagBits::eColor,
+		.name	= "Color",
+	});
+	vb::Buffer cpu_buffer_pixels(device, {
+		.create_info = {.size = kImageSize * kImageSize * 4, .usage = vk::BufferUsageFlagBits::eTransferDst},
+		.memory		 = vb::Memory::eCPU,
+	});
+
+	struct Constants {
+		vk::DeviceAddress vector_a;
+		vk::DeviceAddress vector_b;
+		vk::DeviceAddress vector_c;
+		int				  vector_size;
+	};
+	vk::PushConstantRange const push_constant_range{
+		.stageFlags = vk::ShaderStageFlagBits::eCompute,
+		.offset		= 0,
+		.size		= sizeof(Constants),
+	};
+	vb::PipelineLayout pipeline_layout(device, {.push_constant_ranges = {&push_constant_range, 1}});
+
+	char compile_options[128];
+	std::snprintf(compile_options, sizeof(compile_options) - 1, "-DWORKGROUP_SIZE=%d", kWorkgroupSize);
+
+#ifdef EMBEDDED_SHADERS
+	vb::Source const source = vb::EmbeddedSource(render_graph_shaders::render_graph);
+#else
+	vb::Source const source = {"render_graph.comp"};
+#endif
+
+	vb::Pipeline pipeline(device, {
+		.stages = {{{
+			.stage			 = vk::ShaderStageFlagBits::eCompute,
+			.source			 = source,
+			.compile_options = compile_options,
+		}}},
+		.layout = pipeline_layout,
+		.name	= "Vector Addition",
+	});
+
+	vb::RenderGraph graph(device);
+	vb::RenderGraph raster_graph(device);
+
+	// dst = lhs + rhs
+	auto add_pass = [&](char const* name, vb::RenderGraphBuffer lhs, vb::RenderGraphBuffer rhs,
+						vb::RenderGraphBuffer dst) {
+		auto constexpr kStage = vk::PipelineStageFlagBits2::eComputeShader;
+		vb::RenderGraphBufferAccess const buffers[] = {
+			{lhs, kStage, vk::AccessFlagBits2::eShaderStorageRead},
+			{rhs, kStage, vk::AccessFlagBits2::eShaderStorageRead},
+			{dst, kStage, vk::AccessFlagBits2::eShaderStorageWrite},
+		};
+		graph.AddPass({
+			.name	 = name,
+			.buffers = buffers,
+			.execute = [&graph, &pipeline, lhs, rhs, dst](vb::Command& cmd) {
+				Constants const constants = {
+					.vector_a	 = graph.GetBuffer(lhs).GetAddress(),
+					.vector_b	 = graph.GetBuffer(rhs).GetAddress(),
+					.vector_c	 = graph.GetBuffer(dst).GetAddress(),
+					.vector_size = kVectorSize,
+				};
+				cmd.BindPipeline(pipeline);
+				cmd.PushConstants(pipeline, &constants, sizeof(Constants));
+				cmd.Dispatch(std::ceil(kVectorSize / static_cast<float>(kWorkgroupSize)), 1, 1);
+			},
+		});
+	};
+
+	vb::Command cmd = device.CreateCommand(queue.GetFamilyIndex());
+	for (int frame = 0; frame < kFrameCount; ++frame) {
+		cmd.Begin();
+		cmd.Copy(device_buffer_a, staging_buffer, vector_a.data(), kVectorSize * sizeof(int));
+		cmd.Copy(device_buffer_b, staging_buffer, vector_b.data(), kVectorSize * sizeof(int));
+
+		// Same graph is declared every frame, it is compiled only once
+		graph.Reset();
+		vb::RenderGraphBufferInfo const transient_info = {
+			.size  = kVectorSize * sizeof(int),
+			.usage = storage_usage,
+		};
+		auto a		 = graph.ImportBuffer(device_buffer_a);
+		auto b		 = graph.ImportBuffer(device_buffer_b);
+		auto output	 = graph.ImportBuffer(device_buffer_result);
+		auto sum	 = graph.CreateBuffer(transient_info);
+		auto other	 = graph.CreateBuffer(transient_info);
+		auto unused	 = graph.CreateBuffer(transient_info);
+		auto doubled = graph.CreateBuffer(transient_info);
+		auto plus	 = graph.CreateBuffer(transient_info);
+		add_pass("Sum", a, b, sum);
+		add_pass("Other", b, b, other);
+		add_pass("Unused", a, a, unused);
+		add_pass("Double", sum, sum, doubled);
+		add_pass("Add", doubled, other, plus);
+		add_pass("Result", plus, plus, output);
+		graph.Execute(cmd);
+
+		raster_graph.Reset();
+		auto color	= raster_graph.ImportImage(color_image);
+		auto pixels = raster_graph.ImportBuffer(cpu_buffer_pixels);
+		vb::RenderGraphImageAccess const clear_images[] = {
+			{color, vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite,
+			 vk::ImageLayout::eColorAttachmentOptimal},
+		};
+		raster_graph.AddPass({
+			.name	 = "Clear",
+			.images	 = clear_images,
+			.execute = [&raster_graph, color](vb::Command& cmd) {
+				vb::RenderingInfo::ColorAttachment const color_attachments[] = {{
+					.color_image = raster_graph.GetImage(color),
+					.clear_value = {{{0.0f, 1.0f, 0.0f, 1.0f}}},
+				}};
+				cmd.BeginRendering({.color_attachments = color_attachments});
+				cmd.EndRendering();
+			},
+		});
+		vb::RenderGraphImageAccess const readback_images[] = {
+			{color, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead,
+			 vk::ImageLayout::eTransferSrcOptimal},
+		};
+		vb::RenderGraphBufferAccess const readback_buffers[] = {
+			{pixels, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite},
+		};
+		raster_graph.AddPass({
+			.name	 = "Readback",
+			.images	 = readback_images,
+			.buffers = readback_buffers,
+			.execute = [&raster_graph, color, pixels](vb::Command& cmd) {
+				cmd.Copy(raster_graph.GetBuffer(pixels), raster_graph.GetImage(color), 0, {}, {kImageSize, kImageSize, 1});
+			},
+		});
+		// One layout transition per pass, BeginRendering and Copy find their accesses synchronized
+		cmd.ResetBarrierStats();
+		raster_graph.Execute(cmd);
+		if (cmd.GetBarrierStats().image_barriers != 2) {
+			std::printf("Raster passes recorded %llu image barriers instead of 2\n",
+						static_cast<unsigned long long>(cmd.GetBarrierStats().image_barriers));
+			return 1;
+		}
+
+		cmd.Copy(cpu_buffer_result, device_buffer_result);
+		cmd.End();
+		cmd.Submit(queue);
+		device.WaitQueue(queue);
+		staging_buffer.Reset();
+	}
+
+	vb::RenderGraphStats const stats = graph.GetStats();
+	std::printf("Passes: %u, culled: %u, barrier batches: %u, compilations: %llu\n", stats.passes,
+				stats.culled_passes, stats.barrier_batches, static_cast<unsigned long long>(stats.compilations));
+	std::printf("Transient buffers: %u in %u allocations, %llu of %llu bytes allocated\n", stats.transient_resources,
+				stats.allocations, static_cast<unsigned long long>(stats.allocated_size),
+				static_cast<unsigned long long>(stats.required_size));
+
+	int const* result = reinterpret_cast<int const*>(cpu_buffer_result.GetMappedData());
+	for (int i = 0; i < kVectorSize; ++i) {
+		int const expected = ((vector_a[i] + vector_b[i]) * 2 + vector_b[i] * 2) * 2;
+		if (result[i] != expected) {
+			std::printf("Result mismatch at %d: %d != %d\n", i, result[i], expected);
+			return 1;
+		}
+	}
+
+	std::uint32_t const* pixels = reinterpret_cast<std::uint32_t const*>(cpu_buffer_pixels.GetMappedData());
+	for (std::uint32_t i = 0; i < kImageSize * kImageSize; ++i) {
+		// Green in R8G8B8A8, little endian
+		if (pixels[i] != 0xFF00FF00u) {
+			std::printf("Pixel mismatch at %u: %08x\n", i, pixels[i]);
+			return 1;
+		}
+	}
+
+	std::printf("Result is:\n");
+	for (int i = 0; i < std::min(kVectorSize, 32); ++i) {
+		std::printf("%d ", result[i]);
+	}
+	std::printf("\nSuccess!\n");
+}
@@ -0,0 +1,196 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_BUILD_CPP_MODULE
+#include <vulkan_backend/core.hpp>
+#else
+import vulkan_backend;
+#endif
+
+// SPIR-V compiled at build time by vb_embed_shaders(), otherwise shader is compiled at runtime
+#if __has_include("shader_object_shaders.hpp")
+#include "shader_object_shaders.hpp"
+#define EMBEDDED_SHADERS
+#endif
+
+// Vector addition like in vector_addition example, but with VK_EXT_shader_object instead of a pipeline.
+// Compute only, so it runs headless on any implementation of the extension (including lavapipe)
+
+vb::QueueInfo constexpr queue_info = {.flags = vk::QueueFlagBits::eCompute};
+
+char constexpr const* kExtensions[] = {vk::EXTShaderObjectExtensionName};
+
+int main() {
+	int constexpr kVectorSize	 = 64 * 1024;
+	int constexpr kWorkgroupSize = 16;
+	int constexpr kBindingBuffer = 0;
+	int constexpr kNumGpuBuffers = 3;
+
+	vb::SetLogLevel(vb::LogLevel::Trace);
+
+	vb::Instance instance({.optional_layers = {{vb::kValidationLayerName}}});
+
+	// Select physical device with compute queue and shader object extension
+	std::vector<vb::PhysicalDevice> physical_devices;
+	physical_devices.reserve(instance.GetPhysicalDevices().size());
+	vb::PhysicalDevice* physical_device = nullptr;
+	for (auto& vk_device : instance.GetPhysicalDevices()) {
+		auto& current_device = physical_devices.emplace_back(vk_device);
+		current_device.GetDetails();
+		if (current_device.SupportsQueue(queue_info) && current_device.SupportsExtensions(kExtensions)) {
+			physical_device = &current_device;
+			break;
+		}
+	}
+	if (physical_device == nullptr) {
+		std::printf("No physical device with %s support found\n", vk::EXTShaderObjectExtensionName);
+		return 1;
+	}
+
+	vk::PhysicalDeviceFeatures2				  features2{};
+	vk::PhysicalDeviceVulkan12Features		  vulkan12_features{.runtimeDescriptorArray = vk::True,
+															  .timelineSemaphore = vk::True};
+	vk::PhysicalDeviceVulkan13Features		  vulkan13_features{.synchronization2 = vk::True};
+	vk::PhysicalDeviceShaderObjectFeaturesEXT shader_object_features{.shaderObject = vk::True};
+	void* feature_chain[] = {&features2, &vulkan12_features, &vulkan13_features, &shader_object_features};
+	vb::SetupStructureChain(feature_chain);
+
+	vb::Device device(instance, *physical_device,
+					  {.queues	   = {{{.queueFamilyIndex = physical_device->FindQueueFamilyIndex(queue_info),
+										.queueCount		  = 1}}},
+					   .extensions = kExtensions,
+					   .features2  = &features2});
+	if (!device.IsShaderObjectEnabled()) {
+		std::printf("Shader objects are not enabled on device\n");
+		return 1;
+	}
+
+	vb::StagingBuffer	   staging_buffer(device, kVectorSize * sizeof(int) * 2);
+	vb::BindlessDescriptor bindless_descriptor(
+		device, {.bindings = {{{.binding		 = kBindingBuffer,
+								.descriptorType	 = vk::DescriptorType::eStorageBuffer,
+								.descriptorCount = kNumGpuBuffers,
+								.stageFlags		 = vk::ShaderStageFlagBits::eCompute}}}});
+
+	vk::PushConstantRange const push_constant_range{
+		.stageFlags = vk::ShaderStageFlagBits::eAll,
+		.offset		= 0,
+		.size		= physical_device->GetMaxPushConstantsSize(),
+	};
+	vk::DescriptorSetLayout const set_layout = bindless_descriptor.GetLayout();
+
+	// Shader objects have no pipeline, but binding descriptors and push constants still needs a compatible layout
+	vb::PipelineLayout pipeline_layout(device, {
+		.descriptor_set_layouts = {&set_layout, 1},
+		.push_constant_ranges	= {&push_constant_range, 1},
+	});
+
+	vb::Queue const& queue = *device.GetQueue(queue_info);
+
+	std::vector<int> vector_a(kVectorSize);
+	std::vector<int> vector_b(kVectorSize);
+	std::iota(std::begin(vector_a), std::end(vector_a), 0);
+	std::fill(std::begin(vector_b), std::end(vector_b), 1);
+
+	vb::BindlessBufferInfo bindless_buffer_info = {
+		.buffer_info{
+			.create_info{
+				.size  = kVectorSize * sizeof(int),
+				.usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+			},
+			.memory = vb::Memory::eGPU,
+		},
+		.binding = kBindingBuffer,
+	};
+	vb::BindlessBuffer device_buffer_a(device, bindless_descriptor, bindless_buffer_info);
+	vb::BindlessBuffer device_buffer_b(device, bindless_descriptor, bindless_buffer_info);
+	bindless_buffer_info.buffer_info.create_info.usage =
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc;
+	vb::BindlessBuffer device_buffer_result(device, bindless_descriptor, bindless_buffer_info);
+
+	vb::Buffer cpu_buffer_result(device, {
+		.create_info = {.size = kVectorSize * sizeof(int), .usage = vk::BufferUsageFlagBits::eTransferDst},
+		.memory		 = vb::Memory::eCPU,
+	});
+
+	char compile_options[128];
+	std::snprintf(compile_options, sizeof(compile_options) - 1, "-DWORKGROUP_SIZE=%d -DBINDING_BUFFER=%d",
+				  kWorkgroupSize, kBindingBuffer);
+
+#ifdef EMBEDDED_SHADERS
+	vb::Source const source = vb::EmbeddedSource(shader_object_shaders::shader_object);
+#else
+	vb::Source const source = {"shader_object.comp"};
+#endif
+
+	// Compile compute stage to a shader object
+	vb::ShaderObject shader(device, {
+		.stage = {
+			.stage			 = vk::ShaderStageFlagBits::eCompute,
+			.source			 = source,
+			.compile_options = compile_options,
+		},
+		.descriptor_set_layouts = {&set_layout, 1},
+		.push_constant_ranges	= {&push_constant_range, 1},
+		.name					= "Vector Addition",
+	});
+
+	struct Constants {
+		std::uint32_t vector_a_rid;
+		std::uint32_t vector_b_rid;
+		std::uint32_t vector_result_rid;
+		int			  vector_size;
+	};
+	Constants constants = {
+		.vector_a_rid	   = device_buffer_a.GetResourceID(),
+		.vector_b_rid	   = device_buffer_b.GetResourceID(),
+		.vector_result_rid = device_buffer_result.GetResourceID(),
+		.vector_size	   = kVectorSize,
+	};
+
+	vb::Command cmd = device.CreateCommand(queue.GetFamilyIndex());
+	cmd.Begin();
+
+	// Bind shader object instead of pipeline
+	cmd.BindShader(shader);
+	cmd.BindDescriptorSet(vk::PipelineBindPoint::eCompute, pipeline_layout, bindless_descriptor.GetSet());
+	cmd.PushConstants(pipeline_layout, &constants, sizeof(Constants));
+
+	cmd.Copy(device_buffer_a, staging_buffer, vector_a.data(), kVectorSize * sizeof(int));
+	cmd.Copy(device_buffer_b, staging_buffer, vector_b.data(), kVectorSize * sizeof(int));
+
+	// Barriers are inferred from declared accesses: copies to a and b are made visible to the shader
+	vb::BufferAccess const accesses[] = {
+		{device_buffer_a, vk::AccessFlagBits2::eShaderStorageRead},
+		{device_buffer_b, vk::AccessFlagBits2::eShaderStorageRead},
+		{device_buffer_result, vk::AccessFlagBits2::eShaderStorageWrite},
+	};
+	cmd.Dispatch(std::ceil(kVectorSize / static_cast<float>(kWorkgroupSize)), 1, 1, accesses);
+
+	cmd.Access(device_buffer_result, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+	cmd.Copy(cpu_buffer_result, device_buffer_result, kVectorSize * sizeof(int));
+
+	cmd.End();
+	cmd.Submit(queue);
+	device.WaitQueue(queue);
+
+	int const* result = reinterpret_cast<int const*>(cpu_buffer_result.GetMappedData());
+	std::transform(vector_a.begin(), vector_a.end(), vector_b.begin(), vector_a.begin(), std::plus<int>());
+	if (!std::equal(vector_a.begin(), vector_a.end(), result)) {
+		std::printf("Result mismatch!\n");
+		return 1;
+	}
+
+	std::printf("Result is:\n");
+	for (int i = 0; i < std::min(kVectorSize, 32); ++i) {
+		std::printf("%d ", result[i]);
+	}
+	std::printf("\nSuccess!\n");
+}
@@ -17,6 +17,12 @@ import std;
 import vulkan_backend;
 #endif
 
+// SPIR-V compiled at build time by vb_embed_shaders(), otherwise shader is compiled at runtime
+#if __has_include("vector_addition_shaders.hpp")
+#include "vector_addition_shaders.hpp"
+#define EMBEDDED_SHADERS
+#endif
+
 // Define queue info to select a compute queue
 vb::QueueInfo constexpr queue_info = {.flags = vk::QueueFlagBits::eCompute};
 
@@ -60,7 +66,8 @@ int main(){
 
 	// Create device with 1 compute queue and synchronization2
 	vk::PhysicalDeviceFeatures2 features2{};
-	vk::PhysicalDeviceVulkan12Features vulkan12_features{.runtimeDescriptorArray = vk::True}; // bindless descriptors
+	vk::PhysicalDeviceVulkan12Features vulkan12_features{.runtimeDescriptorArray = vk::True, // bindless descriptors
+													   .timelineSemaphore = vk::True}; // submission tracking
 	vk::PhysicalDeviceVulkan13Features vulkan13_features{.synchronization2 = vk::True}; // cmd.Barrier()
 	void* feature_chain[] = {&features2, &vulkan12_features, &vulkan13_features};
 	vb::SetupStructureChain(feature_chain);
@@ -131,11 +138,17 @@ int main(){
 		"-DWORKGROUP_SIZE=%d -DBINDING_BUFFER=%d", 
 		kWorkgroupSize, kBindingBuffer);
 
+#ifdef EMBEDDED_SHADERS
+	vb::Source const source = vb::EmbeddedSource(vector_addition_shaders::vector_addition);
+#else
+	vb::Source const source = {"vector_addition.comp"};
+#endif
+
 	// Create compute pipeline
 	vb::Pipeline pipeline(device, {
 		.stages = {{{
 			.stage = vk::ShaderStageFlagBits::eCompute, 
-			.source = {"vector_addition.comp"},
+			.source = source,
 			.compile_options = compile_options
 		}}},
 		.layout = bindless_pipeline_layout,
@@ -24,6 +24,39 @@ vk::MemoryPropertyFlags constexpr inline eCPU =
 	vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
 } // namespace Memory
 
+// Access flags that write memory
+vk::AccessFlags2 constexpr inline kWriteAccess =
+	vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eShaderStorageWrite |
+	vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+	vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite | vk::AccessFlagBits2::eMemoryWrite;
+
+// Accesses of a resource recorded by Command, used to infer barriers
+struct AccessState {
+	// Stages and accesses of last write, access is empty if already made available
+	vk::PipelineStageFlags2 write_stages = {};
+	vk::AccessFlags2        write_access = {};
+	// Stages that have read the resource or have visibility of the last write since it
+	vk::PipelineStageFlags2 read_stages = {};
+	vk::AccessFlags2        read_access = {};
+	// Destination scope of the last barrier and accesses declared since, accesses inside it need
+	// no other barrier until the next action command of the same recording
+	vk::PipelineStageFlags2 pending_stages = {};
+	vk::AccessFlags2        pending_access = {};
+	// Recording and action of Command the scope belongs to
+	u64                     pending_recording = 0;
+	u32                     pending_action    = 0;
+
+	bool operator==(AccessState const&) const = default;
+};
+
+// Layout and accesses of one mip level of one array layer
+struct SubresourceState {
+	vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+	AccessState     access;
+
+	bool operator==(SubresourceState const&) const = default;
+};
+
 struct Viewport {
 	float x;
 	float y;
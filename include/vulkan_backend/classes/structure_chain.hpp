@@ -35,6 +35,8 @@ constexpr void EnableRequiredFeatures(vk::PhysicalDeviceVulkan12Features& featur
 	features.descriptorBindingPartiallyBound			   = true;
 	features.runtimeDescriptorArray						   = true;
 	features.bufferDeviceAddress						   = true;
+	// Submit tickets are timeline semaphore values
+	features.timelineSemaphore							   = true;
 }
 
 constexpr void EnableRequiredFeatures(vk::PhysicalDeviceVulkan13Features& features) {
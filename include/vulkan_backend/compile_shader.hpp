@@ -1,13 +1,18 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <span>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 #elif defined(VB_DEV)
 import std;
 #endif
 
 #include "vulkan_backend/config.hpp"
 #include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/types.hpp"
 
 VB_EXPORT
 namespace VB_NAMESPACE {
@@ -18,18 +23,89 @@ namespace VB_NAMESPACE {
  */
 auto ReadBinaryFile(std::string_view const& path) -> std::vector<char>;
 
+struct ShaderCompileResult {
+	vk::Result        result = vk::Result::eSuccess;
+	// SPIR-V code, empty on failure
+	std::vector<char> spirv;
+	// Compiler errors and warnings
+	std::string       diagnostics;
+};
+
 /**
- * @brief Compiles a shader stage using the shader compiler provided by the stage.
+ * @brief Compiles a shader stage by running the shader compiler provided by the stage.
  * @param[in] stage The shader stage to compile.
  * @param[out] out_file The path to the output file.
+ * @param[out] diagnostics If not null, receives compiler output.
+ * @return vk::Result::eSuccess if the compiler succeeded.
+ */
+auto CompileShader(PipelineStage const& stage, char const* out_file, std::string* diagnostics = nullptr) -> vk::Result;
+
+/**
+ * @brief Compiles a shader stage to SPIR-V in memory.
+ * GLSL with 'glslc' compiler is compiled in-process if shaderc shared library can be loaded
+ * and compile options are supported (-D, -I, -O, -O0, -Os, -g, --target-env, --target-spv).
+ * Otherwise the compiler process is run.
+ * @param[in] stage The shader stage to compile.
+ * @return Result, SPIR-V code and compiler diagnostics.
  */
-void CompileShader(PipelineStage const& stage, char const* out_file);
+auto CompileShader(PipelineStage const& stage) -> ShaderCompileResult;
 
 /**
- * @brief Loads a shader stage from a file, compile if needed.
- * Use this function in most cases.
+ * @brief Computes the key of a shader stage in the SPIR-V cache.
+ * Hashes source code, contents of files it includes (resolved recursively, also with -I options),
+ * compiler, entry point, stage and compile options.
+ * @param[in] stage The shader stage.
+ * @return 64-bit FNV-1a hash.
+ */
+auto GetShaderCacheKey(PipelineStage const& stage) -> u64;
+
+/**
+ * @brief Finds files a shader stage is built from: source file and files it includes, resolved recursively.
+ * Only included files are returned for raw sources.
+ * @param[in] stage The shader stage.
+ * @return Paths of the files.
+ */
+auto GetShaderDependencies(PipelineStage const& stage) -> std::vector<std::string>;
+
+/**
+ * @brief Loads a shader stage from a file or raw source, compile if needed.
+ * Compiled SPIR-V is stored in stage.out_path and listed in its shader_cache.index file by cache key.
+ * With PipelineStage::Flags::kAllowSkipCompilation the cached SPIR-V is used if the key matches.
+ * Raw GLSL is compiled in memory when shaderc is available. Raw SPIR-V is copied.
  * @param[in] stage The shader stage to load.
- * @return A vector of characters containing the loaded shader.
+ * @return A vector of characters containing the loaded shader, empty if compilation failed.
  */
 auto LoadShader(PipelineStage const& stage) -> std::vector<char>;
+
+// SPIR-V code of a shader stage.
+// Views source data of Source::Type::RawSpirV stage, which must outlive it, owns the code otherwise
+class ShaderCode {
+public:
+	ShaderCode() = default;
+	explicit ShaderCode(std::vector<char>&& bytes) : storage(std::move(bytes)), code(storage) {}
+	explicit ShaderCode(std::span<char const> view) : code(view) {}
+
+	// Moving the vector keeps its buffer, so the view stays valid
+	ShaderCode(ShaderCode&&)                    = default;
+	auto operator=(ShaderCode&&) -> ShaderCode& = default;
+	ShaderCode(ShaderCode const&)               = delete;
+	auto operator=(ShaderCode const&) -> ShaderCode& = delete;
+
+	auto GetCode() const -> std::span<char const> { return code; }
+	auto GetData() const -> u32 const* { return reinterpret_cast<u32 const*>(code.data()); }
+	auto GetSize() const -> std::size_t { return code.size(); }
+	auto IsEmpty() const -> bool { return code.empty(); }
+
+private:
+	std::vector<char>     storage;
+	std::span<char const> code;
+};
+
+/**
+ * @brief Same as LoadShader, but Source::Type::RawSpirV data is passed through without copy
+ * if it is aligned to 4 bytes.
+ * @param[in] stage The shader stage to load.
+ * @return SPIR-V code, empty if compilation failed.
+ */
+auto LoadShaderCode(PipelineStage const& stage) -> ShaderCode;
 } // namespace VB_NAMESPACE
@@ -15,6 +15,9 @@
 // Use variable length arrays (VLA) to avoid small temporary heap allocations
 // #define VB_USE_VLA
 
+// Do not load shaderc shared library for in-process shader compilation
+// #define VB_NO_SHADERC
+
 // Do not define VMA_IMPLEMENTATION macro
 // #define VB_VMA_IMPLEMENTATION 0
 
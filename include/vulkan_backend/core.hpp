@@ -2,15 +2,20 @@
 
 #include "classes/structs.hpp"
 #include "config.hpp"
+#include "embedded_shader.hpp"
 #include "util/structure_chain.hpp"
 #include "fwd.hpp"
 #include "interface/buffer/buffer.hpp"
 #include "interface/buffer/info.hpp"
 #include "interface/command/command.hpp"
+#include "interface/command/command_allocator.hpp"
+#include "interface/compute_pipeline_cache/compute_pipeline_cache.hpp"
+#include "interface/compute_pipeline_cache/info.hpp"
 #include "interface/descriptor/descriptor.hpp"
 #include "interface/descriptor/info.hpp"
 #include "interface/device/device.hpp"
 #include "interface/device/info.hpp"
+#include "interface/device/structs.hpp"
 #include "interface/image/image.hpp"
 #include "interface/image/info.hpp"
 #include "interface/instance/instance.hpp"
@@ -19,8 +24,18 @@
 #include "interface/physical_device/info.hpp"
 #include "interface/pipeline/pipeline.hpp"
 #include "interface/pipeline/info.hpp"
+#include "interface/pipeline_library/pipeline_library.hpp"
+#include "interface/pipeline_library/info.hpp"
 #include "interface/queue/queue.hpp"
 #include "interface/queue/info.hpp"
+#include "interface/queue/submit_batch.hpp"
+#include "interface/queue/queue_submitter.hpp"
+#include "interface/render_graph/render_graph.hpp"
+#include "interface/render_graph/info.hpp"
+#include "interface/shader_module_cache/shader_module_cache.hpp"
+#include "interface/shader_object/shader_object.hpp"
+#include "interface/shader_object/info.hpp"
+#include "interface/shader_watcher/shader_watcher.hpp"
 #include "interface/swapchain/swapchain.hpp"
 #include "interface/swapchain/info.hpp"
 #include "log.hpp"
@@ -28,5 +43,6 @@
 #include "vulkan_backend/vulkan_functions.hpp"
 #include "vulkan_backend/util/enumerate.hpp"
 #include "vulkan_backend/util/specialization_map.hpp"
+#include "vulkan_backend/util/thread_pool.hpp"
 
 #include "constants/constants.hpp"
@@ -45,5 +45,14 @@ vk::ImageCreateInfo inline image2D = {
 	.usage                 = vk::ImageUsageFlagBits::eSampled,
 };
 
+// All mip levels and array layers, empty aspect == aspect of image
+vk::ImageSubresourceRange constexpr inline kAllSubresources = {
+	.aspectMask     = {},
+	.baseMipLevel   = 0,
+	.levelCount     = vk::RemainingMipLevels,
+	.baseArrayLayer = 0,
+	.layerCount     = vk::RemainingArrayLayers,
+};
+
 } // namespace defaults
 } // namespace VB_NAMESPACE
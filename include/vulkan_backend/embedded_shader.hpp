@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <span>
+#include <string_view>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// SPIR-V compiled at build time, see vb_embed_shaders() in cmake/vb_embed_shaders.cmake
+struct EmbeddedShader {
+	std::string_view     name;
+	std::span<u32 const> code;
+};
+
+// Find shader by name in registry generated by vb_embed_shaders(). Empty code if not found
+constexpr auto FindEmbeddedShader(std::span<EmbeddedShader const> registry, std::string_view name) -> EmbeddedShader {
+	for (auto const& shader : registry) {
+		if (shader.name == name) {
+			return shader;
+		}
+	}
+	return {};
+}
+
+// Stage source referring to embedded SPIR-V, shader module is created from it without copies or file I/O
+inline auto EmbeddedSource(std::span<u32 const> code) -> Source {
+	return {.data = {reinterpret_cast<char const*>(code.data()), code.size_bytes()}, .type = Source::Type::RawSpirV};
+}
+
+inline auto EmbeddedSource(EmbeddedShader const& shader) -> Source { return EmbeddedSource(shader.code); }
+} // namespace VB_NAMESPACE
@@ -18,6 +18,16 @@ class Pipeline;
 class Command;
 class Queue;
 class PipelineLibrary;
+class ShaderWatcher;
+class ComputePipelineCache;
+class ShaderModuleCache;
+class PipelineLayout;
+class PipelineManifestRecorder;
+class ShaderObject;
+class RenderGraph;
+class SubmitBatch;
+class QueueSubmitter;
+class CommandAllocator;
 
 struct BufferInfo;
 struct ImageInfo;
@@ -29,5 +39,9 @@ struct RenderingInfo;
 struct BlitInfo;
 struct QueueInfo;
 struct InstanceInfo;
+struct PipelineFeedback;
+struct CachedShaderModule;
+struct ShaderObjectInfo;
+struct RenderGraphPassInfo;
 
 } // namespace VB_NAMESPACE
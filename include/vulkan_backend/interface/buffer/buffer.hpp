@@ -20,6 +20,7 @@ import vk_mem_alloc;
 
 #include "vulkan_backend/classes/base.hpp"
 #include "vulkan_backend/classes/gpu_resource.hpp"
+#include "vulkan_backend/classes/structs.hpp"
 #include "vulkan_backend/fwd.hpp"
 #include "vulkan_backend/interface/buffer/info.hpp"
 #include "vulkan_backend/types.hpp"
@@ -75,6 +76,7 @@ class Buffer : public vk::Buffer, public Named, public ResourceBase<Device> {
   private:
 	friend Command;
 	friend Device;
+	friend RenderGraph;
 
 	void AddUsageFlags(vk::BufferUsageFlags& usage, u64& size);
 
@@ -85,6 +87,9 @@ class Buffer : public vk::Buffer, public Named, public ResourceBase<Device> {
 	vk::DeviceSize          size;
 	vk::BufferUsageFlags    usage;
 	vk::MemoryPropertyFlags memory;
+
+	// State on GPU timeline, updated by Command when recording, not by this object
+	mutable AccessState access_state;
 };
 
 class StagingBuffer : public Buffer {
@@ -12,6 +12,12 @@ import std;
 import vulkan_hpp;
 #endif
 
+#ifndef VB_USE_VMA_MODULE
+#include <vk_mem_alloc.h>
+#else
+import vk_mem_alloc;
+#endif
+
 #include "vulkan_backend/classes/structs.hpp"
 #include "vulkan_backend/interface/descriptor/descriptor.hpp"
 #include "vulkan_backend/types.hpp"
@@ -24,6 +30,9 @@ struct BufferInfo {
 	vk::MemoryPropertyFlags memory           = Memory::eGPU;
 	std::string_view        name             = "";
 	bool                    check_vk_results = true;
+	// Bind to this memory at alias_offset instead of allocating, memory is not owned by the buffer
+	VmaAllocation           alias_allocation = nullptr;
+	vk::DeviceSize          alias_offset     = 0;
 };
 
 struct BindlessBufferInfo {
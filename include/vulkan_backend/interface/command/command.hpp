@@ -1,6 +1,9 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <span>
 #elif defined(VB_DEV)
 import std;
@@ -16,6 +19,7 @@ import vulkan_hpp;
 #include "vulkan_backend/fwd.hpp"
 #include "vulkan_backend/interface/image/image.hpp"
 #include "vulkan_backend/interface/buffer/buffer.hpp"
+#include "vulkan_backend/interface/queue/info.hpp"
 
 #ifdef MemoryBarrier
 #undef MemoryBarrier
@@ -40,6 +44,11 @@ public:
 	// Create with result returned
 	[[nodiscard]] vk::Result CreateWithResult(Device& device, u32 queue_family_index);
 	
+	// Buffer allocated from a pool of allocator, which resets and frees it.
+	// Public to be constructed in place by CommandAllocator, use CommandAllocator::AllocatePrimary() instead
+	Command(Device& device, u32 queue_family_index, vk::CommandBuffer command_buffer, vk::CommandBufferLevel level,
+			CommandAllocator& allocator);
+
 	// Move constructor
 	Command(Command&& other);
 
@@ -51,49 +60,200 @@ public:
 
 	bool Copy(Image      const& dst, StagingBuffer& staging, const void* data, u32 size);
 	bool Copy(vk::Buffer const& dst, StagingBuffer& staging, const void* data, u32 size, u32 dst_offset = 0);
+	bool Copy(Buffer     const& dst, StagingBuffer& staging, const void* data, u32 size, u32 dst_offset = 0);
 	void Copy(vk::Buffer const& dst, vk::Buffer const& src,  u32 size, u32 dst_offset = 0, u32 src_offset = 0);
 	void Copy(vb::Buffer const& dst, vb::Buffer const& src);
-	void Copy(Image      const& dst, vk::Buffer const& src,  u32 src_offset = 0);
-	void Copy(vk::Buffer const& dst, Image      const& src,  u32 dst_offset, vk::Offset3D image_offset, Extent3D image_extent);
+	// Image copies use extent of the mip level of subresource
+	void Copy(Image      const& dst, vk::Buffer const& src,  u32 src_offset = 0,
+			  vk::ImageSubresourceLayers const& subresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1});
+	void Copy(vk::Buffer const& dst, Image      const& src,  u32 dst_offset, vk::Offset3D image_offset, Extent3D image_extent,
+			  vk::ImageSubresourceLayers const& subresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1});
 
+	// Barriers are batched and recorded with one vkCmdPipelineBarrier2 before the next command
+	// of this class that needs them. Call FlushBarriers() before recording with vk::CommandBuffer directly
 	void Barrier(Image& img,  ImageBarrier const& barrier = {});
 	void Barrier(vk::Buffer const& buf, BufferBarrier const& barrier = {});
 	void Barrier(MemoryBarrier const& barrier = {});
+	void FlushBarriers();
+
+	// Declare access of the next command to a resource. A barrier is added to the batch only
+	// if the access depends on earlier ones: read after read needs none, write after read only
+	// an execution dependency. Image is transitioned if layout is not eUndefined.
+	// Copy, Blit, ClearColorImage and BeginRendering declare accesses of vb::Buffer and Image themselves.
+	// Accesses of draws are declared before BeginRendering(), barriers can not be recorded inside rendering scope
+	void Access(Buffer const& buffer, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access);
+	void Access(Image& image, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access,
+				vk::ImageLayout layout = vk::ImageLayout::eUndefined,
+				vk::ImageSubresourceRange const& range = defaults::kAllSubresources);
 
 	void Blit(BlitInfo const& info);
-	void ClearColorImage(Image const& image, vk::ClearColorValue const& color);
+	// Fill mip levels 1.. of each layer from level 0 with blits.
+	// Level 0 is expected in transfer src or general layout, all levels end in eTransferSrcOptimal
+	void GenerateMipmaps(Image& image, vk::Filter filter = vk::Filter::eLinear);
+	// Subresources are cleared in their current layouts, one clear per run of subresources in the same layout
+	void ClearColorImage(Image const& image, vk::ClearColorValue const& color,
+						 vk::ImageSubresourceRange const& range = defaults::kAllSubresources);
 
-	void BeginRendering(RenderingInfo const& info);
+	// Pass eContentsSecondaryCommandBuffers to record the rendering in secondary command buffers
+	void BeginRendering(RenderingInfo const& info, vk::RenderingFlags flags = {});
 	void SetViewport(Viewport const& viewport);
 	void SetScissor(vk::Rect2D const& scissor);
 	void EndRendering();
+	// Rendering scope recorded on workers of the device thread pool. [0, count) is split into one range
+	// per worker, record(cmd, begin, end) records its range into a secondary buffer from allocator that
+	// inherits attachment formats of info. Buffers are executed in range order, then rendering ends.
+	// Bound state is not inherited, set pipeline, viewport and scissor in each secondary buffer.
+	// record runs concurrently, so it must only bind and draw: resource accesses and barriers are
+	// declared on this buffer before the call. This buffer must come from allocator, whose NextFrame()
+	// waits for its ticket before resetting the secondaries. Must not be called from a task of the device thread pool
+	void RenderParallel(RenderingInfo const& info, CommandAllocator& allocator, std::size_t count,
+						std::function<void(Command& cmd, std::size_t begin, std::size_t end)> const& record);
 	void BindPipelineAndDescriptorSet(Pipeline const& pipeline, vk::DescriptorSet const& descriptor_set);
 	void BindPipeline(Pipeline const& pipeline);
 	void PushConstants(Pipeline const& pipeline, const void* data, u32 size);
 
+	// VK_EXT_shader_object. If a graphics shader is bound, graphics stages not in shaders are unbound.
+	// All state that pipelines bake in is dynamic, set it with SetGraphicsState() before drawing
+	void BindShaders(std::span<ShaderObject const* const> shaders);
+	void BindShader(ShaderObject const& shader);
+	// Set dynamic state from pipeline description for drawing with shader objects.
+	// Stages, layout and attachment formats are ignored
+	void SetGraphicsState(GraphicsPipelineInfo const& info);
+	void BindDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout, vk::DescriptorSet const& descriptor_set);
+	void PushConstants(vk::PipelineLayout layout, const void* data, u32 size);
+
 	void BindVertexBuffer(Buffer const& vertexBuffer);
 	void BindIndexBuffer(Buffer const& indexBuffer);
 
+	// Bind and set calls above are dropped if the same state is already bound.
+	// Bound state is tracked from Begin(), call InvalidateState() after
+	// binding or setting state with vk::CommandBuffer methods directly
+	void InvalidateState();
+	auto GetStateStats() const -> CommandStateStats const& { return state_stats; }
+	void ResetStateStats() { state_stats = {}; }
+	auto GetBarrierStats() const -> CommandBarrierStats const& { return barrier_stats; }
+	void ResetBarrierStats() { barrier_stats = {}; }
+
 	void Draw(u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance);
 	void DrawIndexed(u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance);
 	void DrawMesh(Buffer const& vertex_buffer, Buffer const& index_buffer, u32 index_count);
 
 	void Dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ);
+	// Dispatch with barriers for declared accesses of compute shader
+	void Dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ, std::span<BufferAccess const> buffers,
+				  std::span<ImageAccess const> images = {});
 
+	// Waits only for the previous submission of this command buffer
 	void Begin();
+	// Begin secondary command buffer from CommandAllocator
+	void Begin(vk::CommandBufferInheritanceInfo const& inheritance);
 	void End();
-	void Submit(vk::Queue const& queue, SubmitInfo const& info = {});
-	auto GetFence() const  -> vk::Fence;
+	auto Submit(Queue const& queue, SubmitInfo const& info = {}) -> SubmitTicket;
+	// Ticket of the last submission, empty if never submitted
+	auto GetTicket() const -> SubmitTicket { return ticket; }
+	// Non-blocking poll of the last submission
+	auto IsComplete() const -> bool;
+	// Block until the last submission is complete
+	void Wait() const;
 
 	auto GetDevice() const -> Device& { return *GetOwner(); }
 	auto GetResourceTypeName() const-> char const* override;
 private:
 	friend Swapchain;
 	friend Device;
+	friend SubmitBatch;
+	friend QueueSubmitter;
+	friend CommandAllocator;
+	friend RenderGraph;
 	void Free() override;
+	// Reset tracked state for a new recording
+	void ResetState();
+
+	// Last state bound with this command since Begin()
+	struct BoundState {
+		// Push constants larger than this are not compared
+		static constexpr u32 kMaxPushConstantsSize = 256;
+
+		// Indexed by GetBindPointIndex()
+		vk::Pipeline       pipelines[2]          = {};
+		vk::PipelineLayout descriptor_layouts[2]       = {};
+		vk::DescriptorSet  descriptor_sets[2]          = {};
+		u64                descriptor_compatibility[2] = {}; // Device::GetPipelineLayoutCompatibility()
+
+		vk::PipelineLayout                           push_constants_layout = nullptr;
+		u32                                          push_constants_size   = 0;
+		std::array<std::byte, kMaxPushConstantsSize> push_constants;
+
+		bool         has_viewport = false;
+		bool         has_scissor  = false;
+		vk::Viewport viewport;
+		vk::Rect2D   scissor;
+
+		vk::Buffer vertex_buffer = nullptr;
+		vk::Buffer index_buffer  = nullptr;
+	};
+
+	// Barriers waiting for FlushBarriers(), flushed early when an array is full
+	struct PendingBarriers {
+		static constexpr u32 kMaxMemoryBarriers = 4;
+		static constexpr u32 kMaxBarriers       = 16;
+
+		std::array<vk::MemoryBarrier2, kMaxMemoryBarriers> memory;
+		std::array<vk::BufferMemoryBarrier2, kMaxBarriers> buffers;
+		std::array<vk::ImageMemoryBarrier2, kMaxBarriers>  images;
+		u32 memory_count = 0;
+		u32 buffer_count = 0;
+		u32 image_count  = 0;
+	};
+
+	// Append to pending barriers
+	void AddBarrier(vk::ImageMemoryBarrier2 const& barrier);
+	void AddBarrier(vk::BufferMemoryBarrier2 const& barrier);
+	// Record pending barriers without ending pending scopes, unlike FlushBarriers() it is not an action command
+	void RecordBarriers();
+	auto HasPendingBarriers() const -> bool;
+	// Pending scope of the resource declared in this recording covers the next action command,
+	// although other action commands may have passed since the access was declared
+	void ContinuePendingScope(Buffer const& buffer);
+	void ContinuePendingScope(Image const& image);
+
+	// Access of subresources, transitioned to new_layout unless it is eUndefined
+	void AccessImage(Image const& image, vk::ImageSubresourceRange const& range, vk::PipelineStageFlags2 stages,
+					 vk::AccessFlags2 access, vk::ImageLayout new_layout = vk::ImageLayout::eUndefined);
+	// Call update(run, state) -> SubresourceState for runs of subresources in range with the same state
+	// and store the returned state for them. Splits and merges per-subresource state as needed
+	template <typename Update>
+	static void UpdateImageState(Image const& image, vk::ImageSubresourceRange const& range, Update&& update);
+
+	// Returns false if bind is redundant
+	bool TrackPipeline(vk::PipelineBindPoint point, vk::Pipeline pipeline);
+	// Set is not rebound if it was bound with a layout compatible for set 0, compatibility == 0 is looked up
+	bool TrackDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout, u64 compatibility,
+							vk::DescriptorSet set);
+	void BindDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout, u64 compatibility,
+						   vk::DescriptorSet const& descriptor_set);
+	bool TrackPushConstants(vk::PipelineLayout layout, void const* data, u32 size);
+
+	// Null if the buffer is owned by CommandAllocator
+	vk::CommandPool        pool              = nullptr;
+	u32                    queue_family      = ~0u;
+	vk::CommandBufferLevel level             = vk::CommandBufferLevel::ePrimary;
+	// Set if the buffer is from CommandAllocator
+	CommandAllocator*      command_allocator = nullptr;
+	SubmitTicket           ticket            = {};
+	// Viewport and scissor counts are dynamic with shader objects
+	bool shader_objects_bound = false;
+	// Between BeginRendering() and EndRendering(), barriers can not be recorded
+	bool in_rendering         = false;
+
+	// Identify the action command accesses are declared for, see AccessState::pending_recording
+	u64 recording_id = 0;
+	u32 action_index = 0;
 
-	vk::CommandPool pool  = nullptr;
-	vk::Fence		fence = nullptr;
+	BoundState          bound_state;
+	CommandStateStats   state_stats;
+	CommandBarrierStats barrier_stats;
+	PendingBarriers     pending_barriers;
 };
 } // namespace VB_NAMESPACE
 
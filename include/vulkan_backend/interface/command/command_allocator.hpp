@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+struct CommandAllocatorInfo {
+	u32                        frames_in_flight = 2;
+	// Buffers live for one frame, so pools are transient by default
+	vk::CommandPoolCreateFlags pool_flags       = vk::CommandPoolCreateFlagBits::eTransient;
+};
+
+struct CommandAllocatorStats {
+	u32 pools             = 0;
+	// Buffers allocated from the driver, they are reused in later frames
+	u32 primary_buffers   = 0;
+	u32 secondary_buffers = 0;
+	u64 pool_resets       = 0;
+};
+
+// Command buffers from one pool per (thread, queue family, frame in flight).
+// Buffers are handed out from the pool of the calling thread without locking and stay valid until
+// their frame is recycled by NextFrame(), which resets each used pool of that frame with one
+// resetCommandPool. Begin() of these buffers does not reset anything
+class CommandAllocator : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	CommandAllocator() = default;
+
+	// RAII constructor, calls Create
+	CommandAllocator(Device& device, CommandAllocatorInfo const& info = {});
+
+	// Calls Free
+	~CommandAllocator();
+
+	void Create(Device& device, CommandAllocatorInfo const& info = {});
+
+	// Thread safe, must not be called concurrently with NextFrame()
+	auto AllocatePrimary(u32 queue_family_index) -> Command&;
+	auto AllocateSecondary(u32 queue_family_index) -> Command&;
+
+	// Advance to the next frame in flight and recycle its pools. Waits for tickets of primary
+	// buffers it handed out when the frame was used last, secondary buffers are expected to be
+	// executed by them. Buffers of the recycled frame must not be in use on other threads
+	void NextFrame();
+
+	auto GetFrameIndex() const -> u32 { return frame_index; }
+	auto GetStats() const -> CommandAllocatorStats;
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+
+	struct Pool {
+		vk::CommandPool     pool = nullptr;
+		// Handed out front to back, deque keeps handed out buffers in place when it grows
+		std::deque<Command> primaries;
+		std::deque<Command> secondaries;
+		u32                 used_primaries   = 0;
+		u32                 used_secondaries = 0;
+	};
+
+	// Pools of one thread and queue family, one per frame in flight
+	struct ThreadPools {
+		std::thread::id   thread;
+		u32               queue_family_index;
+		std::vector<Pool> frames;
+	};
+
+	// Pools of calling thread, cached in a thread local
+	auto GetThreadPools(u32 queue_family_index) -> ThreadPools&;
+	auto Allocate(u32 queue_family_index, vk::CommandBufferLevel level) -> Command&;
+
+	CommandAllocatorInfo info;
+	// Identifies this allocator in thread local caches
+	u64                  id          = 0;
+	u32                  frame_index = 0;
+
+	// Guards registration of thread pools, deque keeps their addresses stable
+	mutable std::mutex      mutex;
+	std::deque<ThreadPools> thread_pools;
+
+	std::atomic<u32> primary_buffers   = 0;
+	std::atomic<u32> secondary_buffers = 0;
+	u64              pool_resets       = 0;
+};
+} // namespace VB_NAMESPACE
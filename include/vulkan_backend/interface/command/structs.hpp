@@ -12,8 +12,10 @@ import std;
 import vulkan_hpp;
 #endif
 
+#include "vulkan_backend/interface/buffer/buffer.hpp"
 #include "vulkan_backend/interface/image/image.hpp"
 #include "vulkan_backend/config.hpp"
+#include "vulkan_backend/defaults/image.hpp"
 #include "vulkan_backend/types.hpp"
 
 VB_EXPORT
@@ -47,11 +49,34 @@ struct RenderingInfo {
 	u32                              layer_count = 1;
 };
 
+// Number of calls dropped by Command because the same state was already bound
+struct CommandStateStats {
+	u64 pipeline_binds        = 0;
+	u64 descriptor_set_binds  = 0;
+	u64 push_constants        = 0;
+	u64 viewports             = 0;
+	u64 scissors              = 0;
+	u64 vertex_buffer_binds   = 0;
+	u64 index_buffer_binds    = 0;
+};
+
+// Barriers recorded by Command
+struct CommandBarrierStats {
+	// vkCmdPipelineBarrier2 calls
+	u64 dependencies    = 0;
+	u64 memory_barriers = 0;
+	u64 buffer_barriers = 0;
+	u64 image_barriers  = 0;
+};
+
 struct BlitInfo {
 	Image const&               dst;
 	Image const&               src;
 	std::span<ImageBlit const> regions = {};
 	vk::Filter                 filter  = vk::Filter::eLinear;
+	// Empty regions == whole extent of these mip levels
+	vk::ImageSubresourceLayers dst_subresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1};
+	vk::ImageSubresourceLayers src_subresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1};
 };
 
 /* ===== Synchronization 2 Barriers ===== */
@@ -70,12 +95,29 @@ struct BufferBarrier {
 	MemoryBarrier  memoryBarrier;
 };
 
+/* ===== Automatic barriers ===== */
+// Use of a buffer by the next command, see Command::Access()
+struct BufferAccess {
+	Buffer const&    buffer;
+	vk::AccessFlags2 access = vk::AccessFlagBits2::eShaderStorageRead;
+};
+
+// Use of an image by the next command, see Command::Access()
+struct ImageAccess {
+	Image&           image;
+	vk::AccessFlags2 access = vk::AccessFlagBits2::eShaderSampledRead;
+	vk::ImageLayout  layout = vk::ImageLayout::eUndefined; // == keep current layout
+	vk::ImageSubresourceRange range = defaults::kAllSubresources;
+};
+
 struct ImageBarrier {
 	vk::ImageLayout newLayout           = vk::ImageLayout::eUndefined; // == use previous layout
 	vk::ImageLayout oldLayout           = vk::ImageLayout::eUndefined; // == use previous layout
 	u32             srcQueueFamilyIndex = vk::QueueFamilyIgnored;
 	u32             dstQueueFamilyIndex = vk::QueueFamilyIgnored;
 	MemoryBarrier   memoryBarrier;
+	// Only subresources in range are transitioned
+	vk::ImageSubresourceRange range = defaults::kAllSubresources;
 };
 } // VB_NAMESPACE
 
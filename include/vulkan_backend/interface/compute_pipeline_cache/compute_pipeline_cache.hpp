@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/compute_pipeline_cache/info.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Cache of compute pipelines by shader stage, specialization constants and layout.
+// Pipelines are shared: when the cache is over capacity, the least recently used one is dropped from it
+// and retired with Device::RetirePipeline() once its last reference is released.
+// Retired pipelines are destroyed only by Device::ReleaseRetiredPipelines(), so call it regularly,
+// e.g. once per frame after submitting, while pipelines are evicted or released.
+// All references must be released before the device is freed
+class ComputePipelineCache : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	ComputePipelineCache() = default;
+
+	// RAII constructor, calls Create
+	ComputePipelineCache(Device& device, ComputePipelineCacheInfo const& info = {});
+
+	// Releases cached references
+	~ComputePipelineCache();
+
+	void Create(Device& device, ComputePipelineCacheInfo const& info = {});
+
+	// Get pipeline for info or create it. Thread-safe, pipelines are created outside the lock.
+	// Returns null if creation failed, failed pipelines are not cached
+	auto GetOrCreate(PipelineInfo const& info) -> std::shared_ptr<Pipeline>;
+
+	// Evicts least recently used pipelines if the new capacity is smaller
+	void SetCapacity(std::size_t capacity);
+	void Clear();
+	auto GetStats() const -> ComputePipelineCacheStats;
+
+	// Key material of pipeline info: stage, source, compiler, compile options, entry point,
+	// specialization map entries and data bytes, and layout. Name is ignored.
+	// File sources add write time and size of the file, files they include are not checked
+	static auto GetKeyData(PipelineInfo const& info) -> std::string;
+
+	// Stable hash of GetKeyData()
+	static auto GetKey(PipelineInfo const& info) -> u64;
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+	// Call with mutex locked
+	void EvictOverCapacity();
+
+	// Key data and pipeline
+	using Entry = std::pair<std::string, std::shared_ptr<Pipeline>>;
+
+	mutable std::mutex mutex;
+	// Most recently used first
+	std::list<Entry>                                          entries;
+	// Views key data of entries, list nodes do not move
+	std::unordered_map<std::string_view, std::list<Entry>::iterator> entries_by_key;
+	std::size_t                                               capacity = 0;
+	ComputePipelineCacheStats                                 stats;
+};
+} // namespace VB_NAMESPACE
@@ -0,0 +1,25 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <cstddef>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+struct ComputePipelineCacheInfo {
+	// Max number of cached pipelines, least recently used ones are evicted
+	std::size_t capacity = 256;
+};
+
+struct ComputePipelineCacheStats {
+	u64         hits      = 0;
+	u64         misses    = 0;
+	u64         evictions = 0;
+	std::size_t size      = 0;
+};
+} // namespace VB_NAMESPACE
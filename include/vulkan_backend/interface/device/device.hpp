@@ -1,7 +1,15 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #elif defined(VB_DEV)
 import std;
 #endif
@@ -22,12 +30,17 @@ import vk_mem_alloc;
 #include "vulkan_backend/defaults/image.hpp"
 #include "vulkan_backend/fwd.hpp"
 #include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/interface/compute_pipeline_cache/compute_pipeline_cache.hpp"
 #include "vulkan_backend/interface/device/info.hpp"
+#include "vulkan_backend/interface/device/structs.hpp"
 #include "vulkan_backend/interface/instance/instance.hpp" // allocator
 #include "vulkan_backend/interface/pipeline/info.hpp"
 #include "vulkan_backend/interface/pipeline_layout/info.hpp"
 #include "vulkan_backend/interface/pipeline_layout/pipeline_layout.hpp"
 #include "vulkan_backend/interface/pipeline_library/info.hpp"
+#include "vulkan_backend/interface/queue/info.hpp"
+#include "vulkan_backend/interface/shader_module_cache/shader_module_cache.hpp"
+#include "vulkan_backend/util/thread_pool.hpp"
 
 VB_EXPORT
 namespace VB_NAMESPACE {
@@ -49,6 +62,8 @@ class Device : public vk::Device, NoCopyNoMove, public Named, public ResourceBas
 	[[nodiscard]] auto CreateCommand(u32 queue_family_index) -> Command;
 	[[nodiscard]] auto CreateDescriptor(DescriptorInfo const& info) -> Descriptor;
 	[[nodiscard]] auto CreatePipelineLayout(PipelineLayoutInfo const& info) -> vk::PipelineLayout;
+	// Destroy layout returned by CreatePipelineLayout()
+	void DestroyPipelineLayout(vk::PipelineLayout layout);
 	// Graphics pipeline library functions (VK_EXT_graphics_pipeline_library)
 	[[nodiscard("Not garbage-collected")]] auto CreateVertexInputInterface(VertexInputInfo const& info) -> vk::Pipeline;
 	[[nodiscard("Not garbage-collected")]] auto CreatePreRasterizationShaders(PreRasterizationInfo const& info) -> vk::Pipeline;
@@ -58,6 +73,31 @@ class Device : public vk::Device, NoCopyNoMove, public Named, public ResourceBas
 															 vk::PipelineLayout layout, bool link_time_optimization)
 		-> vk::Pipeline;
 
+	// Destroy pipeline after all work submitted to device queues so far is complete.
+	// Thread-safe. Pipeline is destroyed in ReleaseRetiredPipelines() or on device destruction
+	void RetirePipeline(vk::Pipeline pipeline);
+
+	// Destroy retired pipelines no longer used by the GPU.
+	// Waits for the last submitted ticket of every queue without blocking, so call it
+	// after submitting command buffers that were recorded with old pipelines. Thread-safe
+	void ReleaseRetiredPipelines();
+
+	// Create many pipelines at once. Shaders are loaded and compiled in parallel on the device
+	// thread pool, then pipelines are created with a few vkCreate*Pipelines calls.
+	// Pipelines are returned in the order of infos, null if their shaders failed to load or creation failed
+	[[nodiscard]] auto CreatePipelines(std::span<PipelineInfo const> infos) -> std::vector<Pipeline>;
+	[[nodiscard]] auto CreatePipelines(std::span<GraphicsPipelineInfo const> infos) -> std::vector<Pipeline>;
+
+	// Worker threads for device batch operations, started on first use
+	auto GetThreadPool() -> ThreadPool&;
+
+	// Shared compute pipelines by shader and specialization constants, created on first use.
+	// Capacity is DeviceInfo::compute_pipeline_cache_capacity
+	auto GetComputePipelineCache() -> ComputePipelineCache&;
+
+	// Shader modules shared by pipelines, see ShaderModuleCache
+	auto GetShaderModuleCache() -> ShaderModuleCache& { return *shader_module_cache; }
+
 	// These resources are stored in hashmap and freed automatically
 	[[nodiscard]] auto GetOrCreateSampler(vk::SamplerCreateInfo const& info = defaults::linearSampler) -> vk::Sampler;
 
@@ -77,6 +117,32 @@ class Device : public vk::Device, NoCopyNoMove, public Named, public ResourceBas
 	inline auto GetInstance() const -> Instance& { return *GetOwner(); }
 	inline auto GetPhysicalDevice() const -> PhysicalDevice& { return *physical_device; }
 	inline auto GetPipelineCache() const -> vk::PipelineCache { return pipeline_cache; }
+	// VK_EXT_shader_object with shaderObject feature enabled, see ShaderObject
+	inline auto IsShaderObjectEnabled() const -> bool { return shader_object; }
+	// VK_KHR_maintenance6 with maintenance6 feature enabled, Command binds descriptor sets with vkCmdBindDescriptorSets2KHR
+	inline auto IsMaintenance6Enabled() const -> bool { return maintenance6; }
+	// Equal for layouts that are compatible for sets 0..set by Vulkan layout compatibility rules:
+	// same push constant ranges and same set layouts (compared by handle).
+	// 0 for layouts not created by the library or with less than set + 1 set layouts
+	auto GetPipelineLayoutCompatibility(vk::PipelineLayout layout, u32 set = 0) const -> u64;
+	// Hits and misses are counted for pipelines created by the library
+	auto GetPipelineCacheStats() const -> PipelineCacheStats;
+	// Records of pipelines and pipeline library parts created by the library, in order of creation.
+	// At most DeviceInfo::pipeline_creation_stats_capacity most recent ones are kept.
+	// Driver durations and cache hits are filled if pipeline creation feedback is supported
+	auto GetPipelineCreationStats() const -> std::vector<PipelineCreationStats>;
+	void ClearPipelineCreationStats();
+	// Write creation records in Chrome trace event format (chrome://tracing, ui.perfetto.dev)
+	auto WritePipelineCreationTrace(std::string_view path) const -> vk::Result;
+	// Binary manifest of pipelines created since device creation, with their layouts and states.
+	// Empty if DeviceInfo::record_pipeline_manifest is not set
+	auto GetPipelineManifest() const -> std::vector<char>;
+	auto WritePipelineManifest(std::string_view path) const -> vk::Result;
+	// Create all pipelines of manifest in parallel and destroy them, so that pipeline cache and
+	// shader module cache are filled before the pipelines are needed.
+	// Manifest is valid only for the same build of the library
+	auto WarmUp(std::span<char const> manifest) -> vk::Result;
+	auto WarmUpFromFile(std::string_view path) -> vk::Result;
 	inline auto GetAllocator() const -> vk::AllocationCallbacks const* { return GetInstance().GetAllocator(); }
 	inline auto GetVmaAllocator() -> VmaAllocator& { return vma_allocator; }
 	// ResourceBase override
@@ -84,15 +150,96 @@ class Device : public vk::Device, NoCopyNoMove, public Named, public ResourceBas
 	void SetDebugUtilsName(vk::ObjectType objectType, void* handle, const char* name);
 
   private:
+	friend Pipeline;
+	friend PipelineLayout;
+	friend Descriptor;
+	friend ShaderWatcher;
 	void Free() override;
 
 	void LogWhyNotCreated(DeviceInfo const& info) const;
 
+	// Load cache data from file if it was written for this device and create pipeline_cache
+	auto CreatePipelineCache(std::string_view path) -> vk::Result;
+	// Merge with data on disk and atomically replace the file
+	void SavePipelineCache();
+	// Count cache hit or miss from pipeline creation feedback
+	void RecordPipelineCacheFeedback(vk::PipelineCreationFeedback const& feedback);
+	// Add creation record and count cache hit or miss. Stages are those passed in create info
+	void RecordPipelineCreation(std::string_view name, PipelineFeedback const& feedback,
+								std::span<vk::PipelineShaderStageCreateInfo const> stages = {});
+	// Add description to pipeline manifest if it is recorded
+	void RecordPipelineManifest(PipelineInfo const& info);
+	void RecordPipelineManifest(GraphicsPipelineInfo const& info);
+	void RecordPipelineManifest(vk::PipelineLayout layout, PipelineLayoutInfo const& info);
+	// Compute compatibility keys of layout for GetPipelineLayoutCompatibility()
+	void RegisterPipelineLayout(vk::PipelineLayout layout, PipelineLayoutInfo const& info);
+	void UnregisterPipelineLayout(vk::PipelineLayout layout);
+	void RecordPipelineManifest(vk::DescriptorSetLayout layout, vk::DescriptorSetLayoutCreateInfo const& info,
+								std::span<vk::DescriptorBindingFlags const> binding_flags);
+	// Forget handle of layout before it is destroyed, so a new layout with the same handle is not confused with it
+	void RemoveFromPipelineManifest(vk::PipelineLayout layout);
+	void RemoveFromPipelineManifest(vk::DescriptorSetLayout layout);
+
 	// void CreateBindlessDescriptor(DescriptorInfo const& info = defaults::kBindlessDescriptorInfo);
 
 	vk::PipelineCache pipeline_cache  = nullptr;
 	PhysicalDevice*   physical_device = nullptr;
 
+	// Empty if cache is not persisted
+	std::string pipeline_cache_path;
+	// Hash of the file contents at load time, to skip merging unchanged data on save
+	u64 pipeline_cache_loaded_hash = 0;
+
+	std::atomic<u64> pipeline_cache_hits   = 0;
+	std::atomic<u64> pipeline_cache_misses = 0;
+	u64              pipeline_cache_bytes_loaded = 0;
+
+	// Vulkan 1.3 or VK_EXT_pipeline_creation_feedback
+	bool                                  pipeline_creation_feedback = false;
+	std::chrono::steady_clock::time_point creation_time;
+	mutable std::mutex                    pipeline_creation_stats_mutex;
+	// Ring of records, oldest one is at pipeline_creation_stats_next once it is full
+	std::vector<PipelineCreationStats>    pipeline_creation_stats;
+	std::size_t                           pipeline_creation_stats_capacity = 0;
+	std::size_t                           pipeline_creation_stats_next     = 0;
+
+	// Retired pipelines, waiting for ReleaseRetiredPipelines(). Mutex also guards retired_pipeline_batches
+	std::mutex                retired_pipelines_mutex;
+	std::vector<vk::Pipeline> retired_pipelines;
+
+	// Pipelines to destroy when last submissions of all queues are complete
+	struct RetiredPipelineBatch {
+		std::vector<vk::Pipeline> pipelines;
+		std::vector<SubmitTicket> tickets;
+	};
+	std::vector<RetiredPipelineBatch> retired_pipeline_batches;
+	void DestroyRetiredPipelines(RetiredPipelineBatch& batch);
+
+	std::once_flag              thread_pool_once;
+	std::unique_ptr<ThreadPool> thread_pool;
+
+	std::size_t                           compute_pipeline_cache_capacity = 0;
+	std::once_flag                        compute_pipeline_cache_once;
+	std::unique_ptr<ComputePipelineCache> compute_pipeline_cache;
+
+	bool shader_object = false;
+	bool maintenance6  = false;
+
+	// Compatibility id for each set of layouts created by the library
+	mutable std::shared_mutex                                 pipeline_layouts_mutex;
+	std::unordered_map<VkPipelineLayout, std::vector<u64>> pipeline_layout_compatibility;
+	// Ids by compatibility key: push constant ranges and set layouts 0..N. Kept after layouts are destroyed,
+	// so ids are never reused. 0 is reserved for unknown layouts
+	std::unordered_map<std::string, u64> pipeline_layout_compatibility_ids;
+	u64                                  next_pipeline_layout_compatibility = 1;
+
+	// VK_EXT_shader_module_identifier with shaderModuleIdentifier feature enabled
+	bool                               shader_module_identifier = false;
+	std::unique_ptr<ShaderModuleCache> shader_module_cache;
+
+	// Null if DeviceInfo::record_pipeline_manifest is not set
+	std::unique_ptr<PipelineManifestRecorder> pipeline_manifest;
+
 	// Created with device and not changed
 	std::vector<Queue> queues;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <cstddef>
 #include <span>
 #include <string_view>
 #elif defined(VB_DEV)
@@ -41,6 +42,19 @@ struct DeviceInfo {
 	// - InsertStructureAfter()
 	vk::PhysicalDeviceFeatures2 const* const features2 = nullptr;
 
+	// File to load vk::PipelineCache from on creation and to save it to on destruction.
+	// Data written for another driver or device is ignored. Leave empty to not persist the cache
+	std::string_view const pipeline_cache_path = "";
+
+	// Max number of pipelines kept by GetComputePipelineCache()
+	std::size_t compute_pipeline_cache_capacity = 256;
+
+	// Record layouts and pipelines created with device for GetPipelineManifest() and WarmUp()
+	bool record_pipeline_manifest = false;
+
+	// Number of the most recent pipeline creation records kept for GetPipelineCreationStats(), 0 disables recording
+	std::size_t pipeline_creation_stats_capacity = 0;
+
 	// Give a name to device or use name of respective physical device
 	std::string_view const name = "";
 	bool check_vk_results = true;
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <cstdint>
+#include <string>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Counters of vk::PipelineCache usage, filled from pipeline creation feedback
+struct PipelineCacheStats {
+	// Pipelines created without compilation thanks to the cache
+	u64 hits = 0;
+	// Pipelines compiled by the driver
+	u64 misses = 0;
+	// Size of valid cache data loaded from disk on device creation
+	u64 bytes_loaded = 0;
+};
+
+// Creation time of one shader stage, reported by the driver
+struct PipelineStageCreationStats {
+	vk::ShaderStageFlagBits stage;
+	u64  duration_ns = 0;
+	bool cache_hit   = false;
+	// Driver filled the feedback
+	bool valid = false;
+};
+
+// Creation record of a pipeline or a pipeline library part
+struct PipelineCreationStats {
+	std::string name;
+	// Start of creation since device creation
+	u64 start_ns = 0;
+	// Measured on host around vkCreate*Pipelines call
+	u64 host_duration_ns = 0;
+	// Reported by the driver, 0 if feedback is not valid
+	u64  duration_ns = 0;
+	bool cache_hit   = false;
+	// Driver filled the feedback
+	bool valid = false;
+	// Small index of creating thread, in order of first use
+	u32 thread = 0;
+	std::vector<PipelineStageCreationStats> stages;
+};
+} // namespace VB_NAMESPACE
@@ -63,13 +63,27 @@ class Image : public vk::Image, public Named, public ResourceBase<Device> {
 	inline auto GetView() -> vk::ImageView& { return view; }
 	inline auto GetView() const -> vk::ImageView const& { return view; }
 	inline auto GetAllocation() const -> VmaAllocation { return allocation; }
-	inline auto GetLayout() const -> vk::ImageLayout { return layout; }
+	// Layout of all subresources, or of mip 0 of layer 0 if they differ
+	inline auto GetLayout() const -> vk::ImageLayout {
+		return subresource_states.empty() ? layout : subresource_states.front().layout;
+	}
+	inline auto GetLayout(u32 mip_level, u32 array_layer) const -> vk::ImageLayout {
+		return subresource_states.empty() ? layout : subresource_states[array_layer * mip_levels + mip_level].layout;
+	}
+	// All subresources are in the same layout and access state
+	inline auto HasUniformState() const -> bool { return subresource_states.empty(); }
+	inline auto GetMipLevels() const -> u32 { return mip_levels; }
+	inline auto GetArrayLayers() const -> u32 { return array_layers; }
 	inline auto GetAspect() const -> vk::ImageAspectFlags { return aspect; }
 	inline auto GetExtent() const -> vk::Extent3D { return extent; }
 	inline auto GetUsage() const -> vk::ImageUsageFlags { return usage; }
+	inline auto GetSamples() const -> vk::SampleCountFlagBits { return samples; }
 
 	// Do not call
-	inline void SetLayout(vk::ImageLayout const layout) { this->layout = layout; }
+	inline void SetLayout(vk::ImageLayout const layout) {
+		this->layout = layout;
+		subresource_states.clear();
+	}
 
 	inline auto IsFromSwapchain() const -> bool { return fromSwapchain; }
 
@@ -89,12 +103,23 @@ class Image : public vk::Image, public Named, public ResourceBase<Device> {
 
 	vk::ImageAspectFlags aspect;
 	// From Create info
-	vk::ImageLayout     layout;
 	vk::Extent3D        extent;
 	vk::Format          format;
 	vk::ImageUsageFlags usage;
+	u32                 mip_levels   = 1;
+	u32                 array_layers = 1;
+	vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
 
 	bool fromSwapchain = false;
+
+	// State on GPU timeline, updated by Command when recording, not by this object.
+	// subresource_states is empty while all subresources are in layout and access_state,
+	// otherwise it has state of each subresource at array_layer * mip_levels + mip_level
+	mutable vk::ImageLayout               layout;
+	mutable AccessState                   access_state;
+	mutable std::vector<SubresourceState> subresource_states;
+	friend Command;
+	friend RenderGraph;
 };
 
 class BindlessImage : public Image, public BindlessResourceBase {
@@ -38,9 +38,8 @@ struct Source  {
 struct PipelineStage {
 	enum class Flags {
 		kNone = 0,
-		// Option to not recompile the shader if respective 'filename'.spv exists and is up-to-date.
-		// But be careful with this, because if 'compile_options' such as define macros are changed,
-		// this might use old .spv file and cause hard to find bugs
+		// Option to not recompile the shader if SPIR-V compiled from the same source, included files,
+		// compiler, entry point and 'compile_options' is found in cache in 'out_path'
 		kAllowSkipCompilation = 1 << 1,
 		// Set link time optimization flag when using graphics pipeline library
 		// Note: to perform link time optimizations, the 'link_time_optimization' MUST be true
@@ -55,7 +54,7 @@ struct PipelineStage {
 	// Specify type if data is a string with shader code
 	Source source;
 
-	// Output path for compiled .spv. Has effect only if compilation is done
+	// Directory of SPIR-V cache for compiled .spv. Has effect only if compilation is done
 	std::string_view out_path = ".";
 
 	// Shader entry point
@@ -24,6 +24,7 @@ class Pipeline : public vk::Pipeline, public Named, public ResourceBase<Device>
 	Pipeline(Device& device, vk::Pipeline pipeline, vk::PipelineLayout layout, vk::PipelineBindPoint point,
 			 std::string_view name = "");
 
+	// Pipeline is null if its shaders failed to load or creation failed
 	Pipeline(Device& device, PipelineInfo const& info);
 	Pipeline(Device& device, GraphicsPipelineInfo const& info);
 
@@ -34,15 +35,26 @@ class Pipeline : public vk::Pipeline, public Named, public ResourceBase<Device>
 	auto GetDevice() const -> Device& { return *GetOwner(); }
 	auto GetLayout() const -> vk::PipelineLayout { return layout; }
 	auto GetBindPoint() const -> vk::PipelineBindPoint { return point; }
+
+	// Current handle. Safe to call while PipelineLibrary or ShaderWatcher replaces it from another thread
+	auto GetHandle() const -> vk::Pipeline;
+
   private:
-	void Create(PipelineInfo const& info);
-	void Create(GraphicsPipelineInfo const& info);
+	// Atomically replace handle, returns the previous one
+	auto Exchange(vk::Pipeline pipeline) -> vk::Pipeline;
+
+	auto Create(PipelineInfo const& info) -> vk::Result;
+	auto Create(GraphicsPipelineInfo const& info) -> vk::Result;
 	auto GetResourceTypeName() const -> char const* override;
 	void Free() override;
 	vk::PipelineLayout	  layout;
 	vk::PipelineBindPoint point;
+	// Device::GetPipelineLayoutCompatibility() for set 0, looked up once for Command
+	u64 layout_compatibility = 0;
 	friend Device;
 	friend PipelineLibrary;
+	friend ShaderWatcher;
+	friend ComputePipelineCache;
 	friend Command;
 };
 
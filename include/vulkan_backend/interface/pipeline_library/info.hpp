@@ -1,7 +1,9 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <optional>
 #include <span>
+#include <tuple>
 #include <unordered_map>
 #elif defined(VB_DEV)
 import std;
@@ -29,6 +31,14 @@ struct PreRasterizationHash;
 struct FragmentOutputHash;
 struct FragmentShaderHash;
 
+struct PipelineLibraryInfo {
+	// Return fast-linked pipelines immediately and link optimized versions on a worker thread.
+	// Optimized pipeline replaces fast-linked one in the same Pipeline object when ready,
+	// the old handle is retired with Device::RetirePipeline().
+	// Only pipelines with PipelineStage::Flags::kLinkTimeOptimization set on all stages are optimized
+	bool background_link_time_optimization = false;
+};
+
 // todo: use vectors instead of spans in key structs
 struct VertexInputInfo {
 	std::span<vk::Format const>						vertex_attributes;
@@ -98,6 +108,16 @@ struct FragmentOutputInfo {
 	}
 };
 
+// Split graphics pipeline info into 4 pipeline library parts.
+// Both shader parts reference all stages, each part only uses stages it consists of:
+// fragment shader part uses vk::ShaderStageFlagBits::eFragment stage, pre-rasterization part uses the rest
+auto SplitPipelineInfo(GraphicsPipelineInfo const& info)
+	-> std::tuple<VertexInputInfo, PreRasterizationInfo, FragmentShaderInfo, FragmentOutputInfo>;
+
+// True if stage is compiled into fragment shader library part
+constexpr inline auto IsFragmentShaderPartStage(vk::ShaderStageFlagBits stage) -> bool {
+	return stage == vk::ShaderStageFlagBits::eFragment;
+}
 
 // static inline auto operator==(PipelineStage const& lhs, PipelineStage const& rhs) -> bool {
 // 	return lhs.stage == rhs.stage && lhs.source.data == rhs.source.data &&
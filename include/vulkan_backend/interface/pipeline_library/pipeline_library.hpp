@@ -1,8 +1,16 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
 #include <span>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #elif defined(VB_DEV)
 import std;
 #endif
@@ -19,16 +27,126 @@ import vulkan_hpp;
 #include "vulkan_backend/interface/pipeline/pipeline.hpp"
 #include "vulkan_backend/classes/base.hpp"
 #include "vulkan_backend/util/hash.hpp"
+#include "vulkan_backend/util/thread_pool.hpp"
 
 VB_EXPORT
 namespace VB_NAMESPACE {
-class PipelineLibrary : NoCopyNoMove, ResourceBase<Device> {
-public:
-	// auto CreatePipeline(GraphicsPipelineInfo const& info) -> Pipeline;
-	void Free();
-
-private:
-	Device* device = nullptr;
-	friend Device;
+namespace detail {
+// Owned copies of the state hashed for each library part, compared when hashes match.
+// Create info structs are compared by value like they are hashed, including pointers
+struct PipelineStageKey {
+	vk::ShaderStageFlagBits                 stage;
+	Source::Type                            type;
+	std::string                             source;
+	std::string                             entry_point;
+	std::string                             compiler;
+	std::string                             compile_options;
+	std::vector<vk::SpecializationMapEntry> map_entries;
+	std::string                             specialization_data;
+
+	bool operator==(PipelineStageKey const&) const = default;
+};
+
+struct VertexInputKey {
+	std::vector<vk::Format>                  vertex_attributes;
+	vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+
+	bool operator==(VertexInputKey const&) const = default;
+};
+
+struct PreRasterizationKey {
+	vk::PipelineLayout                                     layout;
+	std::vector<vk::DynamicState>                          dynamic_states;
+	std::vector<PipelineStageKey>                          stages;
+	std::optional<vk::PipelineTessellationStateCreateInfo> tessellation;
+	vk::PipelineViewportStateCreateInfo                    viewport;
+	vk::PipelineRasterizationStateCreateInfo               rasterization;
+
+	bool operator==(PreRasterizationKey const&) const = default;
+};
+
+struct FragmentShaderKey {
+	vk::PipelineLayout                      layout;
+	std::vector<PipelineStageKey>           stages;
+	vk::PipelineDepthStencilStateCreateInfo depth_stencil;
+
+	bool operator==(FragmentShaderKey const&) const = default;
+};
+
+struct FragmentOutputKey {
+	std::vector<vk::PipelineColorBlendAttachmentState> blend_attachments;
+	vk::PipelineColorBlendStateCreateInfo              color_blend;
+	vk::PipelineMultisampleStateCreateInfo             multisample;
+	std::vector<vk::DynamicState>                      dynamic_states;
+	std::vector<vk::Format>                            color_formats;
+	vk::Format                                         depth_format;
+	vk::Format                                         stencil_format;
+
+	bool operator==(FragmentOutputKey const&) const = default;
+};
+
+// Parts are unique per state, so their handles identify a linked pipeline
+struct LinkedPipelineKey {
+	std::array<vk::Pipeline, 4> parts;
+	vk::PipelineLayout          layout;
+
+	bool operator==(LinkedPipelineKey const&) const = default;
+};
+
+struct LinkedPipelineKeyHash {
+	auto operator()(LinkedPipelineKey const& key) const -> std::size_t;
+};
+} // namespace detail
+
+// Cache of graphics pipeline library parts (VK_EXT_graphics_pipeline_library).
+// Each part is created once per unique state and shared by all pipelines linked from it.
+// Owns all created parts and linked pipelines and frees them with itself
+class PipelineLibrary : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	PipelineLibrary() = default;
+
+	// RAII constructor, calls Create
+	PipelineLibrary(Device& device, PipelineLibraryInfo const& info = {});
+
+	// Frees all pipelines
+	~PipelineLibrary();
+
+	void Create(Device& device, PipelineLibraryInfo const& info = {});
+
+	// Get linked pipeline for info, creating missing library parts. Pointer stays valid until library
+	// is freed. Null if a part or linking failed, failures are not cached and are retried next time
+	auto CreatePipeline(GraphicsPipelineInfo const& info) -> Pipeline*;
+
+	// Number of cached library parts and linked pipelines
+	auto GetPartCount() const -> std::size_t;
+	auto GetPipelineCount() const -> std::size_t { return pipelines.size(); }
+
+	// Block until all background link time optimizations are finished
+	void WaitOptimizations();
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+
+	// Library part with the state it was created from
+	template <typename Key>
+	using Parts = std::unordered_multimap<std::size_t, std::pair<Key, vk::Pipeline>>;
+
+	// Library parts by hash of their create info
+	Parts<detail::VertexInputKey>      vertex_input_interfaces;
+	Parts<detail::PreRasterizationKey> pre_rasterization_shaders;
+	Parts<detail::FragmentShaderKey>   fragment_shaders;
+	Parts<detail::FragmentOutputKey>   fragment_output_interfaces;
+
+	// Linked pipelines by their parts and layout
+	std::unordered_map<detail::LinkedPipelineKey, Pipeline, detail::LinkedPipelineKeyHash> pipelines;
+
+	// Links optimized pipelines if background_link_time_optimization is enabled
+	std::unique_ptr<ThreadPool> optimizer;
+	// Set on Free to skip queued optimizations
+	std::atomic<bool> stop_optimizations = false;
 };
 } // namespace VB_NAMESPACE
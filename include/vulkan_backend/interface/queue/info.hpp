@@ -7,6 +7,8 @@ import vulkan_hpp;
 #endif
 
 #include "vulkan_backend/config.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/types.hpp"
 
 VB_EXPORT
 namespace VB_NAMESPACE {	
@@ -20,4 +22,12 @@ struct QueueInfo {
 	// Require surface support
 	vk::SurfaceKHR    supported_surface = nullptr;
 };
+
+// Value signaled by a submission on the timeline semaphore of its queue
+struct SubmitTicket {
+	Queue const* queue = nullptr;
+	u64          value = 0;
+
+	explicit operator bool() const { return queue != nullptr; }
+};
 } // namespace VB_NAMESPACE
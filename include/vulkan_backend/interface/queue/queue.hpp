@@ -1,6 +1,8 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <limits>
 #include <span>
 #elif defined(VB_DEV)
 import std;
@@ -24,9 +26,17 @@ namespace VB_NAMESPACE {
 // Queue handle
 class Queue : public vk::Queue {
   public:
-	void Submit(std::span<vk::CommandBufferSubmitInfo const> cmds, vk::Fence fence = nullptr,
-				SubmitInfo const& info = {}) const;
+	// Also signals the next value of timeline semaphore of the queue
+	auto Submit(std::span<vk::CommandBufferSubmitInfo const> cmds, vk::Fence fence = nullptr,
+				SubmitInfo const& info = {}) const -> SubmitTicket;
 	void Wait() const;
+	// Wait for ticket of this queue at most timeout nanoseconds, returns true if it is complete
+	auto Wait(SubmitTicket const& ticket, u64 timeout = std::numeric_limits<u64>::max()) const -> bool;
+	// Non-blocking, no driver call if completion was already seen by an earlier poll or wait
+	auto IsComplete(SubmitTicket const& ticket) const -> bool;
+	// Ticket of the last submission, complete when all work submitted so far is
+	auto GetLastSubmitted() const -> SubmitTicket;
+	auto GetTimelineSemaphore() const -> vk::Semaphore;
 	auto GetFamilyIndex() const -> u32;
 	auto GetIndex() const -> u32;
 	auto GetFlags() const -> vk::QueueFlags;
@@ -37,9 +47,22 @@ class Queue : public vk::Queue {
 	friend Swapchain;
 	friend Command;
 	friend Device;
+	friend SubmitBatch;
+	friend QueueSubmitter;
+	// Signal of the next timeline value, the value is reserved by SetSubmitted() after submitting
+	auto GetNextTimelineSignal() const -> vk::SemaphoreSubmitInfo;
+	void SetSubmitted(u64 value) const;
+	// Keep the highest completed value seen
+	void UpdateCompleted(u64 value) const;
+
 	Device*		   device = nullptr;
 	u32			   family = ~0u;
 	u32			   index  = ~0u;
 	vk::QueueFlags flags  = {};
+
+	// Values are accessed with std::atomic_ref, so the queue stays copyable
+	vk::Semaphore timeline = nullptr;
+	alignas(std::atomic_ref<u64>::required_alignment) mutable u64 submitted_value = 0;
+	alignas(std::atomic_ref<u64>::required_alignment) mutable u64 completed_value = 0;
 };
 } // namespace VB_NAMESPACE
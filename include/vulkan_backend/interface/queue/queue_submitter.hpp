@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/command/structs.hpp"
+#include "vulkan_backend/interface/queue/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+struct QueueSubmitterInfo {
+	// Wait and signal semaphore infos copied per submission
+	static constexpr u32 kMaxSemaphores = 4;
+
+	// Submissions the ring holds, rounded up to a power of 2. Submit() spins while the ring is full
+	u32                      capacity        = 256;
+	// Most submissions coalesced into one submit2
+	u32                      max_batch       = 64;
+	// After waking up, wait this long for more submissions before submitting, 0 submits immediately
+	std::chrono::nanoseconds coalesce_window = {};
+};
+
+struct QueueSubmitterStats {
+	u64 submissions  = 0;
+	// vkQueueSubmit2 calls
+	u64 submit_calls = 0;
+	// Submit() calls that found the ring full
+	u64 full_waits   = 0;
+	// Submissions enqueued and not yet submitted, now and at most
+	u32 depth        = 0;
+	u32 max_depth    = 0;
+};
+
+// Owns a queue on a dedicated thread, so that any thread can submit without locking.
+// Submissions go through a bounded lock-free multi-producer single-consumer ring,
+// the submit thread takes all that are ready and submits them with one submit2.
+// Ticket is returned immediately: timeline values are assigned in ring order and the
+// submit thread signals the value of the last submission of each submit2. Waiting for a ticket
+// that is not submitted yet is allowed. While the submitter exists, do not submit to the queue directly
+class QueueSubmitter : NoCopyNoMove {
+  public:
+	QueueSubmitter(Queue const& queue, QueueSubmitterInfo const& info = {});
+
+	// Submits remaining submissions and joins the submit thread
+	~QueueSubmitter();
+
+	// Thread safe. Semaphore infos are copied, at most kMaxSemaphores of each. With more, cmd is not
+	// submitted, an error is logged and an empty ticket is returned. Ticket of cmd is set before return
+	auto Submit(Command& cmd, SubmitInfo const& info = {}) -> SubmitTicket;
+
+	auto GetQueue() const -> Queue const& { return *queue; }
+	auto GetStats() const -> QueueSubmitterStats;
+
+  private:
+	void SubmitLoop();
+
+	struct Slot {
+		// Equals position when free, position + 1 when filled (Vyukov bounded queue)
+		std::atomic<u64>                                                      sequence;
+		vk::CommandBuffer                                                     command_buffer;
+		u32                                                                   wait_count;
+		u32                                                                   signal_count;
+		std::array<vk::SemaphoreSubmitInfo, QueueSubmitterInfo::kMaxSemaphores> waits;
+		std::array<vk::SemaphoreSubmitInfo, QueueSubmitterInfo::kMaxSemaphores> signals;
+	};
+
+	Queue const*            queue;
+	QueueSubmitterInfo      info;
+	// Timeline value of the queue before the first submission, ticket of position p is first_value + p + 1
+	u64                     first_value;
+	std::unique_ptr<Slot[]> slots;
+	u64                     mask;
+
+	alignas(64) std::atomic<u64> enqueue_position = 0;
+	alignas(64) std::atomic<u64> dequeue_position = 0;
+	// Incremented after each filled slot and on stop, submit thread sleeps on it
+	alignas(64) std::atomic<u64> published        = 0;
+	std::atomic<bool>            stop             = false;
+
+	std::atomic<u64> submit_calls = 0;
+	std::atomic<u64> full_waits   = 0;
+	std::atomic<u32> max_depth    = 0;
+
+	std::thread thread;
+};
+} // namespace VB_NAMESPACE
@@ -0,0 +1,98 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <chrono>
+#include <span>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/command/structs.hpp"
+#include "vulkan_backend/interface/queue/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+struct SubmitBatchInfo {
+	// Flush when this many command buffers are collected, 0 disables
+	u32                      max_commands = 0;
+	// Flush when the first collected command buffer waits longer than this, 0 disables.
+	// Checked only on Add() and FlushIfDue(), call the latter when no more Add() may follow soon
+	std::chrono::nanoseconds max_delay    = {};
+};
+
+struct SubmitBatchStats {
+	// vkQueueSubmit2 calls
+	u32 flushes         = 0;
+	// vk::SubmitInfo2 entries and command buffers in them
+	u32 submit_infos    = 0;
+	u32 command_buffers = 0;
+};
+
+// Collects command buffers and semaphore operations of a queue and submits them with one submit2.
+// Wait() applies to command buffers added after it, Signal() to command buffers added before it,
+// so the batch is split into several vk::SubmitInfo2 entries when they are interleaved.
+// Timeline semaphore of the queue is signaled once per flush, after all entries, and tickets of
+// all flushed commands are set to that value. Not thread safe, use one batch per thread
+class SubmitBatch : NoCopyNoMove {
+  public:
+	SubmitBatch(Queue const& queue, SubmitBatchInfo const& info = {});
+
+	// Flushes collected command buffers
+	~SubmitBatch();
+
+	// Waits of info are added before the command buffer, signals after it.
+	// Ticket of the command buffer is set by the flush that submits it
+	void Add(Command& cmd, SubmitInfo const& info = {});
+	void Wait(vk::SemaphoreSubmitInfo const& wait);
+	void Signal(vk::SemaphoreSubmitInfo const& signal);
+
+	// Submit everything collected, returns empty ticket if nothing was collected
+	auto Flush(vk::Fence fence = nullptr) -> SubmitTicket;
+
+	// Flush if SubmitBatchInfo::max_delay has passed since the first collected command buffer,
+	// returns empty ticket otherwise. E.g. once per frame or from an idle loop
+	auto FlushIfDue() -> SubmitTicket;
+
+	auto IsEmpty() const -> bool { return submits.empty(); }
+	auto GetQueue() const -> Queue const& { return *queue; }
+	auto GetStats() const -> SubmitBatchStats const& { return stats; }
+	void ResetStats() { stats = {}; }
+
+  private:
+	// Ranges of the arrays below used by one vk::SubmitInfo2
+	struct Submit {
+		u32 first_wait   = 0;
+		u32 wait_count   = 0;
+		u32 first_cmd    = 0;
+		u32 cmd_count    = 0;
+		u32 first_signal = 0;
+		u32 signal_count = 0;
+	};
+
+	// Last entry if it can take a wait or a command buffer, otherwise a new one
+	auto GetSubmit(bool for_wait) -> Submit&;
+
+	Queue const*    queue;
+	SubmitBatchInfo info;
+
+	std::vector<Submit>                      submits;
+	std::vector<vk::SemaphoreSubmitInfo>     waits;
+	std::vector<vk::CommandBufferSubmitInfo> command_infos;
+	std::vector<vk::SemaphoreSubmitInfo>     signals;
+	// Tickets are set on flush
+	std::vector<Command*>                    commands;
+
+	std::chrono::steady_clock::time_point first_add_time;
+	SubmitBatchStats                      stats;
+};
+} // namespace VB_NAMESPACE
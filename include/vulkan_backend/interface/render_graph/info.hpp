@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <functional>
+#include <span>
+#include <string_view>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+u32 constexpr inline kInvalidRenderGraphResource = ~0u;
+
+// Handles of graph resources, valid until RenderGraph::Reset()
+struct RenderGraphImage {
+	u32 index = kInvalidRenderGraphResource;
+
+	explicit operator bool() const { return index != kInvalidRenderGraphResource; }
+};
+
+struct RenderGraphBuffer {
+	u32 index = kInvalidRenderGraphResource;
+
+	explicit operator bool() const { return index != kInvalidRenderGraphResource; }
+};
+
+// Transient 2D image, created by the graph and possibly aliased with other transient resources
+struct RenderGraphImageInfo {
+	vk::Format           format;
+	vk::Extent2D         extent;
+	vk::ImageUsageFlags  usage;
+	vk::ImageAspectFlags aspect       = vk::ImageAspectFlagBits::eColor;
+	u32                  mip_levels   = 1;
+	u32                  array_layers = 1;
+	std::string_view     name         = "";
+};
+
+// Transient buffer, created by the graph and possibly aliased with other transient resources
+struct RenderGraphBufferInfo {
+	vk::DeviceSize       size;
+	vk::BufferUsageFlags usage;
+	std::string_view     name = "";
+};
+
+struct RenderGraphImageAccess {
+	RenderGraphImage        image;
+	vk::PipelineStageFlags2 stages;
+	vk::AccessFlags2        access;
+	// Undefined keeps the current layout
+	vk::ImageLayout         layout = vk::ImageLayout::eUndefined;
+};
+
+struct RenderGraphBufferAccess {
+	RenderGraphBuffer       buffer;
+	vk::PipelineStageFlags2 stages;
+	vk::AccessFlags2        access;
+};
+
+struct RenderGraphPassInfo {
+	std::string_view                         name    = "";
+	std::span<RenderGraphImageAccess const>  images  = {};
+	std::span<RenderGraphBufferAccess const> buffers = {};
+	// Records the pass. Declared accesses are already synchronized when it is called
+	std::function<void(Command&)>            execute;
+	// Keep the pass even if none of its writes is used
+	bool                                     side_effects = false;
+};
+
+struct RenderGraphStats {
+	u32            passes              = 0;
+	u32            culled_passes       = 0;
+	// Groups of independent passes, barriers of each group are recorded with one pipelineBarrier2
+	u32            barrier_batches     = 0;
+	u32            transient_resources = 0;
+	u32            allocations         = 0;
+	// Memory transient resources would need without aliasing and memory allocated for them
+	vk::DeviceSize required_size       = 0;
+	vk::DeviceSize allocated_size      = 0;
+	u64            compilations        = 0;
+};
+} // namespace VB_NAMESPACE
@@ -0,0 +1,154 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#ifndef VB_USE_VMA_MODULE
+#include <vk_mem_alloc.h>
+#else
+import vk_mem_alloc;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/classes/structs.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/buffer/buffer.hpp"
+#include "vulkan_backend/interface/image/image.hpp"
+#include "vulkan_backend/interface/render_graph/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Passes declare accesses to graph resources and are recorded in an order that respects them.
+// Graph is declared every frame between Reset() and Execute(), it is compiled only when its topology
+// (resources, passes and their accesses) changes:
+// - passes whose writes are never used are culled, writes to imported resources are always used;
+// - independent passes are grouped in batches, barriers of a batch are recorded with one pipelineBarrier2;
+// - transient resources with disjoint lifetimes share memory.
+// Transient resources do not keep contents between executions. Recompilation frees them,
+// so previous executions must be complete. Use one graph per frame in flight
+class RenderGraph : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	RenderGraph() = default;
+
+	// RAII constructor, calls Create
+	RenderGraph(Device& device);
+
+	// Calls Free
+	~RenderGraph();
+
+	void Create(Device& device);
+
+	// Clear declared resources and passes. Compiled graph is kept for next declaration
+	void Reset();
+
+	auto CreateImage(RenderGraphImageInfo const& info) -> RenderGraphImage;
+	auto CreateBuffer(RenderGraphBufferInfo const& info) -> RenderGraphBuffer;
+
+	// Resources owned by user, their state is kept between executions
+	auto ImportImage(Image& image) -> RenderGraphImage;
+	auto ImportBuffer(Buffer& buffer) -> RenderGraphBuffer;
+
+	void AddPass(RenderGraphPassInfo const& info);
+
+	// Compile declared graph, Execute() calls it when topology changes
+	void Compile();
+
+	// Record passes in compiled order
+	void Execute(Command& cmd);
+
+	// Resource of handle, transient resources are valid after compilation
+	auto GetImage(RenderGraphImage image) -> Image&;
+	auto GetBuffer(RenderGraphBuffer buffer) -> Buffer&;
+
+	auto GetStats() const -> RenderGraphStats { return stats; }
+
+	// Hash of declared resources and passes. Names and imported handles are ignored
+	auto GetTopologyHash() const -> u64;
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+	void FreeTransients();
+	// Start lifetime of transient, its first accesses depend on last accesses to its memory
+	void AcquireMemory(u32 transient);
+
+	struct Resource {
+		std::string           name;
+		bool                  is_image;
+		RenderGraphImageInfo  image_info;
+		RenderGraphBufferInfo buffer_info;
+		// Null for transient resources
+		Image*                imported_image  = nullptr;
+		Buffer*               imported_buffer = nullptr;
+	};
+
+	// Access to resource, layout is ignored for buffers
+	struct Access {
+		u32                     resource;
+		vk::PipelineStageFlags2 stages;
+		vk::AccessFlags2        access;
+		vk::ImageLayout         layout;
+	};
+
+	struct Pass {
+		std::string                   name;
+		u32                           first_access;
+		u32                           access_count;
+		std::function<void(Command&)> execute;
+		bool                          side_effects;
+	};
+
+	struct Transient {
+		u32                    resource;
+		// Batches of first and last use
+		u32                    first_batch;
+		u32                    last_batch;
+		u32                    memory;
+		vk::MemoryRequirements requirements;
+		Image                  image;
+		Buffer                 buffer;
+	};
+
+	struct MemoryBlock {
+		VmaAllocation          allocation = nullptr;
+		vk::MemoryRequirements requirements;
+		std::vector<u32>       transients;
+		// Transient that used the memory last, kInvalidRenderGraphResource if none
+		u32                    last_transient = kInvalidRenderGraphResource;
+	};
+
+	// Declared
+	std::vector<Resource> resources;
+	std::vector<Access>   accesses;
+	std::vector<Pass>     passes;
+
+	// Compiled
+	bool                     compiled      = false;
+	u64                      compiled_hash = 0;
+	// Pass indices, batch i is in [batch_offsets[i], batch_offsets[i + 1])
+	std::vector<u32>         schedule;
+	std::vector<u32>         batch_offsets;
+	// Transient of each resource, kInvalidRenderGraphResource if imported or unused
+	std::vector<u32>         resource_transients;
+	std::vector<Transient>   transients;
+	std::vector<MemoryBlock> memories;
+	RenderGraphStats         stats;
+};
+} // namespace VB_NAMESPACE
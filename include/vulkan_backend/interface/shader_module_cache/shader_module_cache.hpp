@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Shader module shared by all pipelines with the same SPIR-V
+struct CachedShaderModule {
+	// FNV-1a hash of SPIR-V
+	u64 hash = 0;
+	// Null if only identifier is known
+	vk::ShaderModule module;
+	std::vector<u32> spirv;
+	// VK_EXT_shader_module_identifier, empty if not supported
+	std::vector<u8> identifier;
+};
+
+struct ShaderModuleCacheStats {
+	u64         hits            = 0;
+	u64         identifier_hits = 0;
+	u64         misses          = 0;
+	std::size_t modules         = 0;
+	std::size_t spirv_bytes     = 0;
+};
+
+// Shader modules by SPIR-V content, owned by device.
+// Pipelines with the same shader and different specialization constants share one module,
+// and a shader is loaded only when its source was not seen before or its module was trimmed.
+// With VK_EXT_shader_module_identifier, pipelines may be created from identifier of a trimmed module
+class ShaderModuleCache : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	ShaderModuleCache() = default;
+
+	// RAII constructor, calls Create
+	ShaderModuleCache(Device& device, bool use_identifiers);
+
+	// Destroys all modules
+	~ShaderModuleCache();
+
+	// Identifiers are used only if shaderModuleIdentifier feature is enabled
+	void Create(Device& device, bool use_identifiers);
+
+	// Get module for stage or create it. Thread-safe, shaders are loaded outside the lock.
+	// If allow_identifier is true, returns identifier without module for trimmed modules.
+	// Returns null if shader failed to load or its module could not be created
+	auto Get(PipelineStage const& stage, bool allow_identifier = false) -> std::shared_ptr<CachedShaderModule const>;
+
+	// Destroy modules and SPIR-V not referenced outside the cache. Identifiers are kept
+	void Trim();
+
+	auto GetStats() const -> ShaderModuleCacheStats;
+	auto UsesIdentifiers() const -> bool { return use_identifiers; }
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+
+	// Source of shader seen before
+	struct SourceRecord {
+		u64             hash = 0;
+		std::vector<u8> identifier;
+	};
+
+	mutable std::mutex                                            mutex;
+	std::unordered_map<u64, std::shared_ptr<CachedShaderModule>> modules_by_hash;
+	// By key of stage source, see GetShaderCacheKey()
+	std::unordered_map<u64, SourceRecord> sources;
+	ShaderModuleCacheStats                stats;
+	bool                                  use_identifiers = false;
+};
+} // namespace VB_NAMESPACE
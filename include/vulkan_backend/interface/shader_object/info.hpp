@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <span>
+#include <string_view>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+struct ShaderObjectInfo {
+	// Stage to compile. Specialization constants are applied on creation
+	PipelineStage stage;
+
+	// Stages that may be bound after this one, e.g. Fragment for Vertex
+	vk::ShaderStageFlags next_stages = {};
+
+	// Must be compatible with layout used to bind descriptor sets and push constants
+	std::span<vk::DescriptorSetLayout const> descriptor_set_layouts;
+	std::span<vk::PushConstantRange const>   push_constant_ranges;
+
+	std::string_view name             = "";
+	bool             check_vk_results = true;
+};
+} // namespace VB_NAMESPACE
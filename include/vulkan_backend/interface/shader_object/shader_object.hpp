@@ -0,0 +1,56 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <string_view>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/shader_object/info.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Shader compiled from a single stage with VK_EXT_shader_object, without pipeline.
+// Bind with Command::BindShaders() and set graphics state with Command::SetGraphicsState()
+class ShaderObject : public Named, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	ShaderObject() = default;
+
+	// RAII constructor, calls Create
+	ShaderObject(Device& device, ShaderObjectInfo const& info);
+
+	// Move-constructor
+	ShaderObject(ShaderObject&& other);
+
+	// Move-assignment
+	ShaderObject& operator=(ShaderObject&& other);
+
+	// Destructor, calls Free
+	~ShaderObject();
+
+	// Create with result checked.
+	// Fails with vk::Result::eErrorExtensionNotPresent if shader objects are not enabled on device
+	auto Create(Device& device, ShaderObjectInfo const& info) -> vk::Result;
+
+	auto GetHandle() const -> vk::ShaderEXT { return shader; }
+	auto GetStage() const -> vk::ShaderStageFlagBits { return stage; }
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+	// Destroys shader
+	void Free() override;
+
+  private:
+	vk::ShaderEXT           shader;
+	vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eCompute;
+};
+} // namespace VB_NAMESPACE
@@ -0,0 +1,111 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#elif defined(VB_DEV)
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/base.hpp"
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/fwd.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Rebuilds compute pipelines when their shader source or any file it includes changes.
+// Files are watched with inotify on Linux and polled for modification time on other platforms.
+// Pipelines are rebuilt on a background thread and swapped into watched Pipeline objects in Update()
+class ShaderWatcher : NoCopyNoMove, public ResourceBase<Device> {
+  public:
+	// No-op constructor
+	ShaderWatcher() = default;
+
+	// RAII constructor, calls Create
+	ShaderWatcher(Device& device);
+
+	// Stops watching, pipelines are not changed
+	~ShaderWatcher();
+
+	void Create(Device& device);
+
+	// Rebuild pipeline from info when its files change. Info is copied.
+	// Pipeline must stay valid until Unwatch() or watcher is freed
+	void Watch(Pipeline& pipeline, PipelineInfo const& info);
+	void Unwatch(Pipeline& pipeline);
+
+	// Swap rebuilt pipelines into watched Pipeline objects and retire old handles.
+	// Call at a frame or submit boundary from the thread that submits to queues:
+	// old handles are destroyed by Device::ReleaseRetiredPipelines(), called on every update, when the GPU is done with them.
+	// Returns number of swapped pipelines
+	auto Update() -> u32;
+
+	auto GetDevice() const -> Device& { return *GetOwner(); }
+	auto GetResourceTypeName() const -> char const* override;
+
+  private:
+	void Free() override;
+
+	// Copy of a compute stage with owned strings and specialization data
+	struct WatchedStage {
+		vk::ShaderStageFlagBits                 stage;
+		Source::Type                            source_type;
+		std::string                             source;
+		std::string                             out_path;
+		std::string                             entry_point;
+		std::string                             compiler;
+		std::string                             compile_options;
+		vk::Flags<PipelineStage::Flags>         flags;
+		std::vector<vk::SpecializationMapEntry> map_entries;
+		std::vector<char>                       specialization_data;
+	};
+
+	struct WatchedPipeline {
+		WatchedStage       stage;
+		vk::PipelineLayout layout;
+		std::string        name;
+		// Absolute paths of source and included files
+		std::vector<std::string> files;
+		// Changed by Watch(), rebuild result of older version is dropped
+		u64 version = 0;
+	};
+
+	void WatchFiles(std::span<std::string const> files);
+	// Paths of files changed since last call, waits for changes for a short time
+	auto WaitForChanges() -> std::vector<std::string>;
+	void WatchLoop();
+	void Rebuild(std::span<std::string const> changed_files);
+	// Null if compilation failed. Updates watched.files
+	auto BuildPipeline(WatchedPipeline& watched) -> vk::Pipeline;
+
+	std::mutex                                      mutex;
+	std::unordered_map<Pipeline*, WatchedPipeline>  watched_pipelines;
+	// Rebuilt handles waiting for Update()
+	std::vector<std::pair<Pipeline*, vk::Pipeline>> ready_pipelines;
+	u64                                             next_version = 0;
+
+	std::thread       thread;
+	std::atomic<bool> stop = false;
+
+	// inotify instance and watched directories by watch descriptor
+	int                                  inotify_fd = -1;
+	std::unordered_map<int, std::string> watched_directories;
+	// Modification times of files when inotify is not available
+	std::unordered_map<std::string, std::filesystem::file_time_type> file_times;
+};
+} // namespace VB_NAMESPACE
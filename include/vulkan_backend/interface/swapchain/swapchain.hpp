@@ -33,7 +33,7 @@ class Swapchain : public vk::SwapchainKHR, public Named, public ResourceBase<Dev
 	void Create(Device& device, SwapchainInfo const& info);
 	
 	bool AcquireNextImage();
-	void SubmitAndPresent(vk::Queue const& submit, vk::Queue const& present);
+	void SubmitAndPresent(Queue const& submit, vk::Queue const& present);
 	void Recreate(u32 width, u32 height);
 
 	auto GetCurrentImage() -> Image&;
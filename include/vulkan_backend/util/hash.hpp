@@ -2,7 +2,9 @@
 
 #ifndef VB_USE_STD_MODULE
 #include <cstddef>
+#include <cstdint>
 #include <span>
+#include <string_view>
 #elif defined(VB_DEV)
 import std;
 #endif
@@ -65,9 +67,18 @@ struct hash<vb::PipelineStage> {
 	std::size_t operator()(vb::PipelineStage const& stage) const {
 		std::size_t seed = 0;
 		VB_HASH_COMBINE(seed, stage.stage);
+		VB_HASH_COMBINE(seed, stage.source.type);
 		VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.source.data));
 		VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.entry_point));
+		VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.compiler));
 		VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.compile_options));
+		// Specialization constants by value, pointers differ between equal infos
+		auto const& specialization = stage.specialization_info;
+		for (std::uint32_t i = 0; i < specialization.mapEntryCount; ++i) {
+			VB_HASH_COMBINE(seed, specialization.pMapEntries[i]);
+		}
+		VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(std::string_view(
+								  static_cast<char const*>(specialization.pData), specialization.dataSize)));
 		return seed;
 	}
 };
@@ -88,7 +99,11 @@ struct hash<vb::PreRasterizationInfo> {
 		std::size_t seed = 0;
 		VB_HASH_COMBINE(seed, info.layout);
 		VB_HASH_COMBINE(seed, info.dynamic_states);
-		VB_HASH_COMBINE(seed, info.stages);
+		for (auto const& stage : info.stages) {
+			if (!vb::IsFragmentShaderPartStage(stage.stage)) {
+				VB_HASH_COMBINE(seed, stage);
+			}
+		}
 		VB_HASH_COMBINE(seed, info.tessellation);
 		VB_HASH_COMBINE(seed, info.viewport);
 		VB_HASH_COMBINE(seed, info.rasterization);
@@ -101,7 +116,11 @@ struct hash<vb::FragmentShaderInfo> {
 	std::size_t operator()(vb::FragmentShaderInfo const& info) const {
 		std::size_t hash = 0;
 		VB_HASH_COMBINE(hash, info.layout);
-		VB_HASH_COMBINE(hash, info.stages);
+		for (auto const& stage : info.stages) {
+			if (vb::IsFragmentShaderPartStage(stage.stage)) {
+				VB_HASH_COMBINE(hash, stage);
+			}
+		}
 		VB_HASH_COMBINE(hash, info.depth_stencil);
 		return hash;
 	}
@@ -13,8 +13,10 @@ import std;
 
 VB_EXPORT
 namespace VB_NAMESPACE {
-u64 inline HashFnv1a64(char const* data, std::size_t size) {
-	u64 hash = 0xcbf29ce484222325UL;
+inline constexpr u64 kFnv1a64OffsetBasis = 0xcbf29ce484222325UL;
+
+// Pass previous result as hash to continue hashing
+u64 inline HashFnv1a64(char const* data, std::size_t size, u64 hash = kFnv1a64OffsetBasis) {
 	for (std::size_t i = 0; i < size; ++i) {
 		hash ^= data[i];
 		hash *= 0x00000100000001B3UL;
@@ -22,8 +24,8 @@ u64 inline HashFnv1a64(char const* data, std::size_t size) {
 	return hash;
 }
 
-u64 inline HashFnv1a64(std::string_view data) {
-	return HashFnv1a64(data.data(), data.size());
+u64 inline HashFnv1a64(std::string_view data, u64 hash = kFnv1a64OffsetBasis) {
+	return HashFnv1a64(data.data(), data.size(), hash);
 }
 
 } // namespace VB_NAMESPACE
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #ifndef VB_USE_STD_MODULE
+#include <chrono>
+#include <memory>
 #include <span>
 #include <string_view>
+#include <vector>
 #elif defined(VB_DEV)
 import std;
 #endif
@@ -13,21 +16,77 @@ import std;
 import vulkan_hpp;
 #endif
 
+#include "vulkan_backend/classes/structure_chain.hpp"
+#include "vulkan_backend/compile_shader.hpp"
 #include "vulkan_backend/fwd.hpp"
 #include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/interface/shader_module_cache/shader_module_cache.hpp"
 #include "vulkan_backend/types.hpp"
 
 VB_EXPORT
 namespace VB_NAMESPACE {
-void CreateShaderModulesAndStagesInfos(Device const& device, std::span<const PipelineStage> stages,
-								vk::ShaderModule*				  p_shader_modules,
-								vk::PipelineShaderStageCreateInfo* p_shader_stages);
-								
-void CreateShaderModuleInfos(std::span<const PipelineStage> stages, std::vector<char>* p_bytes,
+void CreateShaderModuleInfos(std::span<const PipelineStage> stages, ShaderCode* p_code,
 									vk::ShaderModuleCreateInfo*		   p_shader_module_create_infos,
 									vk::PipelineShaderStageCreateInfo* p_shader_stages);
 
 void CreateVertexDescriptionsFromAttributes(std::span<vk::Format const>			vertex_attributes,
 													vk::VertexInputAttributeDescription* p_attribute_descs,
 													u32*									p_stride);
+
+// Storage for states referenced by vk::GraphicsPipelineCreateInfo made from GraphicsPipelineInfo.
+// Must not be moved or destroyed while returned create info is in use
+struct GraphicsPipelineCreateState {
+	std::vector<vk::VertexInputAttributeDescription>   attribute_descs;
+	vk::VertexInputBindingDescription                  binding_description;
+	vk::PipelineVertexInputStateCreateInfo             vertex_input;
+	vk::PipelineDynamicStateCreateInfo                 dynamic;
+	vk::PipelineRenderingCreateInfo                    rendering;
+	std::vector<vk::PipelineColorBlendAttachmentState> blend_attachments;
+	vk::PipelineColorBlendStateCreateInfo              color_blend;
+
+	auto Fill(GraphicsPipelineInfo const& info, std::span<vk::PipelineShaderStageCreateInfo const> shader_stages)
+		-> vk::GraphicsPipelineCreateInfo;
+};
+
+// Shader stages of a pipeline with modules from device shader module cache.
+// Must not be moved or destroyed while returned stage infos are in use
+struct ShaderStagesCreateState {
+	std::vector<std::shared_ptr<CachedShaderModule const>>            modules;
+	std::vector<vk::PipelineShaderStageModuleIdentifierCreateInfoEXT> identifier_infos;
+	std::vector<vk::PipelineShaderStageCreateInfo>                    stage_infos;
+	// Some stage has only module identifier. Pipeline is then created with GetPipelineFlags()
+	// and must be filled again without identifiers if creation returns vk::Result::ePipelineCompileRequired
+	bool uses_identifiers = false;
+
+	// Fill stage_infos. Fails if shader of some stage failed to load
+	auto Fill(Device& device, std::span<PipelineStage const> stages, bool allow_identifiers) -> vk::Result;
+	auto GetPipelineFlags() const -> vk::PipelineCreateFlags;
+};
+
+// Pipeline and per-stage creation feedback chained into a pipeline create info, with host timing.
+// Must not be moved after Chain()
+struct PipelineFeedback {
+	vk::PipelineCreationFeedback              pipeline;
+	std::vector<vk::PipelineCreationFeedback> stages;
+	vk::PipelineCreationFeedbackCreateInfo    info;
+	std::chrono::steady_clock::time_point     start;
+	// Set when creation of several pipelines finishes at once, otherwise time of recording is used
+	std::chrono::steady_clock::time_point     end;
+
+	// Start timing and chain feedback if enabled. Stage count must match stageCount of create info
+	template <typename CreateInfo>
+	void Chain(CreateInfo& create_info, u32 stage_count, bool enabled) {
+		start = std::chrono::steady_clock::now();
+		if (!enabled) {
+			return;
+		}
+		stages.resize(stage_count);
+		info = {
+			.pPipelineCreationFeedback          = &pipeline,
+			.pipelineStageCreationFeedbackCount = stage_count,
+			.pPipelineStageCreationFeedbacks    = stages.data(),
+		};
+		AddToPNext(create_info, info);
+	}
+};
 } // namespace VB_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#elif defined(VB_DEV)
+import std;
+#endif
+
+#include "vulkan_backend/classes/no_copy_no_move.hpp"
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/types.hpp"
+
+VB_EXPORT
+namespace VB_NAMESPACE {
+// Fixed set of worker threads executing submitted tasks in FIFO order
+class ThreadPool : NoCopyNoMove {
+  public:
+	// Start thread_count workers, 0 means std::thread::hardware_concurrency()
+	explicit ThreadPool(u32 thread_count = 0);
+
+	// Finishes queued tasks and joins workers
+	~ThreadPool();
+
+	void Submit(std::function<void()> task);
+
+	// Block until all submitted tasks are finished
+	void Wait();
+
+	// Split [0, count) into one contiguous range per thread and call function(begin, end) for each
+	// range on workers. Returns when all ranges are processed. Must not be called from a task of this pool
+	void ParallelFor(std::size_t count, std::function<void(std::size_t begin, std::size_t end)> const& function);
+
+	auto GetThreadCount() const -> u32 { return static_cast<u32>(threads.size()); }
+
+  private:
+	void WorkerLoop();
+
+	std::vector<std::thread>          threads;
+	std::deque<std::function<void()>> tasks;
+	std::mutex                        mutex;
+	std::condition_variable           task_available;
+	std::condition_variable           tasks_done;
+	u32                               active_tasks = 0;
+	bool                              stop         = false;
+};
+} // namespace VB_NAMESPACE
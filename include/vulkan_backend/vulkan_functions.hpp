@@ -14,4 +14,7 @@ void LoadInstanceDebugUtilsFunctionsEXT(vk::Instance instance);
 void LoadDeviceDebugUtilsFunctionsEXT(vk::Device device);
 void LoadInstanceCooperativeMatrixFunctionsKHR(vk::Instance instance);
 void LoadInstanceCooperativeMatrix2FunctionsNV(vk::Instance instance);
+void LoadDeviceShaderModuleIdentifierFunctionsEXT(vk::Device device);
+void LoadDeviceShaderObjectFunctionsEXT(vk::Device device);
+void LoadDeviceMaintenance6FunctionsKHR(vk::Device device);
 } // namespace VB_NAMESPACE
@@ -1,7 +1,20 @@
 #ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <span>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #else
 import std;
 #endif
@@ -12,11 +25,18 @@ import std;
 import vulkan_hpp;
 #endif
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "vulkan_backend/macros.hpp"
 #include "vulkan_backend/compile_shader.hpp"
 #include "vulkan_backend/util/algorithm.hpp"
 #include "vulkan_backend/util/hash_functions.hpp"
 #include "vulkan_backend/log.hpp"
+#include "shaderc_compiler.hpp"
 
 
 #if !defined( VB_MAX_COMPILE_STRING_SIZE )
@@ -42,7 +62,62 @@ auto ReadBinaryFile(std::string_view const& path) -> std::vector<char> {
 	return buffer;
 }
 
-void CompileShader(PipelineStage const& stage, char const* out_file) {
+namespace {
+// File extension compilers use to deduce shader stage
+auto GetGlslExtension(vk::ShaderStageFlagBits stage) -> char const* {
+	switch (stage) {
+	case vk::ShaderStageFlagBits::eVertex:                 return ".vert";
+	case vk::ShaderStageFlagBits::eFragment:               return ".frag";
+	case vk::ShaderStageFlagBits::eCompute:                return ".comp";
+	case vk::ShaderStageFlagBits::eGeometry:               return ".geom";
+	case vk::ShaderStageFlagBits::eTessellationControl:    return ".tesc";
+	case vk::ShaderStageFlagBits::eTessellationEvaluation: return ".tese";
+	case vk::ShaderStageFlagBits::eRaygenKHR:              return ".rgen";
+	case vk::ShaderStageFlagBits::eAnyHitKHR:              return ".rahit";
+	case vk::ShaderStageFlagBits::eClosestHitKHR:          return ".rchit";
+	case vk::ShaderStageFlagBits::eMissKHR:                return ".rmiss";
+	case vk::ShaderStageFlagBits::eIntersectionKHR:        return ".rint";
+	case vk::ShaderStageFlagBits::eCallableKHR:            return ".rcall";
+	case vk::ShaderStageFlagBits::eTaskEXT:                return ".task";
+	case vk::ShaderStageFlagBits::eMeshEXT:                return ".mesh";
+	default:                                               return ".glsl";
+	}
+}
+
+// Unique among threads of all processes sharing a cache directory, hashes of thread ids repeat across processes
+auto GetThreadTag() -> std::string {
+#ifdef _WIN32
+	auto const process_id = _getpid();
+#else
+	auto const process_id = getpid();
+#endif
+	return std::to_string(process_id) + "-" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
+} // namespace
+
+auto CompileShader(PipelineStage const& stage, char const* out_file, std::string* diagnostics) -> vk::Result {
+	// Compiler processes read source from a file
+	if (stage.source.type == Source::Type::RawGlsl || stage.source.type == Source::Type::RawSlang) {
+		std::filesystem::path source_file = std::string(out_file) + ".src";
+		source_file += stage.source.type == Source::Type::RawSlang ? ".slang" : GetGlslExtension(stage.stage);
+		{
+			std::ofstream file(source_file, std::ios::binary | std::ios::trunc);
+			file.write(stage.source.data.data(), stage.source.data.size());
+			if (!file) {
+				VB_LOG_ERROR("[ ShaderCompiler ] Failed to write %s", source_file.string().c_str());
+				return vk::Result::eErrorInitializationFailed;
+			}
+		}
+		std::string const source_path = source_file.string();
+		PipelineStage     file_stage  = stage;
+		file_stage.source             = {.data = source_path, .type = Source::Type::File};
+		vk::Result const result       = CompileShader(file_stage, out_file, diagnostics);
+		std::error_code  ec;
+		std::filesystem::remove(source_file, ec);
+		return result;
+	}
+	VB_ASSERT(stage.source.type == Source::Type::File, "CompileShader: source is not a shader file");
+
 	char compile_string[VB_MAX_COMPILE_STRING_SIZE];
 	char const* entry = "";
 	char const* target = "";
@@ -58,15 +133,34 @@ void CompileShader(PipelineStage const& stage, char const* out_file) {
 		}
 	}
 
-	std::snprintf(compile_string, VB_MAX_COMPILE_STRING_SIZE - 1, "%s %s %s -o %s %s%s %s",
-		stage.compiler.data(), options, stage.source.data.data(), out_file, entry,
-			stage.entry_point.data(), stage.compile_options.data());
+	// Compiler output goes to a file next to out_file to be returned as diagnostics
+	std::string const log_file = diagnostics ? std::string(out_file) + ".log" : std::string();
+	int const length = std::snprintf(compile_string, VB_MAX_COMPILE_STRING_SIZE, "%.*s %s %.*s -o %s %s%.*s %.*s%s%s%s",
+		static_cast<int>(stage.compiler.size()), stage.compiler.data(), options,
+		static_cast<int>(stage.source.data.size()), stage.source.data.data(), out_file, entry,
+		static_cast<int>(stage.entry_point.size()), stage.entry_point.data(),
+		static_cast<int>(stage.compile_options.size()), stage.compile_options.data(),
+		diagnostics ? " > \"" : "", log_file.c_str(), diagnostics ? "\" 2>&1" : "");
+	if (length < 0 || length >= VB_MAX_COMPILE_STRING_SIZE) {
+		VB_LOG_ERROR("[ ShaderCompiler ] Command is longer than VB_MAX_COMPILE_STRING_SIZE");
+		return vk::Result::eErrorOutOfHostMemory;
+	}
 
 	VB_LOG_TRACE("[ ShaderCompiler ] Command: %s", compile_string);
-	while(std::system(compile_string)) {
-		VB_LOG_ERROR("[ ShaderCompiler ] Error! Press something to Compile Again");
-		std::getchar();
+	int const status = std::system(compile_string);
+	if (diagnostics) {
+		std::ifstream log(log_file, std::ios::binary);
+		diagnostics->assign(std::istreambuf_iterator<char>(log), std::istreambuf_iterator<char>());
+		log.close();
+		std::error_code ec;
+		std::filesystem::remove(log_file, ec);
+	}
+	if (status != 0) {
+		VB_LOG_ERROR("[ ShaderCompiler ] Failed to compile %.*s", static_cast<int>(stage.source.data.size()),
+					 stage.source.data.data());
+		return vk::Result::eErrorUnknown;
 	}
+	return vk::Result::eSuccess;
 }
 
 // template <typename T>
@@ -74,69 +168,327 @@ void CompileShader(PipelineStage const& stage, char const* out_file) {
 // 	std::replace(buffer.begin(), buffer.end(), old_value, new_value);
 // }
 
+namespace {
+// Empty if file does not exist
+auto ReadFileIfExists(std::filesystem::path const& path) -> std::vector<char> {
+	std::ifstream file(path, std::ios::ate | std::ios::binary);
+	if (!file.is_open()) {
+		return {};
+	}
+	std::vector<char> buffer(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(buffer.data(), buffer.size());
+	return buffer;
+}
+
+// Directories passed with -I<dir> or -I <dir>
+auto ParseIncludeDirectories(std::string_view options) -> std::vector<std::filesystem::path> {
+	std::vector<std::filesystem::path> directories;
+	bool next_is_directory = false;
+	while (!options.empty()) {
+		std::size_t const begin = options.find_first_not_of(" \t");
+		if (begin == std::string_view::npos) break;
+		options.remove_prefix(begin);
+		std::size_t const end = std::min(options.find_first_of(" \t"), options.size());
+		std::string_view const token = options.substr(0, end);
+		options.remove_prefix(end);
+		if (next_is_directory) {
+			directories.emplace_back(token);
+			next_is_directory = false;
+		} else if (token == "-I") {
+			next_is_directory = true;
+		} else if (token.starts_with("-I")) {
+			directories.emplace_back(token.substr(2));
+		}
+	}
+	return directories;
+}
+
+// Names from #include "name" and #include <name> directives, quoted flag is true for "name"
+void ParseIncludes(std::string_view source, std::vector<std::pair<std::string_view, bool>>& includes) {
+	auto skip_spaces = [](std::string_view& line) {
+		std::size_t const pos = line.find_first_not_of(" \t");
+		line.remove_prefix(pos == std::string_view::npos ? line.size() : pos);
+	};
+	while (!source.empty()) {
+		std::size_t const line_end = std::min(source.find('\n'), source.size());
+		std::string_view line = source.substr(0, line_end);
+		source.remove_prefix(std::min(line_end + 1, source.size()));
+
+		skip_spaces(line);
+		if (!line.starts_with('#')) continue;
+		line.remove_prefix(1);
+		skip_spaces(line);
+		if (!line.starts_with("include")) continue;
+		line.remove_prefix(sizeof("include") - 1);
+		skip_spaces(line);
+		if (line.empty() || (line[0] != '"' && line[0] != '<')) continue;
+		char const closing = line[0] == '"' ? '"' : '>';
+		std::size_t const name_end = line.find(closing, 1);
+		if (name_end == std::string_view::npos) continue;
+		includes.emplace_back(line.substr(1, name_end - 1), closing == '"');
+	}
+}
+
+// Recursively find files included by source and hash their contents into hash
+void HashIncludes(std::filesystem::path const& directory, std::string_view source,
+				  std::span<std::filesystem::path const> include_directories,
+				  std::vector<std::filesystem::path>& visited, u64& hash) {
+	std::vector<std::pair<std::string_view, bool>> includes;
+	ParseIncludes(source, includes);
+	for (auto const& [name, quoted] : includes) {
+		hash = HashFnv1a64(name, hash);
+		std::filesystem::path found;
+		std::error_code ec;
+		if (quoted && std::filesystem::exists(directory / name, ec)) {
+			found = directory / name;
+		} else {
+			for (auto const& include_directory : include_directories) {
+				if (std::filesystem::exists(include_directory / name, ec)) {
+					found = include_directory / name;
+					break;
+				}
+			}
+		}
+		if (found.empty()) continue; // Compiler will report it
+		found = found.lexically_normal();
+		if (std::find(visited.begin(), visited.end(), found) != visited.end()) continue;
+		visited.push_back(found);
+
+		std::vector<char> const content = ReadFileIfExists(found);
+		hash = HashFnv1a64(content.data(), content.size(), hash);
+		HashIncludes(found.parent_path(), std::string_view(content.data(), content.size()), include_directories,
+					 visited, hash);
+	}
+}
+
+// In-memory copy of cache index files, by cache directory
+struct ShaderCacheIndex {
+	std::mutex mutex;
+	std::unordered_map<std::string, std::unordered_map<u64, std::string>> directories;
+};
+
+auto GetShaderCacheIndex() -> ShaderCacheIndex& {
+	static ShaderCacheIndex index;
+	return index;
+}
+
+constexpr char const* kShaderCacheIndexFileName = "shader_cache.index";
+
+// Load index file of directory if not loaded yet. Call with index mutex locked
+auto GetDirectoryIndex(ShaderCacheIndex& index, std::string const& directory) -> std::unordered_map<u64, std::string>& {
+	auto [it, inserted] = index.directories.try_emplace(directory);
+	if (inserted) {
+		// Each line is "<key in hex> <blob file name>"
+		std::ifstream file(std::filesystem::path(directory) / kShaderCacheIndexFileName);
+		std::string   line;
+		while (std::getline(file, line)) {
+			std::size_t const space = line.find(' ');
+			if (space == std::string::npos || space == 0 || space + 1 == line.size()) continue;
+			char* end = nullptr;
+			u64 const key = std::strtoull(line.c_str(), &end, 16);
+			if (end != line.c_str() + space) continue;
+			it->second.insert_or_assign(key, line.substr(space + 1));
+		}
+	}
+	return it->second;
+}
+
+auto FindCachedShader(std::string const& directory, u64 key) -> std::string {
+	auto& index = GetShaderCacheIndex();
+	std::lock_guard lock(index.mutex);
+	auto& blobs = GetDirectoryIndex(index, directory);
+	auto  it    = blobs.find(key);
+	return it != blobs.end() ? it->second : std::string{};
+}
+
+void AddCachedShader(std::string const& directory, u64 key, std::string const& blob_name) {
+	auto& index = GetShaderCacheIndex();
+	std::lock_guard lock(index.mutex);
+	auto& blobs = GetDirectoryIndex(index, directory);
+	if (auto it = blobs.find(key); it != blobs.end() && it->second == blob_name) return;
+	blobs.insert_or_assign(key, blob_name);
+	std::ofstream file(std::filesystem::path(directory) / kShaderCacheIndexFileName, std::ios::app);
+	file << std::hex << key << ' ' << blob_name << '\n';
+}
+} // namespace
+
+auto CompileShader(PipelineStage const& stage) -> ShaderCompileResult {
+	ShaderCompileResult result;
+	if (stage.source.type == Source::Type::RawSpirV || stage.source.type == Source::Type::FileSpirV) {
+		result.result      = vk::Result::eErrorFormatNotSupported;
+		result.diagnostics = "Source is already SPIR-V";
+		return result;
+	}
+
+	// glslc options are shaderc options, so the stage can be compiled in-process
+	if (stage.compiler == "glslc" && stage.source.type == Source::Type::File) {
+		std::string const path(stage.source.data);
+		std::ifstream     file(path, std::ios::binary);
+		if (!file.is_open()) {
+			result.result      = vk::Result::eErrorInitializationFailed;
+			result.diagnostics = "Failed to open file: " + path;
+			return result;
+		}
+		std::string const source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (CompileWithShaderc(stage, source, path.c_str(), result)) {
+			return result;
+		}
+	} else if (stage.compiler == "glslc" && stage.source.type == Source::Type::RawGlsl) {
+		// Relative includes are resolved from current directory
+		std::string const name(stage.entry_point);
+		if (CompileWithShaderc(stage, stage.source.data, name.c_str(), result)) {
+			return result;
+		}
+	}
+
+	// Run compiler process and read its output back
+	std::error_code       ec;
+	std::filesystem::path out_file = std::filesystem::temp_directory_path(ec);
+	out_file /= "vb-shader-" + std::to_string(GetShaderCacheKey(stage)) + "-" + GetThreadTag() + ".spv";
+	result.result = CompileShader(stage, out_file.string().c_str(), &result.diagnostics);
+	if (result.result == vk::Result::eSuccess) {
+		result.spirv = ReadFileIfExists(out_file);
+	}
+	std::filesystem::remove(out_file, ec);
+	return result;
+}
+
+auto GetShaderCacheKey(PipelineStage const& stage) -> u64 {
+	u64 hash = kFnv1a64OffsetBasis;
+	hash = HashFnv1a64(stage.compiler, hash);
+	hash = HashFnv1a64(stage.entry_point, hash);
+	hash = HashFnv1a64(stage.compile_options, hash);
+	u32 const stage_bits = static_cast<u32>(stage.stage);
+	hash = HashFnv1a64(reinterpret_cast<char const*>(&stage_bits), sizeof(stage_bits), hash);
+	u32 const source_type = static_cast<u32>(stage.source.type);
+	hash = HashFnv1a64(reinterpret_cast<char const*>(&source_type), sizeof(source_type), hash);
+
+	std::vector<std::filesystem::path> const include_directories = ParseIncludeDirectories(stage.compile_options);
+	std::vector<std::filesystem::path> visited;
+	if (stage.source.type == Source::Type::File) {
+		std::filesystem::path const path = stage.source.data;
+		std::vector<char> const content  = ReadFileIfExists(path);
+		hash = HashFnv1a64(content.data(), content.size(), hash);
+		HashIncludes(path.parent_path(), std::string_view(content.data(), content.size()), include_directories,
+					 visited, hash);
+	} else {
+		hash = HashFnv1a64(stage.source.data, hash);
+		HashIncludes(std::filesystem::current_path(), stage.source.data, include_directories, visited, hash);
+	}
+	return hash;
+}
+
+auto GetShaderDependencies(PipelineStage const& stage) -> std::vector<std::string> {
+	std::vector<std::string> dependencies;
+	if (stage.source.type == Source::Type::RawSpirV) {
+		return dependencies;
+	}
+
+	// Includes are resolved the same way as for the cache key
+	std::vector<std::filesystem::path> const include_directories = ParseIncludeDirectories(stage.compile_options);
+	std::vector<std::filesystem::path> visited;
+	u64 hash = kFnv1a64OffsetBasis;
+	if (stage.source.type == Source::Type::File || stage.source.type == Source::Type::FileSpirV) {
+		std::filesystem::path const path = stage.source.data;
+		dependencies.push_back(path.lexically_normal().string());
+		if (stage.source.type == Source::Type::File) {
+			std::vector<char> const content = ReadFileIfExists(path);
+			HashIncludes(path.parent_path(), std::string_view(content.data(), content.size()), include_directories,
+						 visited, hash);
+		}
+	} else {
+		HashIncludes(std::filesystem::current_path(), stage.source.data, include_directories, visited, hash);
+	}
+	for (auto const& path : visited) {
+		dependencies.push_back(path.string());
+	}
+	return dependencies;
+}
+
 auto LoadShader(PipelineStage const& stage) -> std::vector<char> {
-	char out_file_name[VB_MAX_PATH_SIZE + 1];
-	char out_file[VB_MAX_PATH_SIZE + 1];
-	char const* file_name_input = stage.source.data.data();
-	VB_ASSERT(stage.source.type == Source::Type::File || stage.source.type == Source::Type::FileSpirV, "LoadShader: source type not implemented");
-	switch (stage.source.type) {
-	case Source::Type::File: {
-		int size = std::snprintf(out_file_name, VB_MAX_PATH_SIZE, "%s", stage.source.data.data());
-		std::span file_name_view(out_file_name, size);
-		std::replace(file_name_view.begin(), file_name_view.end(), '\\', '-');
-		std::replace(file_name_view.begin(), file_name_view.end(), '/', '-');
-		// std::ranges::replace(file_name_view, '.', '-');
-	} break;
-	case Source::Type::FileSpirV:
+	if (stage.source.type == Source::Type::FileSpirV) {
 		return ReadBinaryFile(stage.source.data);
-
-	default: {
-		u64 hash = HashFnv1a64(stage.source.data);
-		std::snprintf(out_file_name, VB_MAX_PATH_SIZE, "%s-%zx", stage.entry_point.data(), hash);
 	}
+	if (stage.source.type == Source::Type::RawSpirV) {
+		return std::vector<char>(stage.source.data.begin(), stage.source.data.end());
 	}
 
+	u64 const key = GetShaderCacheKey(stage);
+	std::string const directory = stage.out_path.empty() ? std::string(".") : std::string(stage.out_path);
 
-	if (stage.out_path.empty()) {
-		VB_FORMAT_TO_BUFFER(out_file, "./%s.spv", out_file_name);
+	// Blob name is readable name of the source followed by the key
+	char key_string[17];
+	std::snprintf(key_string, sizeof(key_string), "%016llx", static_cast<unsigned long long>(key));
+	std::string blob_name;
+	if (stage.source.type == Source::Type::File) {
+		blob_name = stage.source.data;
+		std::replace(blob_name.begin(), blob_name.end(), '\\', '-');
+		std::replace(blob_name.begin(), blob_name.end(), '/', '-');
 	} else {
-		VB_FORMAT_TO_BUFFER(out_file, "%s/%s.spv", stage.out_path.data(), out_file_name);
-	}
-	// std::printf("Output file name: %s\n", out_file_name);
-	// std::printf("Output file: %s\n", out_file);
-
-	std::filesystem::path out_file_path = out_file;
-	out_file_path = out_file_path.parent_path();
-	if (!std::filesystem::exists(out_file_path)) {
-		std::filesystem::create_directories(out_file_path);
-	}
-	bool compilation_required =
-		(stage.flags & PipelineStage::Flags::kAllowSkipCompilation) != PipelineStage::Flags::kAllowSkipCompilation;
-
-	
-	// check if already compiled to .spv
-	if (stage.source.type == Source::Type::File) [[likely]] {
-		std::filesystem::path const shader_path = stage.source.data;
-		if (std::filesystem::exists(out_file) && std::filesystem::exists(shader_path)) {
-			auto lastSpvUpdate	  = std::filesystem::last_write_time(out_file);
-			auto lastShaderUpdate = std::filesystem::last_write_time(shader_path);
-			if (lastShaderUpdate > lastSpvUpdate) {
-				compilation_required = true;
+		blob_name = stage.entry_point;
+	}
+	blob_name += '-';
+	blob_name += key_string;
+	blob_name += ".spv";
+
+	bool const allow_skip_compilation =
+		(stage.flags & PipelineStage::Flags::kAllowSkipCompilation) == PipelineStage::Flags::kAllowSkipCompilation;
+	if (allow_skip_compilation) {
+		std::string const cached_name = FindCachedShader(directory, key);
+		if (!cached_name.empty()) {
+			std::vector<char> bytes = ReadFileIfExists(std::filesystem::path(directory) / cached_name);
+			if (!bytes.empty()) {
+				VB_LOG_TRACE("[ ShaderCompiler ] Cache hit: %s", cached_name.c_str());
+				return bytes;
 			}
-		} else {
-			compilation_required = true;
 		}
-	} else {
-		if (!std::filesystem::exists(out_file)) {
-			compilation_required = true;
+	}
+
+	ShaderCompileResult compiled = CompileShader(stage);
+	if (compiled.result != vk::Result::eSuccess) {
+		VB_LOG_ERROR("[ ShaderCompiler ] %s: %s", blob_name.c_str(), compiled.diagnostics.c_str());
+		return {};
+	}
+	if (!compiled.diagnostics.empty()) {
+		VB_LOG_WARN("[ ShaderCompiler ] %s: %s", blob_name.c_str(), compiled.diagnostics.c_str());
+	}
+
+	// Write to a unique temporary file and rename, so concurrent compilations of the same shader do not clash
+	std::error_code ec;
+	std::filesystem::create_directories(directory, ec);
+	std::filesystem::path const blob_path = std::filesystem::path(directory) / blob_name;
+	std::filesystem::path tmp_path = blob_path;
+	tmp_path += "." + GetThreadTag() + ".tmp";
+	{
+		std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+		file.write(compiled.spirv.data(), compiled.spirv.size());
+		if (!file) {
+			VB_LOG_WARN("[ ShaderCompiler ] Failed to write %s", tmp_path.string().c_str());
+			return std::move(compiled.spirv);
 		}
 	}
-	
-	if (compilation_required) {
-		CompileShader(stage, out_file);
-		return ReadBinaryFile(out_file);
-	} else {
-		return ReadBinaryFile(out_file);
+	std::filesystem::rename(tmp_path, blob_path, ec);
+	if (ec) {
+		VB_LOG_WARN("[ ShaderCompiler ] Failed to move %s to cache: %s", tmp_path.string().c_str(), ec.message().c_str());
+		std::filesystem::remove(tmp_path, ec);
+		return std::move(compiled.spirv);
+	}
+	AddCachedShader(directory, key, blob_name);
+	return std::move(compiled.spirv);
+}
+
+auto LoadShaderCode(PipelineStage const& stage) -> ShaderCode {
+	if (stage.source.type == Source::Type::RawSpirV) {
+		std::span<char const> const code(stage.source.data.data(), stage.source.data.size());
+		VB_ASSERT(code.size() % sizeof(u32) == 0, "LoadShaderCode: SPIR-V size is not a multiple of 4");
+		// vk::ShaderModuleCreateInfo::pCode must be aligned to 4 bytes
+		if (reinterpret_cast<std::uintptr_t>(code.data()) % alignof(u32) == 0) {
+			return ShaderCode(code);
+		}
+		VB_LOG_TRACE("[ ShaderCompiler ] Copying unaligned SPIR-V of %.*s", static_cast<int>(stage.entry_point.size()),
+					 stage.entry_point.data());
 	}
+	return ShaderCode(LoadShader(stage));
 }
-} // namespace VB_NAMESPACE
\ No newline at end of file
+} // namespace VB_NAMESPACE
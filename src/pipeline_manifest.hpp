@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/config.hpp"
+#include "vulkan_backend/interface/pipeline/info.hpp"
+#include "vulkan_backend/interface/pipeline_layout/info.hpp"
+#include "vulkan_backend/types.hpp"
+
+namespace VB_NAMESPACE {
+// Records descriptions of layouts and pipelines created by device into binary pipeline manifest.
+// Layouts are stored once per description and referenced by pipelines by index. Thread-safe
+class PipelineManifestRecorder {
+  public:
+	void AddDescriptorSetLayout(vk::DescriptorSetLayout layout, vk::DescriptorSetLayoutCreateInfo const& info,
+								std::span<vk::DescriptorBindingFlags const> binding_flags);
+	void AddPipelineLayout(vk::PipelineLayout layout, PipelineLayoutInfo const& info);
+	void AddPipeline(PipelineInfo const& info);
+	void AddPipeline(GraphicsPipelineInfo const& info);
+	// Forget handle of destroyed layout, its description stays in manifest
+	void RemoveDescriptorSetLayout(vk::DescriptorSetLayout layout);
+	void RemovePipelineLayout(vk::PipelineLayout layout);
+
+	auto Serialize() const -> std::vector<char>;
+
+  private:
+	// Index of description, adding it if new. Descriptions with the same hash are compared.
+	// Call with mutex locked
+	static auto AddUnique(std::string&& record, std::vector<std::string>& records,
+						  std::unordered_multimap<u64, u32>& index_by_hash) -> u32;
+	auto GetLayoutIndex(vk::PipelineLayout layout) const -> u32;
+
+	mutable std::mutex mutex;
+
+	std::vector<std::string>                         set_layouts;
+	std::unordered_multimap<u64, u32>                set_layout_by_hash;
+	std::unordered_map<VkDescriptorSetLayout, u32>   set_layout_by_handle;
+
+	std::vector<std::string>                         pipeline_layouts;
+	std::unordered_multimap<u64, u32>                pipeline_layout_by_hash;
+	std::unordered_map<VkPipelineLayout, u32>        pipeline_layout_by_handle;
+
+	std::vector<std::string>                         pipelines;
+	std::unordered_multimap<u64, u32>                pipeline_by_hash;
+};
+} // namespace VB_NAMESPACE
@@ -34,7 +34,7 @@ Buffer::Buffer(Device& device, BufferInfo const& info) { Create(device, info); }
 Buffer::Buffer(Buffer&& other) noexcept
 	: vk::Buffer(std::exchange(static_cast<vk::Buffer&>(other), {})), ResourceBase(std::move(other)),
 	  allocation(std::move(other.allocation)), allocation_info(std::move(other.allocation_info)), size(std::move(other.size)),
-	  memory(std::move(other.memory)), usage(std::move(other.usage)) {}
+	  memory(std::move(other.memory)), usage(std::move(other.usage)), access_state(other.access_state) {}
 
 Buffer& Buffer::operator=(Buffer&& other) noexcept {
 	if (this != &other) {
@@ -45,6 +45,7 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept {
 		size            = std::move(other.size);
 		usage           = std::move(other.usage);
 		memory          = std::move(other.memory);
+		access_state    = other.access_state;
 	}
 	return *this;
 }
@@ -119,9 +120,19 @@ auto Buffer::Create(Device& device, BufferInfo const& info) -> vk::Result {
 	};
 
 	VB_LOG_TRACE("[ vmaCreateBuffer ] size = %zu, name = %s", bufferInfo.size, detail::FormatName(info.name).data());
-	VB_VK_RESULT result =
-		vk::Result(vmaCreateBuffer(GetDevice().GetVmaAllocator(), &reinterpret_cast<VkBufferCreateInfo&>(bufferInfo), &allocInfo,
-								   reinterpret_cast<VkBuffer*>(static_cast<vk::Buffer*>(this)), &allocation, &allocation_info));
+	VB_VK_RESULT result;
+	if (info.alias_allocation) {
+		// Null allocation makes vmaDestroyBuffer() leave the memory alone
+		allocation      = nullptr;
+		allocation_info = {};
+		result          = vk::Result(vmaCreateAliasingBuffer2(GetDevice().GetVmaAllocator(), info.alias_allocation,
+															 info.alias_offset, &reinterpret_cast<VkBufferCreateInfo&>(bufferInfo),
+															 reinterpret_cast<VkBuffer*>(static_cast<vk::Buffer*>(this))));
+	} else {
+		result = vk::Result(vmaCreateBuffer(GetDevice().GetVmaAllocator(), &reinterpret_cast<VkBufferCreateInfo&>(bufferInfo),
+											&allocInfo, reinterpret_cast<VkBuffer*>(static_cast<vk::Buffer*>(this)),
+											&allocation, &allocation_info));
+	}
 	VB_VERIFY_VK_RESULT(result, info.check_vk_results, "Failed to create buffer!", {});
 
 	return result;
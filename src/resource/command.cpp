@@ -1,6 +1,15 @@
 #ifndef VB_USE_STD_MODULE
-#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <limits>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
 #else
 import std;
 #endif
@@ -12,25 +21,208 @@ import vulkan_hpp;
 #endif
 
 #include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/interface/command/command_allocator.hpp"
 #include "vulkan_backend/interface/device/device.hpp"
 #include "vulkan_backend/interface/buffer/buffer.hpp"
 #include "vulkan_backend/interface/image/image.hpp"
 #include "vulkan_backend/interface/pipeline/pipeline.hpp"
+#include "vulkan_backend/interface/queue/queue.hpp"
+#include "vulkan_backend/interface/shader_object/shader_object.hpp"
 #include "vulkan_backend/macros.hpp"
 #include "vulkan_backend/util/enumerate.hpp"
+#include "vulkan_backend/util/pipeline.hpp"
 #include "vulkan_backend/vk_result.hpp"
 #include "vulkan_backend/log.hpp"
 
 
 namespace VB_NAMESPACE {
+namespace {
+// Index into Command::BoundState arrays, -1 for bind points that are not tracked
+auto GetBindPointIndex(vk::PipelineBindPoint point) -> int {
+	switch (point) {
+	case vk::PipelineBindPoint::eGraphics: return 0;
+	case vk::PipelineBindPoint::eCompute:  return 1;
+	default:                               return -1;
+	}
+}
+
+// Recordings of all commands get distinct ids, so pending scopes of other recordings never match
+std::atomic<u64> next_recording_id = 1;
+
+// Update state with a new access. Returns false if it needs no barrier, otherwise fills scopes of barrier.
+// recording and action identify the action command the access is declared for
+auto InferBarrier(AccessState& state, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, bool layout_change,
+				  u64 recording, u32 action, MemoryBarrier& scopes) -> bool {
+	vk::AccessFlags2 const reads  = access & ~kWriteAccess;
+	vk::AccessFlags2 const writes = access & kWriteAccess;
+
+	// Inside destination scope of a barrier that no action command has passed yet
+	bool const covered = !layout_change && state.pending_recording == recording && state.pending_action == action &&
+						 !(stages & ~state.pending_stages) && !(access & ~state.pending_access);
+
+	// Read after write: last write is not visible to these stages yet
+	bool const raw = !covered && state.write_stages && reads &&
+					 ((stages & ~state.read_stages) || (reads & ~state.read_access));
+	// Write after write: no reads in between carried the dependency
+	bool const waw = !covered && state.write_stages && writes && !state.read_stages;
+	// Write after read: reads have seen the last write, only an execution dependency is needed
+	bool const war = !covered && state.read_stages && writes;
+
+	if (layout_change) {
+		// Transition writes the image, so it waits for all earlier accesses
+		scopes = {
+			.srcStageMask  = state.write_stages | state.read_stages,
+			.srcAccessMask = state.write_access,
+			.dstStageMask  = stages,
+			.dstAccessMask = access,
+		};
+	} else if (raw || waw || war) {
+		bool const memory = raw || waw;
+		scopes = {
+			.srcStageMask  = (memory ? state.write_stages : vk::PipelineStageFlags2{}) |
+							 (war ? state.read_stages : vk::PipelineStageFlags2{}),
+			.srcAccessMask = memory ? state.write_access : vk::AccessFlags2{},
+			.dstStageMask  = stages,
+			.dstAccessMask = memory ? access : vk::AccessFlags2{},
+		};
+	}
+
+	if (writes) {
+		state.write_stages = stages;
+		state.write_access = access;
+		state.read_stages  = {};
+		state.read_access  = {};
+	} else if (layout_change) {
+		// Transition is visible to this access, later ones depend on its stages
+		state.write_stages = stages;
+		state.write_access = {};
+		state.read_stages  = stages;
+		state.read_access  = access;
+	} else {
+		state.read_stages |= stages;
+		state.read_access |= access;
+	}
+
+	// Declared access is synchronized for this action, declaring it again is a no-op
+	if (state.pending_recording != recording || state.pending_action != action) {
+		state.pending_stages    = {};
+		state.pending_access    = {};
+		state.pending_recording = recording;
+		state.pending_action    = action;
+	}
+	state.pending_stages |= stages;
+	state.pending_access |= access;
+	return layout_change || raw || waw || war;
+}
+
+// Range with aspect of image if empty and without remaining counts
+auto ResolveRange(Image const& image, vk::ImageSubresourceRange range) -> vk::ImageSubresourceRange {
+	if (!range.aspectMask) {
+		range.aspectMask = image.GetAspect();
+	}
+	if (range.levelCount == vk::RemainingMipLevels) {
+		range.levelCount = image.GetMipLevels() - range.baseMipLevel;
+	}
+	if (range.layerCount == vk::RemainingArrayLayers) {
+		range.layerCount = image.GetArrayLayers() - range.baseArrayLayer;
+	}
+	return range;
+}
+
+auto RangeFromLayers(vk::ImageSubresourceLayers const& layers) -> vk::ImageSubresourceRange {
+	return {
+		.aspectMask     = layers.aspectMask,
+		.baseMipLevel   = layers.mipLevel,
+		.levelCount     = 1,
+		.baseArrayLayer = layers.baseArrayLayer,
+		.layerCount     = layers.layerCount,
+	};
+}
+
+auto RangesOverlap(vk::ImageSubresourceRange const& a, vk::ImageSubresourceRange const& b) -> bool {
+	return a.baseMipLevel < b.baseMipLevel + b.levelCount && b.baseMipLevel < a.baseMipLevel + a.levelCount &&
+		   a.baseArrayLayer < b.baseArrayLayer + b.layerCount && b.baseArrayLayer < a.baseArrayLayer + a.layerCount;
+}
+
+auto GetMipExtent(vk::Extent3D const& extent, u32 mip_level) -> vk::Extent3D {
+	return {
+		std::max(1u, extent.width >> mip_level),
+		std::max(1u, extent.height >> mip_level),
+		std::max(1u, extent.depth >> mip_level),
+	};
+}
+} // namespace
+
+template <typename Update>
+void Command::UpdateImageState(Image const& image, vk::ImageSubresourceRange const& range, Update&& update) {
+	u32 const  mip_levels = image.mip_levels;
+	u32 const  mip_end    = range.baseMipLevel + range.levelCount;
+	u32 const  layer_end  = range.baseArrayLayer + range.layerCount;
+	auto&      states     = image.subresource_states;
+	bool const whole      = range.levelCount == mip_levels && range.layerCount == image.array_layers;
+
+	if (states.empty()) {
+		// Uniform state, one run for the whole range
+		SubresourceState const state{image.layout, image.access_state};
+		SubresourceState const new_state = update(range, state);
+		if (whole) {
+			image.layout       = new_state.layout;
+			image.access_state = new_state.access;
+			return;
+		}
+		if (new_state == state) {
+			return;
+		}
+		states.assign(std::size_t(mip_levels) * image.array_layers, state);
+		for (u32 layer = range.baseArrayLayer; layer < layer_end; ++layer) {
+			std::fill_n(states.begin() + layer * mip_levels + range.baseMipLevel, range.levelCount, new_state);
+		}
+		return;
+	}
+
+	// Runs of equal state along mip levels of each layer
+	for (u32 layer = range.baseArrayLayer; layer < layer_end; ++layer) {
+		auto const layer_states = states.begin() + layer * mip_levels;
+		for (u32 mip = range.baseMipLevel; mip < mip_end;) {
+			SubresourceState const state   = layer_states[mip];
+			u32                    run_end = mip + 1;
+			while (run_end < mip_end && layer_states[run_end] == state) {
+				++run_end;
+			}
+			vk::ImageSubresourceRange const run{
+				.aspectMask     = range.aspectMask,
+				.baseMipLevel   = mip,
+				.levelCount     = run_end - mip,
+				.baseArrayLayer = layer,
+				.layerCount     = 1,
+			};
+			std::fill(layer_states + mip, layer_states + run_end, update(run, state));
+			mip = run_end;
+		}
+	}
+
+	// Back to compact form when all subresources agree again
+	if (std::adjacent_find(states.begin(), states.end(), std::not_equal_to<>{}) == states.end()) {
+		image.layout       = states.front().layout;
+		image.access_state = states.front().access;
+		states.clear();
+	}
+}
+
 Command::Command(Device& device, u32 queue_family_index) {
 	VB_VK_RESULT result = Create(device, queue_family_index, true);
 }
 
 Command::Command() : vk::CommandBuffer{}, ResourceBase{} {}
 
+Command::Command(Device& device, u32 queue_family_index, vk::CommandBuffer command_buffer,
+				 vk::CommandBufferLevel level, CommandAllocator& allocator)
+	: vk::CommandBuffer(command_buffer), ResourceBase(&device), queue_family(queue_family_index), level(level),
+	  command_allocator(&allocator) {}
+
 auto Command::Create(Device& device, u32 queue_family_index, bool check_enabled) -> vk::Result {
 	ResourceBase::SetOwner(&device);
+	queue_family = queue_family_index;
 
 	vk::CommandPoolCreateInfo poolInfo {
 		// .flags = 0, // do not use VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
@@ -51,25 +243,33 @@ auto Command::Create(Device& device, u32 queue_family_index, bool check_enabled)
 	result = GetDevice().allocateCommandBuffers(&allocInfo, &commandBuffer);
 	VB_VERIFY_VK_RESULT(result, check_enabled, "Failed to allocate command buffer!", {});
 	vk::CommandBuffer::operator=(commandBuffer);
-
-	vk::FenceCreateInfo fence_info{
-		.flags = vk::FenceCreateFlagBits::eSignaled,
-	};
-
-	std::tie(result, fence) = GetDevice().createFence(fence_info, GetDevice().GetAllocator());
-	VB_VERIFY_VK_RESULT(result, check_enabled, "Failed to create fence!", {});
 	return vk::Result::eSuccess;
 }
 
 Command::Command(Command&& other)
-		: vk::CommandBuffer(std::exchange(other, {})), ResourceBase(std::move(other)),
-		  pool(std::exchange(other.pool, {})), fence(std::exchange(other.fence, {})) {}
+		: vk::CommandBuffer(std::exchange(static_cast<vk::CommandBuffer&>(other), {})), ResourceBase(std::move(other)),
+		  pool(std::exchange(other.pool, {})), queue_family(other.queue_family), level(other.level),
+		  command_allocator(other.command_allocator), ticket(std::exchange(other.ticket, {})),
+		  shader_objects_bound(other.shader_objects_bound), in_rendering(other.in_rendering),
+		  recording_id(other.recording_id), action_index(other.action_index), bound_state(other.bound_state),
+		  state_stats(other.state_stats), barrier_stats(other.barrier_stats), pending_barriers(other.pending_barriers) {}
 
 Command& Command::operator=(Command&& other) {
-	vk::CommandBuffer::operator=(std::exchange(other, {}));
+	vk::CommandBuffer::operator=(std::exchange(static_cast<vk::CommandBuffer&>(other), {}));
 	ResourceBase::operator=(std::move(other));
 	pool = std::exchange(other.pool, {});
-	fence = std::exchange(other.fence, {});
+	queue_family = other.queue_family;
+	level = other.level;
+	command_allocator = other.command_allocator;
+	ticket = std::exchange(other.ticket, {});
+	shader_objects_bound = other.shader_objects_bound;
+	in_rendering = other.in_rendering;
+	recording_id = other.recording_id;
+	action_index = other.action_index;
+	bound_state = other.bound_state;
+	state_stats = other.state_stats;
+	barrier_stats = other.barrier_stats;
+	pending_barriers = other.pending_barriers;
 	return *this;
 }
 
@@ -91,7 +291,13 @@ bool Command::Copy(vk::Buffer const& dst, StagingBuffer& staging, void const* da
 	return true;
 }
 
+bool Command::Copy(Buffer const& dst, StagingBuffer& staging, void const* data, u32 size, u32 dst_offset) {
+	Access(dst, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+	return Copy(static_cast<vk::Buffer const&>(dst), staging, data, size, dst_offset);
+}
+
 void Command::Copy(vk::Buffer const& dst, vk::Buffer const& src, u32 size, u32 dstOffset, u32 srcOffset) {
+	FlushBarriers();
 	vk::BufferCopy2 copyRegion{
 		.pNext = nullptr,
 		.srcOffset = srcOffset,
@@ -110,6 +316,9 @@ void Command::Copy(vk::Buffer const& dst, vk::Buffer const& src, u32 size, u32 d
 }
 
 void Command::Copy(vb::Buffer const& dst, vb::Buffer const& src) {
+	Access(src, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead);
+	Access(dst, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite);
+	FlushBarriers();
 	VB_HOT_ASSERT(dst.GetSize() >= src.GetSize(), "Dst buffer is too small");
 	vk::BufferCopy2 copyRegion{
 		.srcOffset = 0,
@@ -139,7 +348,10 @@ bool Command::Copy(Image const& dst, StagingBuffer& staging, void const* data, u
 	return true;
 }
 
-void Command::Copy(Image const &dst, vk::Buffer const &src, u32 srcOffset) {
+void Command::Copy(Image const &dst, vk::Buffer const &src, u32 srcOffset, vk::ImageSubresourceLayers const& subresource) {
+	AccessImage(dst, RangeFromLayers(subresource), vk::PipelineStageFlagBits2::eCopy,
+				vk::AccessFlagBits2::eTransferWrite);
+	FlushBarriers();
 	VB_ASSERT(!(dst.GetAspect() & vk::ImageAspectFlagBits::eDepth ||
 				dst.GetAspect() & vk::ImageAspectFlagBits::eStencil),
 			  "CmdCopy doesnt't support depth/stencil images");
@@ -148,20 +360,15 @@ void Command::Copy(Image const &dst, vk::Buffer const &src, u32 srcOffset) {
 		.bufferOffset = srcOffset,
 		.bufferRowLength = 0,
 		.bufferImageHeight = 0,
-		.imageSubresource{
-			.aspectMask = vk::ImageAspectFlagBits::eColor,
-			.mipLevel = 0,
-			.baseArrayLayer = 0,
-			.layerCount = 1,
-		},
+		.imageSubresource = subresource,
 		.imageOffset = {0, 0, 0},
-		.imageExtent = dst.GetExtent(),
+		.imageExtent = GetMipExtent(dst.GetExtent(), subresource.mipLevel),
 	};
 
 	vk::CopyBufferToImageInfo2 copyBufferToImageInfo{
 		.srcBuffer = src,
 		.dstImage = dst,
-		.dstImageLayout = dst.GetLayout(),
+		.dstImageLayout = dst.GetLayout(subresource.mipLevel, subresource.baseArrayLayer),
 		.regionCount = 1,
 		.pRegions = &region
 	};
@@ -170,7 +377,10 @@ void Command::Copy(Image const &dst, vk::Buffer const &src, u32 srcOffset) {
 }
 
 void Command::Copy(vk::Buffer const &dst, Image const &src, u32 dstOffset,
-				vk::Offset3D imageOffset, Extent3D imageExtent) {
+				vk::Offset3D imageOffset, Extent3D imageExtent, vk::ImageSubresourceLayers const& subresource) {
+	AccessImage(src, RangeFromLayers(subresource), vk::PipelineStageFlagBits2::eCopy,
+				vk::AccessFlagBits2::eTransferRead);
+	FlushBarriers();
 	VB_ASSERT(!(src.GetAspect() & vk::ImageAspectFlagBits::eDepth ||
 				src.GetAspect() & vk::ImageAspectFlagBits::eStencil),
 			"CmdCopy doesn't support depth/stencil images");
@@ -178,19 +388,14 @@ void Command::Copy(vk::Buffer const &dst, Image const &src, u32 dstOffset,
 		.bufferOffset = dstOffset,
 		.bufferRowLength = 0,
 		.bufferImageHeight = 0,
-		.imageSubresource{
-			.aspectMask = vk::ImageAspectFlagBits::eColor,
-			.mipLevel = 0,
-			.baseArrayLayer = 0,
-			.layerCount = 1,
-		},
+		.imageSubresource = subresource,
 		.imageOffset = {imageOffset.x, imageOffset.y, imageOffset.z},
-		.imageExtent = src.GetExtent()
+		.imageExtent = GetMipExtent(src.GetExtent(), subresource.mipLevel)
 	};
 
 	vk::CopyImageToBufferInfo2 copyInfo{
 		.srcImage = src,
-		.srcImageLayout = (vk::ImageLayout)src.GetLayout(),
+		.srcImageLayout = src.GetLayout(subresource.mipLevel, subresource.baseArrayLayer),
 		.dstBuffer = dst,
 		.regionCount = 1,
 		.pRegions = &region,
@@ -199,48 +404,46 @@ void Command::Copy(vk::Buffer const &dst, Image const &src, u32 dstOffset,
 }
 
 void Command::Barrier(Image& img, ImageBarrier const& barrier) {
-	vk::ImageSubresourceRange range = {
-		.aspectMask = img.GetAspect(),
-		.baseMipLevel = 0,
-		.levelCount = vk::RemainingMipLevels,
-		.baseArrayLayer = 0,
-		.layerCount = vk::RemainingArrayLayers,
-	};
-
-	vk::ImageMemoryBarrier2 barrier2 = {
-		.pNext               = nullptr,
-		.srcStageMask        =   barrier.memoryBarrier.srcStageMask,
-		.srcAccessMask       =          barrier.memoryBarrier.srcAccessMask,
-		.dstStageMask        =   barrier.memoryBarrier.dstStageMask,
-		.dstAccessMask       =          barrier.memoryBarrier.dstAccessMask,
-		.oldLayout           = (barrier.oldLayout == vk::ImageLayout::eUndefined
-									? img.GetLayout()
-									: barrier.oldLayout),
-		.newLayout           = (barrier.newLayout == vk::ImageLayout::eUndefined
-									? img.GetLayout()
-									: barrier.newLayout),
-		.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex,
-		.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex,
-		.image               = img,
-		.subresourceRange    = range
-	};
-
-	vk::DependencyInfo dependency = {
-		.pNext                    = nullptr,
-		.dependencyFlags          = {},
-		.memoryBarrierCount       = 0,
-		.pMemoryBarriers          = nullptr,
-		.bufferMemoryBarrierCount = 0,
-		.pBufferMemoryBarriers    = nullptr,
-		.imageMemoryBarrierCount  = 1,
-		.pImageMemoryBarriers     = &barrier2
-	};
-
-	pipelineBarrier2(&dependency);
-	img.SetLayout(barrier.newLayout);
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers must not declare accesses or barriers");
+	// One barrier per run of subresources in the same layout
+	UpdateImageState(img, ResolveRange(img, barrier.range), [&](vk::ImageSubresourceRange const& run, SubresourceState const& state) {
+		vk::ImageMemoryBarrier2 barrier2 = {
+			.pNext               = nullptr,
+			.srcStageMask        = barrier.memoryBarrier.srcStageMask,
+			.srcAccessMask       = barrier.memoryBarrier.srcAccessMask,
+			.dstStageMask        = barrier.memoryBarrier.dstStageMask,
+			.dstAccessMask       = barrier.memoryBarrier.dstAccessMask,
+			.oldLayout           = (barrier.oldLayout == vk::ImageLayout::eUndefined
+										? state.layout
+										: barrier.oldLayout),
+			.newLayout           = (barrier.newLayout == vk::ImageLayout::eUndefined
+										? state.layout
+										: barrier.newLayout),
+			.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex,
+			.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex,
+			.image               = img,
+			.subresourceRange    = run
+		};
+		AddBarrier(barrier2);
+		// Following accesses depend on this barrier, the next action command needs no other one
+		// for accesses inside its destination scope
+		return SubresourceState{
+			.layout = barrier2.newLayout,
+			.access = {
+				.write_stages      = barrier2.dstStageMask,
+				.read_stages       = barrier2.dstStageMask,
+				.read_access       = barrier2.dstAccessMask,
+				.pending_stages    = barrier2.dstStageMask,
+				.pending_access    = barrier2.dstAccessMask,
+				.pending_recording = recording_id,
+				.pending_action    = action_index,
+			},
+		};
+	});
 }
 
 void Command::Barrier(vk::Buffer const& buf, BufferBarrier const& barrier) {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers must not declare accesses or barriers");
 	vk::BufferMemoryBarrier2 barrier2 {
 		.pNext               = nullptr,
 		.srcStageMask        = barrier.memoryBarrier.srcStageMask,
@@ -253,17 +456,11 @@ void Command::Barrier(vk::Buffer const& buf, BufferBarrier const& barrier) {
 		.offset              = barrier.offset,
 		.size                = barrier.size
 	};
-
-	vk::DependencyInfo dependency = {
-		.pNext                    = nullptr,
-		.dependencyFlags          = {},
-		.bufferMemoryBarrierCount = 1,
-		.pBufferMemoryBarriers    = &barrier2,
-	};
-	pipelineBarrier2(&dependency);
+	AddBarrier(barrier2);
 }
 
 void Command::Barrier(MemoryBarrier const& barrier) {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers must not declare accesses or barriers");
 	vk::MemoryBarrier2 barrier2 = {
 		.pNext         = nullptr,
 		.srcStageMask  = (vk::PipelineStageFlags2) barrier.srcStageMask,
@@ -271,33 +468,161 @@ void Command::Barrier(MemoryBarrier const& barrier) {
 		.dstStageMask  = (vk::PipelineStageFlags2) barrier.dstStageMask,
 		.dstAccessMask = (vk::AccessFlags2)        barrier.dstAccessMask
 	};
+
+	auto& pending = pending_barriers;
+	if (pending.memory_count == pending.memory.size()) {
+		RecordBarriers();
+	}
+	pending.memory[pending.memory_count++] = barrier2;
+}
+
+void Command::AddBarrier(vk::ImageMemoryBarrier2 const& barrier) {
+	// Barriers of one batch are not ordered, so layout transitions of the same image go to different batches
+	auto& pending = pending_barriers;
+	for (u32 i = 0; i < pending.image_count; ++i) {
+		if (pending.images[i].image == barrier.image &&
+			RangesOverlap(pending.images[i].subresourceRange, barrier.subresourceRange)) {
+			RecordBarriers();
+			break;
+		}
+	}
+	if (pending.image_count == pending.images.size()) {
+		RecordBarriers();
+	}
+	pending.images[pending.image_count++] = barrier;
+}
+
+void Command::AddBarrier(vk::BufferMemoryBarrier2 const& barrier) {
+	auto& pending = pending_barriers;
+	if (pending.buffer_count == pending.buffers.size()) {
+		RecordBarriers();
+	}
+	pending.buffers[pending.buffer_count++] = barrier;
+}
+
+void Command::Access(Buffer const& buffer, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access) {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers must not declare accesses or barriers");
+	MemoryBarrier scopes;
+	if (!InferBarrier(buffer.access_state, stages, access, false, recording_id, action_index, scopes)) {
+		return;
+	}
+	AddBarrier(vk::BufferMemoryBarrier2{
+		.srcStageMask        = scopes.srcStageMask,
+		.srcAccessMask       = scopes.srcAccessMask,
+		.dstStageMask        = scopes.dstStageMask,
+		.dstAccessMask       = scopes.dstAccessMask,
+		.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.buffer              = buffer,
+		.offset              = 0,
+		.size                = vk::WholeSize,
+	});
+}
+
+void Command::Access(Image& image, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout,
+					 vk::ImageSubresourceRange const& range) {
+	AccessImage(image, range, stages, access, layout);
+}
+
+void Command::AccessImage(Image const& image, vk::ImageSubresourceRange const& range, vk::PipelineStageFlags2 stages,
+						  vk::AccessFlags2 access, vk::ImageLayout new_layout) {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers must not declare accesses or barriers");
+	UpdateImageState(image, ResolveRange(image, range), [&](vk::ImageSubresourceRange const& run, SubresourceState state) {
+		vk::ImageLayout const layout = new_layout == vk::ImageLayout::eUndefined ? state.layout : new_layout;
+		MemoryBarrier         scopes;
+		if (InferBarrier(state.access, stages, access, layout != state.layout, recording_id, action_index, scopes)) {
+			AddBarrier(vk::ImageMemoryBarrier2{
+				.srcStageMask        = scopes.srcStageMask,
+				.srcAccessMask       = scopes.srcAccessMask,
+				.dstStageMask        = scopes.dstStageMask,
+				.dstAccessMask       = scopes.dstAccessMask,
+				.oldLayout           = state.layout,
+				.newLayout           = layout,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image               = image,
+				.subresourceRange    = run,
+			});
+		}
+		state.layout = layout;
+		return state;
+	});
+}
+
+void Command::ContinuePendingScope(Buffer const& buffer) {
+	if (buffer.access_state.pending_recording == recording_id) {
+		buffer.access_state.pending_action = action_index;
+	}
+}
+
+void Command::ContinuePendingScope(Image const& image) {
+	UpdateImageState(image, ResolveRange(image, defaults::kAllSubresources),
+					 [&](vk::ImageSubresourceRange const&, SubresourceState state) {
+		if (state.access.pending_recording == recording_id) {
+			state.access.pending_action = action_index;
+		}
+		return state;
+	});
+}
+
+void Command::FlushBarriers() {
+	// Called before each action command, pending scopes of earlier barriers end here
+	++action_index;
+	RecordBarriers();
+}
+
+auto Command::HasPendingBarriers() const -> bool {
+	auto const& pending = pending_barriers;
+	return pending.memory_count + pending.buffer_count + pending.image_count != 0;
+}
+
+void Command::RecordBarriers() {
+	auto& pending = pending_barriers;
+	if (!HasPendingBarriers()) {
+		return;
+	}
 	vk::DependencyInfo dependency = {
-		.memoryBarrierCount = 1,
-		.pMemoryBarriers = &barrier2,
+		.pNext                    = nullptr,
+		.dependencyFlags          = {},
+		.memoryBarrierCount       = pending.memory_count,
+		.pMemoryBarriers          = pending.memory.data(),
+		.bufferMemoryBarrierCount = pending.buffer_count,
+		.pBufferMemoryBarriers    = pending.buffers.data(),
+		.imageMemoryBarrierCount  = pending.image_count,
+		.pImageMemoryBarriers     = pending.images.data(),
 	};
 	pipelineBarrier2(&dependency);
+	++barrier_stats.dependencies;
+	barrier_stats.memory_barriers += pending.memory_count;
+	barrier_stats.buffer_barriers += pending.buffer_count;
+	barrier_stats.image_barriers  += pending.image_count;
+	pending.memory_count = 0;
+	pending.buffer_count = 0;
+	pending.image_count  = 0;
 }
 
-void Command::ClearColorImage(Image const& img, vk::ClearColorValue const& color) {
-	vk::ClearColorValue clearColor{{{color.float32[0], color.float32[1], color.float32[2], color.float32[3]}}};
-	vk::ImageSubresourceRange range = {
-		.aspectMask = (vk::ImageAspectFlags)img.GetAspect(),
-		.baseMipLevel = 0,
-		.levelCount = vk::RemainingMipLevels,
-		.baseArrayLayer = 0,
-		.layerCount = vk::RemainingArrayLayers,
-	};
-
-	clearColorImage(img,
-		(vk::ImageLayout)img.GetLayout(), &clearColor, 1, &range);
+void Command::ClearColorImage(Image const& img, vk::ClearColorValue const& color,
+							  vk::ImageSubresourceRange const& range) {
+	AccessImage(img, range, vk::PipelineStageFlagBits2::eClear, vk::AccessFlagBits2::eTransferWrite);
+	FlushBarriers();
+	// State is left as is, update only visits runs of subresources with their layouts
+	UpdateImageState(img, ResolveRange(img, range), [&](vk::ImageSubresourceRange const& run, SubresourceState const& state) {
+		clearColorImage(img, state.layout, &color, 1, &run);
+		return state;
+	});
 }
 
 void Command::Blit(BlitInfo const& info) {
+	AccessImage(info.src, RangeFromLayers(info.src_subresource), vk::PipelineStageFlagBits2::eBlit,
+				vk::AccessFlagBits2::eTransferRead);
+	AccessImage(info.dst, RangeFromLayers(info.dst_subresource), vk::PipelineStageFlagBits2::eBlit,
+				vk::AccessFlagBits2::eTransferWrite);
+	FlushBarriers();
 	auto regions = info.regions;
 
 	ImageBlit const fullRegions[] = {{
-		{{0, 0, 0}, Offset3DFromExtent3D(info.dst.GetExtent())},
-		{{0, 0, 0}, Offset3DFromExtent3D(info.src.GetExtent())}
+		{{0, 0, 0}, Offset3DFromExtent3D(GetMipExtent(info.dst.GetExtent(), info.dst_subresource.mipLevel))},
+		{{0, 0, 0}, Offset3DFromExtent3D(GetMipExtent(info.src.GetExtent(), info.src_subresource.mipLevel))}
 	}};
 
 	if (regions.empty()) {
@@ -308,19 +633,9 @@ void Command::Blit(BlitInfo const& info) {
 	for (auto i = 0; auto& region: regions) {
 		blitRegions[i] = {
 			.pNext = nullptr,
-			.srcSubresource{
-				.aspectMask     = vk::ImageAspectFlagBits::eColor,
-				.mipLevel       = 0,
-				.baseArrayLayer = 0,
-				.layerCount     = 1,
-			},
+			.srcSubresource = info.src_subresource,
 			.srcOffsets = {{region.src.offset, region.src.extent}},
-			.dstSubresource{
-				.aspectMask     = vk::ImageAspectFlagBits::eColor,
-				.mipLevel       = 0,
-				.baseArrayLayer = 0,
-				.layerCount     = 1,
-			},
+			.dstSubresource = info.dst_subresource,
 			.dstOffsets = {{region.dst.offset, region.dst.extent}},
 		};
 		++i;
@@ -329,9 +644,9 @@ void Command::Blit(BlitInfo const& info) {
 	vk::BlitImageInfo2 blitInfo {
 		.pNext          = nullptr,
 		.srcImage       = info.src,
-		.srcImageLayout = info.src.GetLayout(),
+		.srcImageLayout = info.src.GetLayout(info.src_subresource.mipLevel, info.src_subresource.baseArrayLayer),
 		.dstImage       = info.dst,
-		.dstImageLayout = info.dst.GetLayout(),
+		.dstImageLayout = info.dst.GetLayout(info.dst_subresource.mipLevel, info.dst_subresource.baseArrayLayer),
 		.regionCount    = static_cast<u32>(blitRegions.size()),
 		.pRegions       = blitRegions.data(),
 		.filter         = info.filter,
@@ -340,7 +655,55 @@ void Command::Blit(BlitInfo const& info) {
 	blitImage2(&blitInfo);
 }
 
-void Command::BeginRendering(RenderingInfo const& info) {
+void Command::GenerateMipmaps(Image& image, vk::Filter filter) {
+	vk::ImageAspectFlags const aspect = image.GetAspect();
+	u32 const                  layers = image.GetArrayLayers();
+	for (u32 mip = 1; mip < image.GetMipLevels(); ++mip) {
+		// Previous level was written by the last blit, only it and this level are transitioned
+		Access(image, vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferRead,
+			   vk::ImageLayout::eTransferSrcOptimal, {aspect, mip - 1, 1, 0, layers});
+		Access(image, vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferWrite,
+			   vk::ImageLayout::eTransferDstOptimal, {aspect, mip, 1, 0, layers});
+		Blit({
+			.dst             = image,
+			.src             = image,
+			.filter          = filter,
+			.dst_subresource = {aspect, mip, 0, layers},
+			.src_subresource = {aspect, mip - 1, 0, layers},
+		});
+	}
+	if (image.GetMipLevels() > 1) {
+		u32 const last = image.GetMipLevels() - 1;
+		Access(image, vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferRead,
+			   vk::ImageLayout::eTransferSrcOptimal, {aspect, last, 1, 0, layers});
+	}
+}
+
+void Command::BeginRendering(RenderingInfo const& info, vk::RenderingFlags flags) {
+	// Attachments are accessed in their current layouts
+	for (auto const& attachment : info.color_attachments) {
+		vk::AccessFlags2 access = vk::AccessFlagBits2::eColorAttachmentWrite;
+		if (attachment.load_op == vk::AttachmentLoadOp::eLoad) {
+			access |= vk::AccessFlagBits2::eColorAttachmentRead;
+		}
+		AccessImage(attachment.color_image, defaults::kAllSubresources,
+					vk::PipelineStageFlagBits2::eColorAttachmentOutput, access);
+		if (attachment.resolve_image) {
+			AccessImage(attachment.resolve_image, defaults::kAllSubresources,
+						vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite);
+		}
+	}
+	for (auto const* attachment : {&info.depth, &info.stencil}) {
+		// Combined depth stencil image is accessed once
+		bool const same_as_depth = attachment == &info.stencil && info.depth.image &&
+								   static_cast<vk::Image const&>(info.stencil.image) == info.depth.image;
+		if (attachment->image && !same_as_depth) {
+			AccessImage(attachment->image, defaults::kAllSubresources,
+						vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+						vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite);
+		}
+	}
+	FlushBarriers();
 	// auto& clearColor = info.clearColor;
 	// auto& clearDepth = info.clearDepth;
 	// auto& clearStencil = info.clearStencil;
@@ -376,7 +739,7 @@ void Command::BeginRendering(RenderingInfo const& info) {
 	}
 
 	vk::RenderingInfoKHR renderingInfo{
-		.flags = {},
+		.flags = flags,
 		.renderArea = {
 			.offset = offset,
 			.extent = extent,
@@ -419,6 +782,7 @@ void Command::BeginRendering(RenderingInfo const& info) {
 		renderingInfo.pStencilAttachment = &stencilAttachInfo;
 	}
 	beginRendering(&renderingInfo);
+	in_rendering = true;
 }
 
 void Command::SetViewport(Viewport const& viewport) {
@@ -430,6 +794,16 @@ void Command::SetViewport(Viewport const& viewport) {
 		.minDepth = viewport.minDepth,
 		.maxDepth = viewport.maxDepth,
 	};
+	if (bound_state.has_viewport && bound_state.viewport == vkViewport) {
+		++state_stats.viewports;
+		return;
+	}
+	bound_state.has_viewport = true;
+	bound_state.viewport     = vkViewport;
+	if (shader_objects_bound) {
+		setViewportWithCount(1, &vkViewport);
+		return;
+	}
 	setViewport(0, 1, &vkViewport);
 }
 
@@ -441,114 +815,487 @@ void Command::SetScissor(vk::Rect2D const& scissor) {
 			.height = scissor.extent.height
 		}
 	};
+	if (bound_state.has_scissor && bound_state.scissor == vkScissor) {
+		++state_stats.scissors;
+		return;
+	}
+	bound_state.has_scissor = true;
+	bound_state.scissor     = vkScissor;
+	if (shader_objects_bound) {
+		setScissorWithCount(1, &vkScissor);
+		return;
+	}
 	setScissor(0, 1, &vkScissor);
 }
 
 void Command::EndRendering() {
 	endRendering();
+	in_rendering = false;
+	// Accesses declared inside the rendering scope are synchronized outside of it
+	RecordBarriers();
+}
+
+void Command::RenderParallel(RenderingInfo const& info, CommandAllocator& allocator, std::size_t count,
+							 std::function<void(Command& cmd, std::size_t begin, std::size_t end)> const& record) {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffers are executed by a primary one");
+	// Pools of the secondaries are reset after the tickets of primaries of the same allocator frame
+	VB_ASSERT(command_allocator == &allocator, "Primary command buffer must come from allocator");
+	VB_VLA(vk::Format, color_formats, info.color_attachments.size());
+	for (auto [i, attachment] : util::enumerate(info.color_attachments)) {
+		color_formats[i] = attachment.color_image.GetFormat();
+	}
+	vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+	if (info.color_attachments.size() > 0) {
+		samples = info.color_attachments[0].color_image.GetSamples();
+	} else if (info.depth.image) {
+		samples = info.depth.image.GetSamples();
+	} else if (info.stencil.image) {
+		samples = info.stencil.image.GetSamples();
+	}
+	vk::CommandBufferInheritanceRenderingInfo const rendering_inheritance{
+		.colorAttachmentCount    = static_cast<u32>(info.color_attachments.size()),
+		.pColorAttachmentFormats = color_formats.data(),
+		.depthAttachmentFormat   = info.depth.image ? info.depth.image.GetFormat() : vk::Format::eUndefined,
+		.stencilAttachmentFormat = info.stencil.image ? info.stencil.image.GetFormat() : vk::Format::eUndefined,
+		.rasterizationSamples    = samples,
+	};
+	vk::CommandBufferInheritanceInfo const inheritance{.pNext = &rendering_inheritance};
+
+	BeginRendering(info, vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+
+	// Range begin and its buffer, ranges finish in any order
+	std::vector<std::pair<std::size_t, vk::CommandBuffer>> recorded;
+	std::mutex                                              mutex;
+	GetDevice().GetThreadPool().ParallelFor(count, [&](std::size_t begin, std::size_t end) {
+		Command& secondary = allocator.AllocateSecondary(queue_family);
+		secondary.Begin(inheritance);
+		record(secondary, begin, end);
+		secondary.End();
+		std::lock_guard lock(mutex);
+		recorded.emplace_back(begin, secondary);
+	});
+	std::sort(recorded.begin(), recorded.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+	VB_VLA(vk::CommandBuffer, command_buffers, recorded.size());
+	for (auto [i, range] : util::enumerate(recorded)) {
+		command_buffers[i] = range.second;
+	}
+	if (!recorded.empty()) {
+		executeCommands(static_cast<u32>(recorded.size()), command_buffers.data());
+	}
+	// State of the primary is undefined after executing secondary buffers
+	InvalidateState();
+	EndRendering();
+}
+
+bool Command::TrackPipeline(vk::PipelineBindPoint point, vk::Pipeline pipeline) {
+	int const index = GetBindPointIndex(point);
+	if (index < 0) {
+		return true;
+	}
+	if (bound_state.pipelines[index] == pipeline) {
+		++state_stats.pipeline_binds;
+		return false;
+	}
+	bound_state.pipelines[index] = pipeline;
+	if (point == vk::PipelineBindPoint::eGraphics) {
+		// Static state of new pipeline overrides dynamic viewport and scissor
+		bound_state.has_viewport = false;
+		bound_state.has_scissor  = false;
+	}
+	return true;
+}
+
+bool Command::TrackDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout, u64 compatibility,
+								 vk::DescriptorSet set) {
+	int const index = GetBindPointIndex(point);
+	if (index < 0) {
+		return true;
+	}
+	vk::PipelineLayout& bound_layout        = bound_state.descriptor_layouts[index];
+	vk::DescriptorSet&  bound_set           = bound_state.descriptor_sets[index];
+	u64&                bound_compatibility = bound_state.descriptor_compatibility[index];
+	if (layout == bound_layout) {
+		compatibility = bound_compatibility;
+	} else if (compatibility == 0) {
+		compatibility = GetDevice().GetPipelineLayoutCompatibility(layout);
+	}
+	// Set bound with a compatible layout stays valid for the new one
+	if (bound_set == set && (bound_layout == layout || (compatibility != 0 && compatibility == bound_compatibility))) {
+		++state_stats.descriptor_set_binds;
+		return false;
+	}
+	bound_layout        = layout;
+	bound_set           = set;
+	bound_compatibility = compatibility;
+	return true;
+}
+
+bool Command::TrackPushConstants(vk::PipelineLayout layout, void const* data, u32 size) {
+	if (size > BoundState::kMaxPushConstantsSize) {
+		bound_state.push_constants_layout = nullptr;
+		return true;
+	}
+	if (bound_state.push_constants_layout == layout && bound_state.push_constants_size == size &&
+		std::memcmp(bound_state.push_constants.data(), data, size) == 0) {
+		++state_stats.push_constants;
+		return false;
+	}
+	bound_state.push_constants_layout = layout;
+	bound_state.push_constants_size   = size;
+	std::memcpy(bound_state.push_constants.data(), data, size);
+	return true;
+}
+
+void Command::InvalidateState() {
+	bound_state = {};
 }
 
 void Command::BindPipeline(Pipeline const& pipeline) {
-	bindPipeline(pipeline.GetBindPoint(), pipeline);
+	if (!TrackPipeline(pipeline.GetBindPoint(), pipeline.GetHandle())) {
+		return;
+	}
+	bindPipeline(pipeline.GetBindPoint(), pipeline.GetHandle());
+	shader_objects_bound = false;
+	// Push constants set with an incompatible layout are undefined after bind
+	if (bound_state.push_constants_layout != pipeline.GetLayout()) {
+		bound_state.push_constants_layout = nullptr;
+	}
 }
 
 void Command::BindPipelineAndDescriptorSet(Pipeline const& pipeline, vk::DescriptorSet const& descriptor_set) {
-	bindPipeline(pipeline.GetBindPoint(), pipeline);
-	// TODO(nm): bind only if not compatible for used descriptor sets or push constant range
-	// ref: https://registry.khronos.org/vulkan/specs/1.2-extensions/html/vkspec.html#descriptorsets-compatibility
-	bindDescriptorSets(pipeline.GetBindPoint(), pipeline.GetLayout(), 0, 1, &descriptor_set, 0, nullptr);
-	// Vulkan 1.4 or VK_KHR_maintenance6
-	// vk::BindDescriptorSetsInfo{}
-	// bindDescriptorSets2()
+	BindPipeline(pipeline);
+	BindDescriptorSet(pipeline.GetBindPoint(), pipeline.GetLayout(), pipeline.layout_compatibility, descriptor_set);
 }
 
 void Command::PushConstants(Pipeline const& pipeline, void const* data, u32 size) {
-	pushConstants(pipeline.GetLayout(), vk::ShaderStageFlagBits::eAll, 0, size, data);
+	PushConstants(pipeline.GetLayout(), data, size);
+}
+
+void Command::BindShaders(std::span<ShaderObject const* const> shaders) {
+	// Graphics stages that are unbound if not given
+	vk::ShaderStageFlagBits constexpr kGraphicsStages[] = {
+		vk::ShaderStageFlagBits::eVertex,
+		vk::ShaderStageFlagBits::eTessellationControl,
+		vk::ShaderStageFlagBits::eTessellationEvaluation,
+		vk::ShaderStageFlagBits::eGeometry,
+		vk::ShaderStageFlagBits::eFragment,
+	};
+	VB_VLA(vk::ShaderStageFlagBits, stages, shaders.size() + std::size(kGraphicsStages));
+	VB_VLA(vk::ShaderEXT, handles, shaders.size() + std::size(kGraphicsStages));
+	u32 count = 0;
+	vk::ShaderStageFlags bound_stages;
+	for (auto const* shader : shaders) {
+		stages[count]    = shader->GetStage();
+		handles[count++] = shader->GetHandle();
+		bound_stages |= shader->GetStage();
+	}
+	if (bound_stages & vk::ShaderStageFlagBits::eAllGraphics) {
+		for (auto stage : kGraphicsStages) {
+			if (!(bound_stages & stage)) {
+				stages[count]    = stage;
+				handles[count++] = vk::ShaderEXT{};
+			}
+		}
+	}
+	bindShadersEXT(count, stages.data(), handles.data());
+	shader_objects_bound = true;
+
+	// Shaders replace bound pipelines, viewport and scissor are now set with count
+	for (auto& pipeline : bound_state.pipelines) {
+		pipeline = nullptr;
+	}
+	bound_state.push_constants_layout = nullptr;
+	bound_state.has_viewport          = false;
+	bound_state.has_scissor           = false;
+}
+
+void Command::BindShader(ShaderObject const& shader) {
+	ShaderObject const* shaders[] = {&shader};
+	BindShaders(shaders);
+}
+
+void Command::SetGraphicsState(GraphicsPipelineInfo const& info) {
+	// Vertex input
+	VB_VLA(vk::VertexInputAttributeDescription, attributes, info.vertex_attributes.size());
+	u32 stride = 0;
+	CreateVertexDescriptionsFromAttributes(info.vertex_attributes, attributes.data(), &stride);
+	VB_VLA(vk::VertexInputAttributeDescription2EXT, attributes2, info.vertex_attributes.size());
+	for (std::size_t i = 0; i < info.vertex_attributes.size(); ++i) {
+		attributes2[i] = vk::VertexInputAttributeDescription2EXT{
+			.location = attributes[i].location,
+			.binding  = attributes[i].binding,
+			.format   = attributes[i].format,
+			.offset   = attributes[i].offset,
+		};
+	}
+	vk::VertexInputBindingDescription2EXT binding{
+		.binding   = 0,
+		.stride    = stride,
+		.inputRate = vk::VertexInputRate::eVertex,
+		.divisor   = 1,
+	};
+	u32 const attribute_count = static_cast<u32>(info.vertex_attributes.size());
+	setVertexInputEXT(attribute_count > 0 ? 1 : 0, &binding, attribute_count, attributes2.data());
+
+	// Input assembly and tessellation
+	setPrimitiveTopology(info.input_assembly.topology);
+	setPrimitiveRestartEnable(info.input_assembly.primitiveRestartEnable);
+	if (info.tessellation) {
+		setPatchControlPointsEXT(info.tessellation->patchControlPoints);
+		setTessellationDomainOriginEXT(vk::TessellationDomainOrigin::eUpperLeft);
+	}
+
+	// Viewports and scissors given in info, otherwise they are set with SetViewport() and SetScissor()
+	if (info.viewport.pViewports) {
+		setViewportWithCount(info.viewport.viewportCount, info.viewport.pViewports);
+		bound_state.has_viewport = false;
+	}
+	if (info.viewport.pScissors) {
+		setScissorWithCount(info.viewport.scissorCount, info.viewport.pScissors);
+		bound_state.has_scissor = false;
+	}
+
+	// Rasterization
+	auto const& rasterization = info.rasterization;
+	setDepthClampEnableEXT(rasterization.depthClampEnable);
+	setRasterizerDiscardEnable(rasterization.rasterizerDiscardEnable);
+	setPolygonModeEXT(rasterization.polygonMode);
+	setCullMode(rasterization.cullMode);
+	setFrontFace(rasterization.frontFace);
+	setDepthBiasEnable(rasterization.depthBiasEnable);
+	if (rasterization.depthBiasEnable) {
+		setDepthBias(rasterization.depthBiasConstantFactor, rasterization.depthBiasClamp,
+					 rasterization.depthBiasSlopeFactor);
+	}
+	setLineWidth(rasterization.lineWidth);
+
+	// Multisample
+	auto const& multisample = info.multisample;
+	vk::SampleMask const all_samples[2] = {~0u, ~0u};
+	setRasterizationSamplesEXT(multisample.rasterizationSamples);
+	setSampleMaskEXT(multisample.rasterizationSamples, multisample.pSampleMask ? multisample.pSampleMask : all_samples);
+	setAlphaToCoverageEnableEXT(multisample.alphaToCoverageEnable);
+
+	// Depth and stencil
+	auto const& depth_stencil = info.depth_stencil;
+	setDepthTestEnable(depth_stencil.depthTestEnable);
+	setDepthWriteEnable(depth_stencil.depthWriteEnable);
+	setDepthCompareOp(depth_stencil.depthCompareOp);
+	setDepthBoundsTestEnable(depth_stencil.depthBoundsTestEnable);
+	if (depth_stencil.depthBoundsTestEnable) {
+		setDepthBounds(depth_stencil.minDepthBounds, depth_stencil.maxDepthBounds);
+	}
+	setStencilTestEnable(depth_stencil.stencilTestEnable);
+	if (depth_stencil.stencilTestEnable) {
+		for (auto [face, state] : {std::pair{vk::StencilFaceFlagBits::eFront, depth_stencil.front},
+								   std::pair{vk::StencilFaceFlagBits::eBack, depth_stencil.back}}) {
+			setStencilOp(face, state.failOp, state.passOp, state.depthFailOp, state.compareOp);
+			setStencilCompareMask(face, state.compareMask);
+			setStencilWriteMask(face, state.writeMask);
+			setStencilReference(face, state.reference);
+		}
+	}
+
+	// Color blend, filled like in GraphicsPipelineCreateState::Fill()
+	std::size_t const attachment_count =
+		info.color_formats.empty() ? info.blend_attachments.size() : info.color_formats.size();
+	VB_VLA(vk::Bool32, blend_enables, attachment_count);
+	VB_VLA(vk::ColorBlendEquationEXT, equations, attachment_count);
+	VB_VLA(vk::ColorComponentFlags, write_masks, attachment_count);
+	for (std::size_t i = 0; i < attachment_count; ++i) {
+		auto const& attachment =
+			i < info.blend_attachments.size() ? info.blend_attachments[i] : defaults::kBlendAttachment;
+		blend_enables[i] = attachment.blendEnable;
+		equations[i]     = vk::ColorBlendEquationEXT{
+				.srcColorBlendFactor = attachment.srcColorBlendFactor,
+				.dstColorBlendFactor = attachment.dstColorBlendFactor,
+				.colorBlendOp        = attachment.colorBlendOp,
+				.srcAlphaBlendFactor = attachment.srcAlphaBlendFactor,
+				.dstAlphaBlendFactor = attachment.dstAlphaBlendFactor,
+				.alphaBlendOp        = attachment.alphaBlendOp,
+		};
+		write_masks[i] = attachment.colorWriteMask;
+	}
+	setLogicOpEnableEXT(info.color_blend.logicOpEnable);
+	if (info.color_blend.logicOpEnable) {
+		setLogicOpEXT(info.color_blend.logicOp);
+	}
+	if (attachment_count > 0) {
+		u32 const count = static_cast<u32>(attachment_count);
+		setColorBlendEnableEXT(0, count, blend_enables.data());
+		setColorBlendEquationEXT(0, count, equations.data());
+		setColorWriteMaskEXT(0, count, write_masks.data());
+	}
+	setBlendConstants(info.color_blend.blendConstants.data());
+}
+
+void Command::BindDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout,
+								vk::DescriptorSet const& descriptor_set) {
+	BindDescriptorSet(point, layout, 0, descriptor_set);
+}
+
+void Command::BindDescriptorSet(vk::PipelineBindPoint point, vk::PipelineLayout layout, u64 compatibility,
+								vk::DescriptorSet const& descriptor_set) {
+	// ref: https://registry.khronos.org/vulkan/specs/1.2-extensions/html/vkspec.html#descriptorsets-compatibility
+	if (!TrackDescriptorSet(point, layout, compatibility, descriptor_set)) {
+		return;
+	}
+#ifdef VK_KHR_maintenance6
+	// Stages select bind point, other bind points use vkCmdBindDescriptorSets
+	if (GetDevice().IsMaintenance6Enabled() && GetBindPointIndex(point) >= 0) {
+		vk::BindDescriptorSetsInfoKHR info{
+			.stageFlags         = point == vk::PipelineBindPoint::eCompute ? vk::ShaderStageFlagBits::eCompute
+																		   : vk::ShaderStageFlagBits::eAllGraphics,
+			.layout             = layout,
+			.firstSet           = 0,
+			.descriptorSetCount = 1,
+			.pDescriptorSets    = &descriptor_set,
+		};
+		bindDescriptorSets2KHR(&info);
+		return;
+	}
+#endif
+	bindDescriptorSets(point, layout, 0, 1, &descriptor_set, 0, nullptr);
+}
+
+void Command::PushConstants(vk::PipelineLayout layout, void const* data, u32 size) {
+	if (!TrackPushConstants(layout, data, size)) {
+		return;
+	}
+	pushConstants(layout, vk::ShaderStageFlagBits::eAll, 0, size, data);
 }
 
 void Command::BindVertexBuffer(Buffer const& vertex_buffer) {
+	if (bound_state.vertex_buffer == vertex_buffer) {
+		++state_stats.vertex_buffer_binds;
+		return;
+	}
+	bound_state.vertex_buffer = vertex_buffer;
 	vk::DeviceSize offsets[] = { 0 };
 	bindVertexBuffers(0, 1, &vertex_buffer, offsets);
 }
 
 void Command::BindIndexBuffer(Buffer const& index_buffer) {
+	if (bound_state.index_buffer == index_buffer) {
+		++state_stats.index_buffer_binds;
+		return;
+	}
+	bound_state.index_buffer = index_buffer;
 	bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32);
 }
 
 void Command::Draw(u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) {
+	// Barriers can not be recorded inside rendering scope, accesses are declared before BeginRendering()
+	VB_ASSERT(!in_rendering || !HasPendingBarriers(), "Access declared inside rendering scope");
+	FlushBarriers();
 	// VB_LOG_TRACE("CmdDraw(%u,%u,%u,%u)", vertex_count, instance_count, first_vertex, first_instance);
 	draw(vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void Command::DrawIndexed(u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance) {
+	VB_ASSERT(!in_rendering || !HasPendingBarriers(), "Access declared inside rendering scope");
+	FlushBarriers();
 	// VB_LOG_TRACE("CmdDrawIndexed(%u,%u,%u,%u,%u)", index_count, instance_count, first_index, vertex_offset, first_instance);
 	drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void Command::DrawMesh(Buffer const& vertex_buffer, Buffer const& index_buffer, u32 index_count) {
-	vk::DeviceSize offsets[] = { 0 };
-	bindVertexBuffers(0, 1, &vertex_buffer, offsets);
-	bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32);
+	VB_ASSERT(!in_rendering || !HasPendingBarriers(), "Access declared inside rendering scope");
+	FlushBarriers();
+	BindVertexBuffer(vertex_buffer);
+	BindIndexBuffer(index_buffer);
 	drawIndexed(index_count, 1, 0, 0, 0);
 }
 
 void Command::Dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ) {
+	FlushBarriers();
 	dispatch(groupCountX, groupCountY, groupCountZ);
 }
 
-// vkWaitForFences + vkResetFences +
-// vkResetCommandPool + vkBeginCommandBuffer
+void Command::Dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ, std::span<BufferAccess const> buffers,
+					   std::span<ImageAccess const> images) {
+	for (auto const& use : buffers) {
+		Access(use.buffer, vk::PipelineStageFlagBits2::eComputeShader, use.access);
+	}
+	for (auto const& use : images) {
+		Access(use.image, vk::PipelineStageFlagBits2::eComputeShader, use.access, use.layout, use.range);
+	}
+	Dispatch(groupCountX, groupCountY, groupCountZ);
+}
+
+// Wait for last ticket (no driver call if already seen complete) +
+// vkResetCommandPool (own pool only) + vkBeginCommandBuffer, resets bound state
 void Command::Begin() {
+	VB_ASSERT(level == vk::CommandBufferLevel::ePrimary, "Secondary command buffer needs inheritance info");
+	Wait();
 	VB_VK_RESULT result;
-	result = GetDevice().waitForFences(1, &fence, vk::True, std::numeric_limits<u64>::max());
-	VB_CHECK_VK_RESULT(result, "Failed to wait for fence");
-	result = GetDevice().resetFences(1, &fence);
-	VB_CHECK_VK_RESULT(result, "Failed to reset fence");
-
-	// ?VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT
-	result = GetDevice().resetCommandPool(pool, vk::CommandPoolResetFlags{});
-	VB_CHECK_VK_RESULT(result, "Failed to reset command pool");
+
+	// Pools of CommandAllocator are reset by it when their frame is recycled
+	if (pool) {
+		// ?VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT
+		result = GetDevice().resetCommandPool(pool, vk::CommandPoolResetFlags{});
+		VB_CHECK_VK_RESULT(result, "Failed to reset command pool");
+	}
 	vk::CommandBufferBeginInfo beginInfo{};
 	beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 	result = begin(&beginInfo);
 	VB_CHECK_VK_RESULT(result, "Failed to begin command buffer");
+	ResetState();
+}
+
+void Command::Begin(vk::CommandBufferInheritanceInfo const& inheritance) {
+	VB_ASSERT(level == vk::CommandBufferLevel::eSecondary, "Inheritance info is only used by secondary buffers");
+	vk::CommandBufferBeginInfo beginInfo{
+		.flags            = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+		.pInheritanceInfo = &inheritance,
+	};
+	// Continue render pass or dynamic rendering instance of the primary buffer
+	bool inherits_rendering = static_cast<bool>(inheritance.renderPass);
+	for (auto next = static_cast<vk::BaseInStructure const*>(inheritance.pNext); next; next = next->pNext) {
+		inherits_rendering |= next->sType == vk::StructureType::eCommandBufferInheritanceRenderingInfo;
+	}
+	if (inherits_rendering) {
+		beginInfo.flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+	}
+	VB_VK_RESULT result = begin(&beginInfo);
+	VB_CHECK_VK_RESULT(result, "Failed to begin secondary command buffer");
+	ResetState();
+}
+
+void Command::ResetState() {
+	recording_id = next_recording_id.fetch_add(1, std::memory_order_relaxed);
+	action_index = 0;
+	shader_objects_bound = false;
+	in_rendering = false;
+	InvalidateState();
+	pending_barriers.memory_count = 0;
+	pending_barriers.buffer_count = 0;
+	pending_barriers.image_count  = 0;
 }
 
 void Command::End() {
+	FlushBarriers();
 	VB_VK_RESULT result = end();
 	VB_CHECK_VK_RESULT(result, "Failed to end command buffer");
 }
 
-void Command::Submit(vk::Queue const& queue, SubmitInfo const& info) {
-
+auto Command::Submit(Queue const& queue, SubmitInfo const& info) -> SubmitTicket {
 	vk::CommandBufferSubmitInfo cmdInfo {
 		.commandBuffer = *this,
 	};
-
-	vk::SubmitInfo2 submitInfo {
-		.waitSemaphoreInfoCount = static_cast<u32>(info.waitSemaphoreInfos.size()),
-		.pWaitSemaphoreInfos = reinterpret_cast<vk::SemaphoreSubmitInfo const*>(info.waitSemaphoreInfos.data()),
-		.commandBufferInfoCount = 1,
-		.pCommandBufferInfos = &cmdInfo,
-		.signalSemaphoreInfoCount = static_cast<u32>(info.signalSemaphoreInfos.size()),
-		.pSignalSemaphoreInfos = reinterpret_cast<vk::SemaphoreSubmitInfo const*>(info.signalSemaphoreInfos.data()),
-	};
-
-	auto result = queue.submit2(1, &submitInfo, fence);
-	VB_CHECK_VK_RESULT(result, "Failed to submit command buffer");
-
-	// Commented code can be slower
-	// queue.Submit(
-	// 	{{{.commandBuffer = *this}}},
-	// 	fence, {
-	// 		.waitSemaphoreInfos = info.waitSemaphoreInfos,
-	// 		.signalSemaphoreInfos = info.signalSemaphoreInfos,
-	// 	});
+	ticket = queue.Submit({&cmdInfo, 1}, nullptr, info);
+	return ticket;
 }
 
+auto Command::IsComplete() const -> bool {
+	return !ticket || ticket.queue->IsComplete(ticket);
+}
 
-auto Command::GetFence() const -> vk::Fence {
-	return fence;
+void Command::Wait() const {
+	if (ticket) {
+		ticket.queue->Wait(ticket);
+	}
 }
 
 auto Command::GetResourceTypeName() const -> char const* { return "CommandResource"; }
@@ -557,7 +1304,8 @@ auto Command::GetResourceTypeName() const -> char const* { return "CommandResour
 
 void Command::Free() {
 	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), "Command");
-	GetDevice().destroyCommandPool(pool, GetDevice().GetAllocator());
-	GetDevice().destroyFence(fence, GetDevice().GetAllocator());
+	if (pool) {
+		GetDevice().destroyCommandPool(pool, GetDevice().GetAllocator());
+	}
 }
 } // namespace VB_NAMESPACE
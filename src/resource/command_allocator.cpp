@@ -0,0 +1,173 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/command/command_allocator.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+namespace {
+// Buffers allocated with one allocateCommandBuffers call when a pool runs out
+u32 constexpr kAllocationChunk = 8;
+
+std::atomic<u64> next_allocator_id = 1;
+
+// Last pools used by the thread, skips the locked lookup while a thread keeps using one allocator and family
+struct CachedThreadPools {
+	u64   allocator_id       = 0;
+	u32   queue_family_index = ~0u;
+	void* pools              = nullptr;
+};
+thread_local CachedThreadPools cached_thread_pools;
+} // namespace
+
+CommandAllocator::CommandAllocator(Device& device, CommandAllocatorInfo const& info) { Create(device, info); }
+
+CommandAllocator::~CommandAllocator() { Free(); }
+
+void CommandAllocator::Create(Device& device, CommandAllocatorInfo const& info) {
+	ResourceBase::SetOwner(&device);
+	this->info                  = info;
+	this->info.frames_in_flight = std::max(info.frames_in_flight, 1u);
+	id                          = next_allocator_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto CommandAllocator::GetThreadPools(u32 queue_family_index) -> ThreadPools& {
+	auto& cached = cached_thread_pools;
+	if (cached.allocator_id == id && cached.queue_family_index == queue_family_index) [[likely]] {
+		return *static_cast<ThreadPools*>(cached.pools);
+	}
+
+	std::lock_guard lock(mutex);
+	auto const thread = std::this_thread::get_id();
+	auto       it     = std::find_if(thread_pools.begin(), thread_pools.end(), [&](ThreadPools const& pools) {
+		return pools.thread == thread && pools.queue_family_index == queue_family_index;
+	});
+	if (it == thread_pools.end()) {
+		thread_pools.push_back({.thread = thread, .queue_family_index = queue_family_index});
+		ThreadPools& pools = thread_pools.back();
+		pools.frames.resize(info.frames_in_flight);
+		for (Pool& pool : pools.frames) {
+			vk::CommandPoolCreateInfo const pool_info{
+				.flags            = info.pool_flags,
+				.queueFamilyIndex = queue_family_index,
+			};
+			VB_VK_RESULT result = GetDevice().createCommandPool(&pool_info, GetDevice().GetAllocator(), &pool.pool);
+			VB_CHECK_VK_RESULT(result, "Failed to create command pool!");
+		}
+		it = std::prev(thread_pools.end());
+	}
+	cached = {.allocator_id = id, .queue_family_index = queue_family_index, .pools = &*it};
+	return *it;
+}
+
+auto CommandAllocator::Allocate(u32 queue_family_index, vk::CommandBufferLevel level) -> Command& {
+	Pool& pool	  = GetThreadPools(queue_family_index).frames[frame_index];
+	bool  primary = level == vk::CommandBufferLevel::ePrimary;
+	auto& buffers = primary ? pool.primaries : pool.secondaries;
+	u32&  used	  = primary ? pool.used_primaries : pool.used_secondaries;
+
+	if (used == buffers.size()) {
+		vk::CommandBufferAllocateInfo const alloc_info{
+			.commandPool		= pool.pool,
+			.level				= level,
+			.commandBufferCount = kAllocationChunk,
+		};
+		vk::CommandBuffer command_buffers[kAllocationChunk];
+		VB_VK_RESULT result = GetDevice().allocateCommandBuffers(&alloc_info, command_buffers);
+		VB_CHECK_VK_RESULT(result, "Failed to allocate command buffers!");
+		for (vk::CommandBuffer command_buffer : command_buffers) {
+			buffers.emplace_back(GetDevice(), queue_family_index, command_buffer, level, *this);
+		}
+		(primary ? primary_buffers : secondary_buffers).fetch_add(kAllocationChunk, std::memory_order_relaxed);
+	}
+	return buffers[used++];
+}
+
+auto CommandAllocator::AllocatePrimary(u32 queue_family_index) -> Command& {
+	return Allocate(queue_family_index, vk::CommandBufferLevel::ePrimary);
+}
+
+auto CommandAllocator::AllocateSecondary(u32 queue_family_index) -> Command& {
+	return Allocate(queue_family_index, vk::CommandBufferLevel::eSecondary);
+}
+
+void CommandAllocator::NextFrame() {
+	frame_index = (frame_index + 1) % info.frames_in_flight;
+
+	// Threads registering their first pools are not blocked while waiting for the GPU.
+	// Pools are only used by their own thread and their addresses are stable
+	std::vector<Pool*> used_pools;
+	{
+		std::lock_guard lock(mutex);
+		for (ThreadPools& pools : thread_pools) {
+			Pool& pool = pools.frames[frame_index];
+			if (pool.used_primaries > 0 || pool.used_secondaries > 0) {
+				used_pools.push_back(&pool);
+			}
+		}
+	}
+
+	for (Pool* pool : used_pools) {
+		// Cached completion makes this free for buffers already seen complete
+		for (u32 i = 0; i < pool->used_primaries; ++i) {
+			pool->primaries[i].Wait();
+		}
+		VB_VK_RESULT result = GetDevice().resetCommandPool(pool->pool, vk::CommandPoolResetFlags{});
+		VB_CHECK_VK_RESULT(result, "Failed to reset command pool");
+		pool->used_primaries   = 0;
+		pool->used_secondaries = 0;
+	}
+
+	std::lock_guard lock(mutex);
+	pool_resets += used_pools.size();
+}
+
+auto CommandAllocator::GetStats() const -> CommandAllocatorStats {
+	std::lock_guard lock(mutex);
+	return {
+		.pools			   = static_cast<u32>(thread_pools.size() * info.frames_in_flight),
+		.primary_buffers   = primary_buffers.load(std::memory_order_relaxed),
+		.secondary_buffers = secondary_buffers.load(std::memory_order_relaxed),
+		.pool_resets	   = pool_resets,
+	};
+}
+
+auto CommandAllocator::GetResourceTypeName() const -> char const* { return "CommandAllocatorResource"; }
+
+void CommandAllocator::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, pools = %zu", GetResourceTypeName(), thread_pools.size() * info.frames_in_flight);
+	for (ThreadPools& pools : thread_pools) {
+		for (Pool& pool : pools.frames) {
+			for (u32 i = 0; i < pool.used_primaries; ++i) {
+				pool.primaries[i].Wait();
+			}
+			// Buffers are freed with their pool
+			pool.primaries.clear();
+			pool.secondaries.clear();
+			GetDevice().destroyCommandPool(pool.pool, GetDevice().GetAllocator());
+		}
+	}
+	thread_pools.clear();
+	// Pools of other threads may still be cached, a new allocator gets a new id
+	id = 0;
+}
+} // namespace VB_NAMESPACE
@@ -0,0 +1,152 @@
+#ifndef VB_USE_STD_MODULE
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/compute_pipeline_cache/compute_pipeline_cache.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/pipeline/pipeline.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/hash_functions.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+template <typename T>
+void AppendValue(std::string& data, T const& value) {
+	data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+} // namespace
+
+ComputePipelineCache::ComputePipelineCache(Device& device, ComputePipelineCacheInfo const& info) {
+	Create(device, info);
+}
+
+ComputePipelineCache::~ComputePipelineCache() { Free(); }
+
+void ComputePipelineCache::Create(Device& device, ComputePipelineCacheInfo const& info) {
+	ResourceBase::SetOwner(&device);
+	capacity = info.capacity;
+}
+
+auto ComputePipelineCache::GetKeyData(PipelineInfo const& info) -> std::string {
+	VB_ASSERT(info.stages.size() == 1, "Compute pipeline supports only 1 stage.");
+	PipelineStage const& stage = info.stages[0];
+	std::string data;
+	AppendValue(data, static_cast<u32>(stage.stage));
+	AppendValue(data, static_cast<u32>(stage.source.type));
+	// Sizes keep ("ab", "c") and ("a", "bc") apart
+	for (std::string_view field : {stage.source.data, stage.entry_point, stage.compiler, stage.compile_options}) {
+		AppendValue(data, static_cast<u64>(field.size()));
+		data.append(field);
+	}
+	if (stage.source.type == Source::Type::File || stage.source.type == Source::Type::FileSpirV) {
+		// File may be rewritten with the same name
+		std::error_code ec;
+		std::filesystem::path const path = stage.source.data;
+		AppendValue(data, std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+		AppendValue(data, static_cast<u64>(std::filesystem::file_size(path, ec)));
+	}
+	auto const& specialization = stage.specialization_info;
+	AppendValue(data, specialization.mapEntryCount);
+	for (u32 i = 0; i < specialization.mapEntryCount; ++i) {
+		auto const& entry = specialization.pMapEntries[i];
+		AppendValue(data, entry.constantID);
+		AppendValue(data, entry.offset);
+		AppendValue(data, static_cast<u64>(entry.size));
+	}
+	AppendValue(data, static_cast<u64>(specialization.dataSize));
+	data.append(static_cast<char const*>(specialization.pData), specialization.dataSize);
+	AppendValue(data, static_cast<VkPipelineLayout>(info.layout));
+	return data;
+}
+
+auto ComputePipelineCache::GetKey(PipelineInfo const& info) -> u64 { return HashFnv1a64(GetKeyData(info)); }
+
+auto ComputePipelineCache::GetOrCreate(PipelineInfo const& info) -> std::shared_ptr<Pipeline> {
+	std::string key = GetKeyData(info);
+	{
+		std::lock_guard lock(mutex);
+		if (auto it = entries_by_key.find(key); it != entries_by_key.end()) {
+			entries.splice(entries.begin(), entries, it->second);
+			++stats.hits;
+			return it->second->second;
+		}
+		++stats.misses;
+	}
+
+	// Shared pipeline may still be used by the GPU when its last reference is released
+	std::shared_ptr<Pipeline> pipeline(new Pipeline(GetDevice(), info), [](Pipeline* pipeline) {
+		pipeline->GetDevice().RetirePipeline(pipeline->Exchange(vk::Pipeline{}));
+		delete pipeline;
+	});
+	if (!pipeline->GetHandle()) {
+		// Error is already logged, next call tries again
+		return nullptr;
+	}
+
+	std::lock_guard lock(mutex);
+	// Another thread might have created the same pipeline meanwhile, share the cached one
+	if (auto it = entries_by_key.find(key); it != entries_by_key.end()) {
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+	entries.emplace_front(std::move(key), pipeline);
+	entries_by_key.emplace(entries.front().first, entries.begin());
+	EvictOverCapacity();
+	return pipeline;
+}
+
+void ComputePipelineCache::SetCapacity(std::size_t capacity) {
+	std::lock_guard lock(mutex);
+	this->capacity = capacity;
+	EvictOverCapacity();
+}
+
+void ComputePipelineCache::Clear() {
+	std::lock_guard lock(mutex);
+	entries_by_key.clear();
+	entries.clear();
+}
+
+auto ComputePipelineCache::GetStats() const -> ComputePipelineCacheStats {
+	std::lock_guard lock(mutex);
+	ComputePipelineCacheStats result = stats;
+	result.size = entries.size();
+	return result;
+}
+
+void ComputePipelineCache::EvictOverCapacity() {
+	while (entries.size() > capacity) {
+		entries_by_key.erase(entries.back().first);
+		entries.pop_back();
+		++stats.evictions;
+	}
+}
+
+auto ComputePipelineCache::GetResourceTypeName() const -> char const* { return "ComputePipelineCacheResource"; }
+
+void ComputePipelineCache::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, pipelines = %zu", GetResourceTypeName(), entries.size());
+	Clear();
+}
+
+} // namespace VB_NAMESPACE
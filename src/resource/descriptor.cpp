@@ -51,6 +51,7 @@ auto Descriptor::Create(Device& device, DescriptorInfo const& info) -> vk::Resul
 	});
 	VB_VERIFY_VK_RESULT(CreateDescriptorSets(info), info.check_vk_results, "Failed to allocate descriptor set!", {
 		GetDevice().destroyDescriptorPool(pool, GetDevice().GetAllocator());
+		GetDevice().RemoveFromPipelineManifest(layout);
 		GetDevice().destroyDescriptorSetLayout(layout);
 		pool   = nullptr;
 		layout = nullptr;
@@ -64,6 +65,7 @@ void Descriptor::Free() {
 		return;
 	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), "Descriptor");
 	GetDevice().destroyDescriptorPool(pool, GetDevice().GetAllocator());
+	GetDevice().RemoveFromPipelineManifest(layout);
 	GetDevice().destroyDescriptorSetLayout(layout);
 	pool   = nullptr;
 	layout = nullptr;
@@ -115,7 +117,11 @@ auto Descriptor::CreateDescriptorSetLayout(DescriptorInfo const& info) -> vk::Re
 		.pBindings    = info.bindings.data(),
 	};
 
-	return GetDevice().createDescriptorSetLayout(&layoutInfo, GetDevice().GetAllocator(), &layout);
+	vk::Result result = GetDevice().createDescriptorSetLayout(&layoutInfo, GetDevice().GetAllocator(), &layout);
+	if (result == vk::Result::eSuccess) {
+		GetDevice().RecordPipelineManifest(layout, layoutInfo, binding_flags);
+	}
+	return result;
 }
 
 auto Descriptor::CreateDescriptorSets(DescriptorInfo const& info) -> vk::Result {
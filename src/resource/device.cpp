@@ -1,6 +1,12 @@
 #ifndef VB_USE_STD_MODULE
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
 #else
 import std;
 #endif
@@ -30,8 +36,54 @@ import vk_mem_alloc;
 #include "vulkan_backend/vk_result.hpp"
 #include "vulkan_backend/vulkan_functions.hpp"
 
+#include "pipeline_manifest.hpp"
+
 namespace VB_NAMESPACE {
 
+namespace {
+// Find feature structure of type T in features chain
+template <typename T>
+auto FindFeatures(vk::PhysicalDeviceFeatures2 const* features2) -> T const* {
+	for (auto p = reinterpret_cast<vk::BaseInStructure const*>(features2); p != nullptr; p = p->pNext) {
+		if (p->sType == T::structureType) {
+			return reinterpret_cast<T const*>(p);
+		}
+	}
+	return nullptr;
+}
+
+auto IsShaderModuleIdentifierEnabled(vk::PhysicalDeviceFeatures2 const* features2) -> bool {
+	auto features = FindFeatures<vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>(features2);
+	return features && features->shaderModuleIdentifier;
+}
+
+auto IsShaderObjectFeatureEnabled(vk::PhysicalDeviceFeatures2 const* features2) -> bool {
+	auto features = FindFeatures<vk::PhysicalDeviceShaderObjectFeaturesEXT>(features2);
+	return features && features->shaderObject;
+}
+
+// Chain sets timelineSemaphore, either in Vulkan 1.2 features or in timeline semaphore features
+auto DeclaresTimelineSemaphoreFeature(vk::PhysicalDeviceFeatures2 const* features2) -> bool {
+	return FindFeatures<vk::PhysicalDeviceVulkan12Features>(features2) ||
+		   FindFeatures<vk::PhysicalDeviceTimelineSemaphoreFeatures>(features2);
+}
+
+auto IsTimelineSemaphoreFeatureEnabled(vk::PhysicalDeviceFeatures2 const* features2) -> bool {
+	auto vulkan12 = FindFeatures<vk::PhysicalDeviceVulkan12Features>(features2);
+	auto timeline = FindFeatures<vk::PhysicalDeviceTimelineSemaphoreFeatures>(features2);
+	return (vulkan12 && vulkan12->timelineSemaphore) || (timeline && timeline->timelineSemaphore);
+}
+
+auto IsMaintenance6FeatureEnabled(vk::PhysicalDeviceFeatures2 const* features2) -> bool {
+#ifdef VK_KHR_maintenance6
+	auto features = FindFeatures<vk::PhysicalDeviceMaintenance6FeaturesKHR>(features2);
+	return features && features->maintenance6;
+#else
+	return false;
+#endif
+}
+} // namespace
+
 // Device::Device(DeviceInfo const& info)
 // 	: ResourceBase(&instance), physical_device(&physical_device) {
 // 	// VB_ASSERT(physical_device != nullptr, "Physical device must not be null to create device!");
@@ -73,6 +125,7 @@ Device::Device(Instance& instance, PhysicalDevice& physical_device, DeviceInfo c
 auto Device::Create(Instance& instance, PhysicalDevice& physical_device, DeviceInfo const& info) -> vk::Result {
 	ResourceBase::SetOwner(&instance);
 	this->physical_device = &physical_device;
+	creation_time         = std::chrono::steady_clock::now();
 	enabled_extensions.reserve(info.extensions.size() + info.optional_extensions.size() + 1);
 	for (auto const extension : info.extensions) {
 		enabled_extensions.push_back(extension);
@@ -114,6 +167,17 @@ auto Device::Create(Instance& instance, PhysicalDevice& physical_device, DeviceI
 		.ppEnabledExtensionNames = enabled_extensions.data(),
 	};
 
+	// Queues signal timeline semaphores, enable the feature if the chain does not mention it
+	vk::PhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features{
+		.pNext             = const_cast<vk::PhysicalDeviceFeatures2*>(info.features2),
+		.timelineSemaphore = vk::True,
+	};
+	if (!DeclaresTimelineSemaphoreFeature(info.features2)) {
+		create_info.pNext = &timeline_semaphore_features;
+	}
+	VB_ASSERT(!DeclaresTimelineSemaphoreFeature(info.features2) || IsTimelineSemaphoreFeatureEnabled(info.features2),
+			  "timelineSemaphore feature is required for queue submission tracking");
+
 	VB_VK_RESULT result = this->physical_device->createDevice(&create_info, GetAllocator(), this);
 	VB_VERIFY_VK_RESULT(result, info.check_vk_results, "Failed to create logical device!",
 						{ vk::Device::operator=(vk::Device{}); });
@@ -133,6 +197,21 @@ auto Device::Create(Instance& instance, PhysicalDevice& physical_device, DeviceI
 			queue.family = info.queueFamilyIndex;
 			queue.index  = index;
 			queue.flags  = this->physical_device->GetQueueFamilyProperties(info.queueFamilyIndex).queueFlags;
+
+			vk::SemaphoreTypeCreateInfo timeline_type_info{
+				.semaphoreType = vk::SemaphoreType::eTimeline,
+				.initialValue  = 0,
+			};
+			vk::SemaphoreCreateInfo timeline_info{.pNext = &timeline_type_info};
+			result = createSemaphore(&timeline_info, GetAllocator(), &queue.timeline);
+			VB_VERIFY_VK_RESULT(result, info.check_vk_results, "Failed to create queue timeline semaphore!", {
+				for (auto& created : queues) {
+					destroySemaphore(created.timeline, GetAllocator());
+				}
+				queues.clear();
+				destroy(GetAllocator());
+				vk::Device::operator=(vk::Device{});
+			});
 		}
 	}
 
@@ -179,6 +258,45 @@ auto Device::Create(Instance& instance, PhysicalDevice& physical_device, DeviceI
 	if (GetInstance().IsValidationEnabled()) {
 		LoadDeviceDebugUtilsFunctionsEXT(*this);
 	}
+
+	// Instance is created with the highest version supported by the loader
+	pipeline_creation_feedback =
+		GetPhysicalDevice().GetProperties().GetCore10().apiVersion >= VK_API_VERSION_1_3 ||
+		algo::SpanContainsString(enabled_extensions, vk::EXTPipelineCreationFeedbackExtensionName);
+
+	compute_pipeline_cache_capacity  = info.compute_pipeline_cache_capacity;
+	pipeline_creation_stats_capacity = info.pipeline_creation_stats_capacity;
+
+	shader_module_identifier =
+		algo::SpanContainsString(enabled_extensions, vk::EXTShaderModuleIdentifierExtensionName) &&
+		IsShaderModuleIdentifierEnabled(info.features2);
+	if (shader_module_identifier) {
+		LoadDeviceShaderModuleIdentifierFunctionsEXT(*this);
+	}
+	shader_module_cache = std::make_unique<ShaderModuleCache>(*this, shader_module_identifier);
+
+	shader_object = algo::SpanContainsString(enabled_extensions, vk::EXTShaderObjectExtensionName) &&
+					IsShaderObjectFeatureEnabled(info.features2);
+	if (shader_object) {
+		LoadDeviceShaderObjectFunctionsEXT(*this);
+	}
+#ifdef VK_KHR_maintenance6
+	maintenance6 = algo::SpanContainsString(enabled_extensions, vk::KHRMaintenance6ExtensionName) &&
+				   IsMaintenance6FeatureEnabled(info.features2);
+#endif
+	if (maintenance6) {
+		LoadDeviceMaintenance6FunctionsKHR(*this);
+	}
+	if (info.record_pipeline_manifest) {
+		pipeline_manifest = std::make_unique<PipelineManifestRecorder>();
+	}
+
+	result = CreatePipelineCache(info.pipeline_cache_path);
+	VB_VERIFY_VK_RESULT(result, info.check_vk_results, "Failed to create pipeline cache!", {
+		vmaDestroyAllocator(vma_allocator);
+		destroy(GetAllocator());
+		vk::Device::operator=(vk::Device{});
+	});
 	return vk::Result::eSuccess;
 }
 
@@ -197,9 +315,56 @@ auto Device::CreatePipelineLayout(PipelineLayoutInfo const& info) -> vk::Pipelin
 	vk::PipelineLayout pipeline_layout;
 	VB_VK_RESULT result = createPipelineLayout(&pipeline_layout_info, GetAllocator(), &pipeline_layout);
 	VB_CHECK_VK_RESULT(result, "Failed to create pipeline layout!");
+	RegisterPipelineLayout(pipeline_layout, info);
+	RecordPipelineManifest(pipeline_layout, info);
 	return pipeline_layout;
 }
 
+void Device::DestroyPipelineLayout(vk::PipelineLayout layout) {
+	UnregisterPipelineLayout(layout);
+	RemoveFromPipelineManifest(layout);
+	destroyPipelineLayout(layout, GetAllocator());
+}
+
+void Device::RegisterPipelineLayout(vk::PipelineLayout layout, PipelineLayoutInfo const& info) {
+	// Layouts are compatible for set N if push constant ranges and set layouts 0..N are the same.
+	// Key of set N holds them, equal keys get the same id
+	std::string key;
+	for (auto const& range : info.push_constant_ranges) {
+		u32 const values[] = {static_cast<u32>(range.stageFlags), range.offset, range.size};
+		key.append(reinterpret_cast<char const*>(values), sizeof(values));
+	}
+	// Separates push constant ranges from set layouts
+	key.push_back('\0');
+	std::vector<u64> ids;
+	ids.reserve(info.descriptor_set_layouts.size());
+	std::unique_lock lock(pipeline_layouts_mutex);
+	for (vk::DescriptorSetLayout set_layout : info.descriptor_set_layouts) {
+		VkDescriptorSetLayout const handle = set_layout;
+		key.append(reinterpret_cast<char const*>(&handle), sizeof(handle));
+		auto [it, inserted] = pipeline_layout_compatibility_ids.try_emplace(key, next_pipeline_layout_compatibility);
+		if (inserted) {
+			++next_pipeline_layout_compatibility;
+		}
+		ids.push_back(it->second);
+	}
+	pipeline_layout_compatibility.insert_or_assign(static_cast<VkPipelineLayout>(layout), std::move(ids));
+}
+
+void Device::UnregisterPipelineLayout(vk::PipelineLayout layout) {
+	std::unique_lock lock(pipeline_layouts_mutex);
+	pipeline_layout_compatibility.erase(static_cast<VkPipelineLayout>(layout));
+}
+
+auto Device::GetPipelineLayoutCompatibility(vk::PipelineLayout layout, u32 set) const -> u64 {
+	std::shared_lock lock(pipeline_layouts_mutex);
+	auto it = pipeline_layout_compatibility.find(static_cast<VkPipelineLayout>(layout));
+	if (it == pipeline_layout_compatibility.end() || set >= it->second.size()) {
+		return 0;
+	}
+	return it->second[set];
+}
+
 void Device::SetDebugUtilsName(vk::ObjectType objectType, void* handle, const char* name) {
 	if (!GetInstance().IsValidationEnabled())
 		return;
@@ -211,13 +376,84 @@ void Device::SetDebugUtilsName(vk::ObjectType objectType, void* handle, const ch
 	VB_CHECK_VK_RESULT(result, "Failed to set debug utils object name!");
 }
 
+auto Device::GetThreadPool() -> ThreadPool& {
+	std::call_once(thread_pool_once, [this] { thread_pool = std::make_unique<ThreadPool>(); });
+	return *thread_pool;
+}
+
+auto Device::GetComputePipelineCache() -> ComputePipelineCache& {
+	std::call_once(compute_pipeline_cache_once, [this] {
+		compute_pipeline_cache = std::make_unique<ComputePipelineCache>(
+			*this, ComputePipelineCacheInfo{.capacity = compute_pipeline_cache_capacity});
+	});
+	return *compute_pipeline_cache;
+}
+
+void Device::RetirePipeline(vk::Pipeline pipeline) {
+	if (!pipeline)
+		return;
+	std::lock_guard lock(retired_pipelines_mutex);
+	retired_pipelines.push_back(pipeline);
+}
+
+void Device::DestroyRetiredPipelines(RetiredPipelineBatch& batch) {
+	for (auto pipeline : batch.pipelines) {
+		destroyPipeline(pipeline, GetAllocator());
+	}
+}
+
+void Device::ReleaseRetiredPipelines() {
+	// Called by ShaderWatcher::Update() and by the application, possibly from different threads
+	std::lock_guard lock(retired_pipelines_mutex);
+	// Destroy batches whose tickets are all complete
+	std::erase_if(retired_pipeline_batches, [this](RetiredPipelineBatch& batch) {
+		for (auto const& ticket : batch.tickets) {
+			if (!ticket.queue->IsComplete(ticket))
+				return false;
+		}
+		DestroyRetiredPipelines(batch);
+		return true;
+	});
+
+	RetiredPipelineBatch batch;
+	batch.pipelines.swap(retired_pipelines);
+	if (batch.pipelines.empty())
+		return;
+
+	// Last submitted value of each queue covers all work submitted earlier to it
+	batch.tickets.reserve(queues.size());
+	for (auto& queue : queues) {
+		batch.tickets.push_back(queue.GetLastSubmitted());
+	}
+	retired_pipeline_batches.push_back(std::move(batch));
+}
+
 auto Device::GetResourceTypeName() const -> char const* { return "DeviceResource"; }
 
 void Device::Free() {
 	if (vk::Device::operator bool()) {
 		VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), GetName().data());
+		thread_pool.reset();
+		// Retires cached pipelines that are not referenced anymore
+		compute_pipeline_cache.reset();
+		shader_module_cache.reset();
 		VB_VK_RESULT result = waitIdle();
 		VB_CHECK_VK_RESULT(result, "Failed to wait device idle");
+		for (auto& batch : retired_pipeline_batches) {
+			DestroyRetiredPipelines(batch);
+		}
+		retired_pipeline_batches.clear();
+		for (auto pipeline : retired_pipelines) {
+			destroyPipeline(pipeline, GetAllocator());
+		}
+		retired_pipelines.clear();
+		for (auto& queue : queues) {
+			destroySemaphore(queue.timeline, GetAllocator());
+			queue.timeline = nullptr;
+		}
+		SavePipelineCache();
+		destroyPipelineCache(pipeline_cache, GetAllocator());
+		pipeline_cache = nullptr;
 		vmaDestroyAllocator(vma_allocator);
 
 		destroy(GetAllocator());
@@ -34,17 +34,19 @@ namespace VB_NAMESPACE {
 Image::Image(Device& device, ImageInfo const& info) { Create(device, info); }
 
 Image::Image(vk::Image image, vk::ImageView view, Extent3D const& extent, std::string_view name)
-	: vk::Image(image), Named(name), view(view), layout(vk::ImageLayout::eUndefined), aspect(vk::ImageAspectFlagBits::eColor),
-	  fromSwapchain(true) {
+	: vk::Image(image), Named(name), view(view), aspect(vk::ImageAspectFlagBits::eColor), fromSwapchain(true),
+	  layout(vk::ImageLayout::eUndefined) {
 	this->extent = extent;
 }
 
 Image::Image(Image&& other)
 	: vk::Image(std::exchange(static_cast<vk::Image&>(other), {})), Named(std::move(other)),
 	  ResourceBase<Device>(std::move(other)), view(std::exchange(other.view, {})),
-	  allocation(std::exchange(other.allocation, {})), layout(std::move(other.layout)), aspect(std::move(other.aspect)),
+	  allocation(std::exchange(other.allocation, {})), aspect(std::move(other.aspect)),
 	  extent(std::move(other.extent)), format(std::move(other.format)), usage(std::move(other.usage)),
-	  fromSwapchain(std::move(other.fromSwapchain)) {}
+	  mip_levels(other.mip_levels), array_layers(other.array_layers), samples(other.samples), fromSwapchain(std::move(other.fromSwapchain)),
+	  layout(std::move(other.layout)), access_state(other.access_state),
+	  subresource_states(std::move(other.subresource_states)) {}
 
 Image& Image::operator=(Image&& other) {
 	if (this != &other) {
@@ -60,7 +62,12 @@ Image& Image::operator=(Image&& other) {
 		extent        = std::move(other.extent);
 		format        = std::move(other.format);
 		usage         = std::move(other.usage);
+		mip_levels    = other.mip_levels;
+		array_layers  = other.array_layers;
+		samples       = other.samples;
 		fromSwapchain = std::move(other.fromSwapchain);
+		access_state  = other.access_state;
+		subresource_states = std::move(other.subresource_states);
 	}
 	return *this;
 }
@@ -78,6 +85,11 @@ auto Image::Create(Device& device, ImageInfo const& info) -> vk::Result {
 	this->usage  = info.create_info.usage;
 	this->layout = info.create_info.initialLayout;
 	this->aspect = info.aspect;
+	this->mip_levels   = info.create_info.mipLevels;
+	this->array_layers = info.create_info.arrayLayers;
+	this->samples      = info.create_info.samples;
+	this->access_state = {};
+	this->subresource_states.clear();
 
 	VmaAllocationCreateInfo allocInfo = {
 		.usage          = VMA_MEMORY_USAGE_AUTO,
@@ -87,9 +99,19 @@ auto Image::Create(Device& device, ImageInfo const& info) -> vk::Result {
 
 	VB_LOG_TRACE("[ vmaCreateImage ] extent = %ux%ux%u, layers = %u name = %s", info.create_info.extent.width, info.create_info.extent.height,
 				 info.create_info.extent.depth, info.create_info.arrayLayers, detail::FormatName(info.name).data());
-	VB_VK_RESULT result =
-		vk::Result(vmaCreateImage(GetDevice().GetVmaAllocator(), reinterpret_cast<VkImageCreateInfo const*>(&info), &allocInfo,
-								  reinterpret_cast<VkImage*>(static_cast<vk::Image*>(this)), &allocation, nullptr));
+	VB_VK_RESULT result;
+	if (info.alias_allocation) {
+		// Null allocation makes vmaDestroyImage() leave the memory alone
+		allocation = nullptr;
+		result     = vk::Result(vmaCreateAliasingImage2(GetDevice().GetVmaAllocator(), info.alias_allocation,
+													info.alias_offset,
+													reinterpret_cast<VkImageCreateInfo const*>(&info.create_info),
+													reinterpret_cast<VkImage*>(static_cast<vk::Image*>(this))));
+	} else {
+		result = vk::Result(vmaCreateImage(GetDevice().GetVmaAllocator(), reinterpret_cast<VkImageCreateInfo const*>(&info),
+										   &allocInfo, reinterpret_cast<VkImage*>(static_cast<vk::Image*>(this)),
+										   &allocation, nullptr));
+	}
 	VB_VERIFY_VK_RESULT(vk::Result(result), info.check_vk_results, "Failed to create image!", {});
 
 	vk::ImageViewCreateInfo viewInfo{
@@ -1,5 +1,8 @@
 #ifndef VB_USE_STD_MODULE
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <span>
 #include <utility>
 #else
 import std;
@@ -11,6 +14,7 @@ import std;
 import vulkan_hpp;
 #endif
 
+#include "vulkan_backend/classes/structure_chain.hpp"
 #include "vulkan_backend/compile_shader.hpp"
 #include "vulkan_backend/interface/device/device.hpp"
 #include "vulkan_backend/interface/pipeline/pipeline.hpp"
@@ -25,7 +29,8 @@ namespace VB_NAMESPACE {
 
 Pipeline::Pipeline(Device& device, vk::Pipeline pipeline, vk::PipelineLayout layout,
 				   vk::PipelineBindPoint point, std::string_view name)
-	: vk::Pipeline(pipeline), Named(name), ResourceBase(&device), layout(layout), point(point) {}
+	: vk::Pipeline(pipeline), Named(name), ResourceBase(&device), layout(layout), point(point),
+	  layout_compatibility(device.GetPipelineLayoutCompatibility(layout)) {}
 
 Pipeline::Pipeline(Device& device, PipelineInfo const& info) : ResourceBase(&device) {
 	Create(info);
@@ -37,7 +42,8 @@ Pipeline::Pipeline(Device& device, GraphicsPipelineInfo const& info) : ResourceB
 
 Pipeline::Pipeline(Pipeline&& other)
 	: vk::Pipeline(other), Named(std::move(other)), ResourceBase<Device>(std::move(other)),
-	  layout(std::exchange(other.layout, {})), point(std::exchange(other.point, {})) {
+	  layout(std::exchange(other.layout, {})), point(std::exchange(other.point, {})),
+	  layout_compatibility(std::exchange(other.layout_compatibility, 0)) {
 	static_cast<vk::Pipeline&>(other) = vk::Pipeline{};
 }
 
@@ -49,18 +55,22 @@ Pipeline& Pipeline::operator=(Pipeline&& other) {
 		ResourceBase::operator=(std::move(other));
 		layout = std::exchange(other.layout, {});
 		point  = std::move(other.point);
+		layout_compatibility = std::exchange(other.layout_compatibility, 0);
 	}
 	return *this;
 }
 
 // Compute pipeline
-void Pipeline::Create(PipelineInfo const& info) {
+auto Pipeline::Create(PipelineInfo const& info) -> vk::Result {
 	this->layout = info.layout;
 	this->point  = vk::PipelineBindPoint::eCompute;
+	this->layout_compatibility = GetDevice().GetPipelineLayoutCompatibility(info.layout);
+	SetName(info.name);
 	VB_ASSERT(info.stages.size() == 1, "Compute pipeline supports only 1 stage.");
-	vk::ShaderModule shader_modules[1];
-	vk::PipelineShaderStageCreateInfo shader_stages[1];
-	CreateShaderModulesAndStagesInfos(GetDevice(), info.stages, shader_modules, shader_stages);
+	ShaderStagesCreateState stages;
+	vk::Result result = stages.Fill(GetDevice(), info.stages, true);
+	VB_RETURN_ON_VK_ERROR(result);
+	std::span<vk::PipelineShaderStageCreateInfo const> shader_stages = stages.stage_infos;
 
 	// for (u32 i = 0; i < info.stages[0].specialization_info.mapEntryCount; ++i) {
 	// 	auto e = info.stages[0].specialization_info.pMapEntries[i];
@@ -68,98 +78,79 @@ void Pipeline::Create(PipelineInfo const& info) {
 	// }
 
 	vk::ComputePipelineCreateInfo pipelineInfo{
+		.flags				= stages.GetPipelineFlags(),
 		.stage				= shader_stages[0],
 		.layout				= layout,
 		.basePipelineHandle = nullptr,
 		.basePipelineIndex	= -1,
 	};
-	VB_VK_RESULT result = GetDevice().createComputePipelines(GetDevice().GetPipelineCache(), 1, &pipelineInfo,
-														GetDevice().GetAllocator(), this);
-	VB_CHECK_VK_RESULT(result, "Failed to create compute pipeline!");
-	for (auto& shaderModule : shader_modules) {
-		GetDevice().destroyShaderModule(shaderModule, GetDevice().GetAllocator());
+	PipelineFeedback feedback;
+	feedback.Chain(pipelineInfo, 1, GetDevice().pipeline_creation_feedback);
+	result = GetDevice().createComputePipelines(GetDevice().GetPipelineCache(), 1, &pipelineInfo,
+												GetDevice().GetAllocator(), this);
+	if (result == vk::Result::ePipelineCompileRequired) {
+		// Pipeline from module identifier is not in pipeline cache, create it from SPIR-V
+		result = stages.Fill(GetDevice(), info.stages, false);
+		VB_RETURN_ON_VK_ERROR(result);
+		shader_stages	   = stages.stage_infos;
+		pipelineInfo.flags = stages.GetPipelineFlags();
+		pipelineInfo.stage = shader_stages[0];
+		feedback.start	   = std::chrono::steady_clock::now();
+		result = GetDevice().createComputePipelines(GetDevice().GetPipelineCache(), 1, &pipelineInfo,
+													GetDevice().GetAllocator(), this);
 	}
+	VB_CHECK_VK_RESULT(result, "Failed to create compute pipeline!");
+	VB_RETURN_ON_VK_ERROR(result);
+	GetDevice().RecordPipelineCreation(GetName(), feedback, shader_stages);
+	GetDevice().RecordPipelineManifest(info);
+	return vk::Result::eSuccess;
 }
 
 // Graphics pipeline
-void Pipeline::Create(GraphicsPipelineInfo const& info) {
+auto Pipeline::Create(GraphicsPipelineInfo const& info) -> vk::Result {
 	this->layout = info.layout;
 	this->point  = vk::PipelineBindPoint::eGraphics;
-	VB_ASSERT(info.stages.size() == 1, "Compute pipeline supports only 1 stage.");
-	VB_VLA(vk::ShaderModule, shader_modules, info.stages.size());
-	VB_VLA(vk::PipelineShaderStageCreateInfo, shader_stages, info.stages.size());
-	CreateShaderModulesAndStagesInfos(GetDevice(), info.stages, shader_modules.data(), shader_stages.data());
-
-	VB_VLA(vk::VertexInputAttributeDescription, attribute_descs, info.vertex_attributes.size());
-	u32 attribute_size = 0;
-	CreateVertexDescriptionsFromAttributes(info.vertex_attributes, attribute_descs.data(), &attribute_size);
-
-	vk::VertexInputBindingDescription binding_description{
-		.binding   = 0,
-		.stride	   = attribute_size,
-		.inputRate = vk::VertexInputRate::eVertex,
-	};
-
-	vk::PipelineVertexInputStateCreateInfo vertex_input_info{
-		.vertexBindingDescriptionCount	 = 1,
-		.pVertexBindingDescriptions		 = &binding_description,
-		.vertexAttributeDescriptionCount = static_cast<u32>(info.vertex_attributes.size()),
-		.pVertexAttributeDescriptions	 = attribute_descs.data(),
-	};
-
-	vk::PipelineDynamicStateCreateInfo dynamicInfo{
-		.dynamicStateCount = static_cast<u32>(info.dynamic_states.size()),
-		.pDynamicStates	   = reinterpret_cast<const vk::DynamicState*>(info.dynamic_states.data()),
-	};
-
-	vk::PipelineRenderingCreateInfo pipeline_rendering_info{
-		.viewMask				 = 0,
-		.colorAttachmentCount	 = static_cast<u32>(info.color_formats.size()),
-		.pColorAttachmentFormats = reinterpret_cast<const vk::Format*>(info.color_formats.data()),
-		.depthAttachmentFormat	 = info.depth_format,
-		.stencilAttachmentFormat = info.stencil_format,
-	};
-
-	// if we have less blend attachments, than color attachments, just fill with the first one
-	VB_VLA(vk::PipelineColorBlendAttachmentState, blend_attachments, info.color_formats.size());
-	auto end = std::copy_n(info.blend_attachments.begin(),
-						   std::min(info.blend_attachments.size(), info.color_formats.size()),
-						   blend_attachments.begin());
-	std::fill(end, blend_attachments.end(), defaults::kBlendAttachment);
-
-	vk::PipelineColorBlendStateCreateInfo colorBlendState{
-		.logicOpEnable	 = info.color_blend.logicOpEnable,
-		.logicOp		 = info.color_blend.logicOp,
-		.attachmentCount = static_cast<u32>(blend_attachments.size()),
-		.pAttachments	 = blend_attachments.data(),
-		.blendConstants	 = info.color_blend.blendConstants,
-	};
-
-	vk::GraphicsPipelineCreateInfo pipeline_info {
-		.pNext				 = &pipeline_rendering_info,
-		.stageCount			 = static_cast<u32>(shader_stages.size()),
-		.pStages			 = shader_stages.data(),
-		.pVertexInputState	 = &vertex_input_info,
-		.pInputAssemblyState = &info.input_assembly,
-		.pTessellationState	 = info.tessellation ? &info.tessellation.value() : nullptr,
-		.pViewportState		 = &info.viewport,
-		.pRasterizationState = &info.rasterization,
-		.pMultisampleState	 = &info.multisample,
-		.pDepthStencilState	 = &info.depth_stencil,
-		.pColorBlendState	 = &colorBlendState,
-		.pDynamicState		 = &dynamicInfo,
-		.layout				 = info.layout,
-		.basePipelineHandle	 = nullptr,
-		.basePipelineIndex	 = -1,
-	};
-
-	VB_VK_RESULT result = GetDevice().createGraphicsPipelines(GetDevice().GetPipelineCache(), 1, &pipeline_info,
-														GetDevice().GetAllocator(), this);
+	this->layout_compatibility = GetDevice().GetPipelineLayoutCompatibility(info.layout);
+	SetName(info.name);
+	ShaderStagesCreateState stages;
+	vk::Result result = stages.Fill(GetDevice(), info.stages, true);
+	VB_RETURN_ON_VK_ERROR(result);
+	std::span<vk::PipelineShaderStageCreateInfo const> shader_stages = stages.stage_infos;
+
+	GraphicsPipelineCreateState state;
+	vk::GraphicsPipelineCreateInfo pipeline_info = state.Fill(info, shader_stages);
+	pipeline_info.flags = stages.GetPipelineFlags();
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_info, pipeline_info.stageCount, GetDevice().pipeline_creation_feedback);
+
+	result = GetDevice().createGraphicsPipelines(GetDevice().GetPipelineCache(), 1, &pipeline_info,
+												 GetDevice().GetAllocator(), this);
+	if (result == vk::Result::ePipelineCompileRequired) {
+		// Pipeline from module identifiers is not in pipeline cache, create it from SPIR-V
+		result = stages.Fill(GetDevice(), info.stages, false);
+		VB_RETURN_ON_VK_ERROR(result);
+		shader_stages		= stages.stage_infos;
+		pipeline_info.flags = stages.GetPipelineFlags();
+		pipeline_info.pStages = shader_stages.data();
+		feedback.start		= std::chrono::steady_clock::now();
+		result = GetDevice().createGraphicsPipelines(GetDevice().GetPipelineCache(), 1, &pipeline_info,
+													 GetDevice().GetAllocator(), this);
+	}
 	VB_CHECK_VK_RESULT(result, "Failed to create graphics pipeline!");
+	VB_RETURN_ON_VK_ERROR(result);
+	GetDevice().RecordPipelineCreation(GetName(), feedback, shader_stages);
+	GetDevice().RecordPipelineManifest(info);
+	return vk::Result::eSuccess;
+}
 
-	for (auto& shaderModule : shader_modules) {
-		GetDevice().destroyShaderModule(shaderModule, GetDevice().GetAllocator());
-	}
+auto Pipeline::GetHandle() const -> vk::Pipeline {
+	// std::atomic_ref<const T> is not available before C++26
+	auto& handle = const_cast<vk::Pipeline&>(static_cast<vk::Pipeline const&>(*this));
+	return std::atomic_ref(handle).load(std::memory_order_acquire);
+}
+
+auto Pipeline::Exchange(vk::Pipeline pipeline) -> vk::Pipeline {
+	return std::atomic_ref(static_cast<vk::Pipeline&>(*this)).exchange(pipeline, std::memory_order_acq_rel);
 }
 
 auto Pipeline::GetResourceTypeName() const -> char const* { return "PipelineResource"; }
@@ -167,8 +158,11 @@ auto Pipeline::GetResourceTypeName() const -> char const* { return "PipelineReso
 Pipeline::~Pipeline() { Free(); }
 
 void Pipeline::Free() {
+	if (GetOwner() == nullptr || !vk::Pipeline::operator bool())
+		return;
 	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), detail::FormatName((GetName())).data());
 	GetDevice().destroyPipeline(*this, GetDevice().GetAllocator());
+	vk::Pipeline::operator=(vk::Pipeline{});
 	// Layout is destroyed by device
 	// GetDevice().destroyPipelineLayout(layout, GetDevice().GetAllocator());
 }
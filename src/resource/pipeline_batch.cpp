@@ -0,0 +1,230 @@
+#ifndef VB_USE_STD_MODULE
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/classes/structure_chain.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/pipeline/pipeline.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/hash.hpp"
+#include "vulkan_backend/util/pipeline.hpp"
+#include "vulkan_backend/util/thread_pool.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+// Stages that produce the same shader module
+auto IsSameModule(PipelineStage const& a, PipelineStage const& b) -> bool {
+	return a.stage == b.stage && a.source == b.source && a.entry_point == b.entry_point &&
+		   a.compiler == b.compiler && a.compile_options == b.compile_options && a.out_path == b.out_path;
+}
+
+// Hash of fields compared by IsSameModule
+auto HashModule(PipelineStage const& stage) -> std::size_t {
+	std::size_t seed = 0;
+	VB_HASH_COMBINE(seed, stage.stage);
+	VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.source.data));
+	VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.entry_point));
+	VB_HASH_COMBINE(seed, std::hash<std::string_view>{}(stage.compile_options));
+	return seed;
+}
+
+// Shader modules and stage infos for all stages of a batch
+struct BatchShaderStages {
+	// Unique modules from device shader module cache, referenced until pipelines are created
+	std::vector<std::shared_ptr<CachedShaderModule const>> modules;
+	// Stage infos of all pipelines, stages of pipeline i start at offsets[i]
+	std::vector<vk::PipelineShaderStageCreateInfo> stage_infos;
+	std::vector<std::size_t>                       offsets;
+	// Indices of pipelines whose shaders all loaded, others are not created
+	std::vector<std::size_t>                       created;
+};
+
+// Get each unique stage module once from the cache on the thread pool.
+// Stages with the same source file are processed by the same task, because they write the same .spv
+template <typename Info>
+auto CreateBatchShaderStages(Device& device, std::span<Info const> infos) -> BatchShaderStages {
+	BatchShaderStages batch;
+	batch.offsets.reserve(infos.size());
+
+	std::vector<PipelineStage const*>                      unique_stages;
+	std::unordered_map<std::size_t, u32>                   unique_index_by_hash;
+	std::vector<u32>                                       module_indices;
+	std::unordered_map<std::string_view, std::vector<u32>> stages_by_source;
+
+	for (auto const& info : infos) {
+		batch.offsets.push_back(module_indices.size());
+		for (auto const& stage : info.stages) {
+			std::size_t const hash = HashModule(stage);
+			auto it = unique_index_by_hash.find(hash);
+			if (it != unique_index_by_hash.end() && IsSameModule(*unique_stages[it->second], stage)) {
+				module_indices.push_back(it->second);
+				continue;
+			}
+			u32 const index = static_cast<u32>(unique_stages.size());
+			unique_stages.push_back(&stage);
+			unique_index_by_hash.try_emplace(hash, index);
+			stages_by_source[stage.source.data].push_back(index);
+			module_indices.push_back(index);
+		}
+	}
+
+	std::vector<std::vector<u32>> groups;
+	groups.reserve(stages_by_source.size());
+	for (auto& [source, indices] : stages_by_source) {
+		groups.push_back(std::move(indices));
+	}
+
+	batch.modules.resize(unique_stages.size());
+	device.GetThreadPool().ParallelFor(groups.size(), [&](std::size_t begin, std::size_t end) {
+		for (std::size_t group = begin; group < end; ++group) {
+			for (u32 index : groups[group]) {
+				batch.modules[index] = device.GetShaderModuleCache().Get(*unique_stages[index]);
+			}
+		}
+	});
+
+	batch.stage_infos.reserve(module_indices.size());
+	batch.created.reserve(infos.size());
+	std::size_t flat_index = 0;
+	for (std::size_t i = 0; i < infos.size(); ++i) {
+		bool loaded = true;
+		for (auto const& stage : infos[i].stages) {
+			// Null if shader failed to load, error is already logged by shader module cache
+			auto const& module = batch.modules[module_indices[flat_index++]];
+			loaded &= module != nullptr;
+			batch.stage_infos.push_back(vk::PipelineShaderStageCreateInfo{
+				.stage               = stage.stage,
+				.module              = module ? module->module : vk::ShaderModule{},
+				.pName               = stage.entry_point.data(),
+				.pSpecializationInfo = &stage.specialization_info,
+			});
+		}
+		if (loaded) {
+			batch.created.push_back(i);
+		}
+	}
+	return batch;
+}
+
+auto GetPipelineStages(BatchShaderStages const& batch, std::size_t index, std::size_t stage_count)
+	-> std::span<vk::PipelineShaderStageCreateInfo const> {
+	return {batch.stage_infos.data() + batch.offsets[index], stage_count};
+}
+
+// Pipelines of one vkCreate*Pipelines call share host timing
+void SetBatchStart(std::span<PipelineFeedback> feedbacks, std::size_t begin, std::size_t end) {
+	auto const now = std::chrono::steady_clock::now();
+	for (std::size_t i = begin; i < end; ++i) {
+		feedbacks[i].start = now;
+	}
+}
+
+void SetBatchEnd(std::span<PipelineFeedback> feedbacks, std::size_t begin, std::size_t end) {
+	auto const now = std::chrono::steady_clock::now();
+	for (std::size_t i = begin; i < end; ++i) {
+		feedbacks[i].end = now;
+	}
+}
+} // namespace
+
+auto Device::CreatePipelines(std::span<PipelineInfo const> infos) -> std::vector<Pipeline> {
+	BatchShaderStages batch = CreateBatchShaderStages(*this, infos);
+
+	// Indexed by position in batch.created
+	std::size_t const                          count = batch.created.size();
+	std::vector<PipelineFeedback>              feedbacks(count);
+	std::vector<vk::ComputePipelineCreateInfo> create_infos(count);
+	for (std::size_t j = 0; j < count; ++j) {
+		std::size_t const i = batch.created[j];
+		VB_ASSERT(infos[i].stages.size() == 1, "Compute pipeline supports only 1 stage.");
+		create_infos[j] = vk::ComputePipelineCreateInfo{
+			.stage              = batch.stage_infos[batch.offsets[i]],
+			.layout             = infos[i].layout,
+			.basePipelineHandle = nullptr,
+			.basePipelineIndex  = -1,
+		};
+		feedbacks[j].Chain(create_infos[j], 1, pipeline_creation_feedback);
+	}
+
+	// One vkCreateComputePipelines call per worker
+	std::vector<vk::Pipeline> handles(count);
+	GetThreadPool().ParallelFor(count, [&](std::size_t begin, std::size_t end) {
+		SetBatchStart(feedbacks, begin, end);
+		VB_VK_RESULT result = createComputePipelines(pipeline_cache, static_cast<u32>(end - begin), &create_infos[begin],
+													 GetAllocator(), &handles[begin]);
+		VB_CHECK_VK_RESULT(result, "Failed to create compute pipelines!");
+		SetBatchEnd(feedbacks, begin, end);
+	});
+
+	std::vector<Pipeline> pipelines;
+	pipelines.reserve(infos.size());
+	for (std::size_t i = 0, j = 0; i < infos.size(); ++i) {
+		if (j == count || batch.created[j] != i) {
+			pipelines.emplace_back(*this, vk::Pipeline{}, infos[i].layout, vk::PipelineBindPoint::eCompute, infos[i].name);
+			continue;
+		}
+		RecordPipelineCreation(infos[i].name, feedbacks[j], {&batch.stage_infos[batch.offsets[i]], 1});
+		RecordPipelineManifest(infos[i]);
+		pipelines.emplace_back(*this, handles[j++], infos[i].layout, vk::PipelineBindPoint::eCompute, infos[i].name);
+	}
+	VB_LOG_TRACE("Created %zu compute pipelines from %zu shader modules", count, batch.modules.size());
+	return pipelines;
+}
+
+auto Device::CreatePipelines(std::span<GraphicsPipelineInfo const> infos) -> std::vector<Pipeline> {
+	BatchShaderStages batch = CreateBatchShaderStages(*this, infos);
+
+	// Indexed by position in batch.created
+	std::size_t const                           count = batch.created.size();
+	std::vector<PipelineFeedback>               feedbacks(count);
+	std::vector<GraphicsPipelineCreateState>    states(count);
+	std::vector<vk::GraphicsPipelineCreateInfo> create_infos(count);
+	for (std::size_t j = 0; j < count; ++j) {
+		std::size_t const i = batch.created[j];
+		create_infos[j] = states[j].Fill(infos[i], GetPipelineStages(batch, i, infos[i].stages.size()));
+		feedbacks[j].Chain(create_infos[j], create_infos[j].stageCount, pipeline_creation_feedback);
+	}
+
+	// One vkCreateGraphicsPipelines call per worker
+	std::vector<vk::Pipeline> handles(count);
+	GetThreadPool().ParallelFor(count, [&](std::size_t begin, std::size_t end) {
+		SetBatchStart(feedbacks, begin, end);
+		VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, static_cast<u32>(end - begin),
+													  &create_infos[begin], GetAllocator(), &handles[begin]);
+		VB_CHECK_VK_RESULT(result, "Failed to create graphics pipelines!");
+		SetBatchEnd(feedbacks, begin, end);
+	});
+
+	std::vector<Pipeline> pipelines;
+	pipelines.reserve(infos.size());
+	for (std::size_t i = 0, j = 0; i < infos.size(); ++i) {
+		if (j == count || batch.created[j] != i) {
+			pipelines.emplace_back(*this, vk::Pipeline{}, infos[i].layout, vk::PipelineBindPoint::eGraphics, infos[i].name);
+			continue;
+		}
+		RecordPipelineCreation(infos[i].name, feedbacks[j], GetPipelineStages(batch, i, infos[i].stages.size()));
+		RecordPipelineManifest(infos[i]);
+		pipelines.emplace_back(*this, handles[j++], infos[i].layout, vk::PipelineBindPoint::eGraphics, infos[i].name);
+	}
+	VB_LOG_TRACE("Created %zu graphics pipelines from %zu shader modules", count, batch.modules.size());
+	return pipelines;
+}
+
+} // namespace VB_NAMESPACE
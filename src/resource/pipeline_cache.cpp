@@ -0,0 +1,180 @@
+#ifndef VB_USE_STD_MODULE
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/physical_device/physical_device.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/util/hash_functions.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+auto ReadCacheFile(std::filesystem::path const& path) -> std::vector<char> {
+	std::ifstream file(path, std::ios::ate | std::ios::binary);
+	if (!file.is_open()) {
+		return {};
+	}
+	std::vector<char> data(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(data.data(), data.size());
+	if (!file) {
+		return {};
+	}
+	return data;
+}
+
+// Check that cache data was produced by the same driver for the same device.
+// Implementations must reject incompatible data themselves, but some of them crash instead
+auto IsCacheDataCompatible(std::span<char const> data, vk::PhysicalDeviceProperties const& properties) -> bool {
+	VkPipelineCacheHeaderVersionOne header;
+	if (data.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+		   header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.vendorID == properties.vendorID &&
+		   header.deviceID == properties.deviceID &&
+		   std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+} // namespace
+
+auto Device::CreatePipelineCache(std::string_view path) -> vk::Result {
+	pipeline_cache_path = path;
+
+	std::vector<char> data;
+	if (!pipeline_cache_path.empty()) {
+		data = ReadCacheFile(pipeline_cache_path);
+		if (!data.empty() && !IsCacheDataCompatible(data, GetPhysicalDevice().GetProperties().GetCore10())) {
+			VB_LOG_WARN("Pipeline cache %s was created for another device or driver, ignoring",
+						pipeline_cache_path.c_str());
+			data.clear();
+		}
+	}
+
+	vk::PipelineCacheCreateInfo info{
+		.initialDataSize = data.size(),
+		.pInitialData    = data.data(),
+	};
+	VB_VK_RESULT result = createPipelineCache(&info, GetAllocator(), &pipeline_cache);
+	if (result != vk::Result::eSuccess && !data.empty()) {
+		// Retry with empty cache if driver did not accept the data
+		VB_LOG_WARN("Failed to create pipeline cache from %s, starting empty", pipeline_cache_path.c_str());
+		data.clear();
+		info   = vk::PipelineCacheCreateInfo{};
+		result = createPipelineCache(&info, GetAllocator(), &pipeline_cache);
+	}
+	VB_CHECK_VK_RESULT(result, "Failed to create pipeline cache!");
+
+	pipeline_cache_bytes_loaded = data.size();
+	pipeline_cache_loaded_hash  = data.empty() ? 0 : HashFnv1a64(data.data(), data.size());
+	if (!data.empty()) {
+		VB_LOG_TRACE("Loaded pipeline cache %s, size = %zu", pipeline_cache_path.c_str(), data.size());
+	}
+	return result;
+}
+
+void Device::SavePipelineCache() {
+	if (!pipeline_cache || pipeline_cache_path.empty()) {
+		return;
+	}
+	std::filesystem::path const path = pipeline_cache_path;
+
+	// Another process might have written the file since we loaded it, keep its pipelines too
+	std::vector<char> disk_data = ReadCacheFile(path);
+	if (!disk_data.empty() && HashFnv1a64(disk_data.data(), disk_data.size()) != pipeline_cache_loaded_hash &&
+		IsCacheDataCompatible(disk_data, GetPhysicalDevice().GetProperties().GetCore10())) {
+		vk::PipelineCacheCreateInfo info{
+			.initialDataSize = disk_data.size(),
+			.pInitialData    = disk_data.data(),
+		};
+		vk::PipelineCache disk_cache;
+		VB_VK_RESULT result = createPipelineCache(&info, GetAllocator(), &disk_cache);
+		if (result == vk::Result::eSuccess) {
+			result = mergePipelineCaches(pipeline_cache, 1, &disk_cache);
+			VB_CHECK_VK_RESULT(result, "Failed to merge pipeline caches!");
+			destroyPipelineCache(disk_cache, GetAllocator());
+		}
+	}
+
+	std::size_t size = 0;
+	VB_VK_RESULT result = getPipelineCacheData(pipeline_cache, &size, nullptr);
+	VB_CHECK_VK_RESULT(result, "Failed to get pipeline cache data size!");
+	if (result != vk::Result::eSuccess || size == 0) {
+		return;
+	}
+	std::vector<char> data(size);
+	result = getPipelineCacheData(pipeline_cache, &size, data.data());
+	VB_CHECK_VK_RESULT(result, "Failed to get pipeline cache data!");
+	if (result != vk::Result::eSuccess) {
+		return;
+	}
+	data.resize(size);
+
+	// Write to a unique temporary file and rename it over the old one,
+	// so a concurrent reader never sees a partially written cache
+	std::error_code ec;
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), ec);
+	}
+	std::filesystem::path tmp_path = path;
+	tmp_path += ".";
+	tmp_path += std::to_string(reinterpret_cast<std::uintptr_t>(this) ^
+							   static_cast<std::uintptr_t>(HashFnv1a64(data.data(), data.size())));
+	tmp_path += ".tmp";
+	{
+		std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+		file.write(data.data(), data.size());
+		if (!file) {
+			VB_LOG_WARN("Failed to write pipeline cache to %s", tmp_path.string().c_str());
+			file.close();
+			std::filesystem::remove(tmp_path, ec);
+			return;
+		}
+	}
+	std::filesystem::rename(tmp_path, path, ec);
+	if (ec) {
+		VB_LOG_WARN("Failed to replace pipeline cache %s: %s", pipeline_cache_path.c_str(), ec.message().c_str());
+		std::filesystem::remove(tmp_path, ec);
+		return;
+	}
+	VB_LOG_TRACE("Saved pipeline cache %s, size = %zu", pipeline_cache_path.c_str(), data.size());
+}
+
+void Device::RecordPipelineCacheFeedback(vk::PipelineCreationFeedback const& feedback) {
+	if (!(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid)) {
+		return;
+	}
+	if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+		pipeline_cache_hits.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		pipeline_cache_misses.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+auto Device::GetPipelineCacheStats() const -> PipelineCacheStats {
+	return {
+		.hits         = pipeline_cache_hits.load(std::memory_order_relaxed),
+		.misses       = pipeline_cache_misses.load(std::memory_order_relaxed),
+		.bytes_loaded = pipeline_cache_bytes_loaded,
+	};
+}
+
+} // namespace VB_NAMESPACE
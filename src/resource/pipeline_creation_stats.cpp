@@ -0,0 +1,164 @@
+#ifndef VB_USE_STD_MODULE
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/util/pipeline.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+auto GetThreadIndex() -> u32 {
+	static std::atomic<u32> next_index = 0;
+	thread_local u32 const  index      = next_index.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+auto ToNanoseconds(std::chrono::steady_clock::duration duration) -> u64 {
+	return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+void WriteJsonString(std::ofstream& file, std::string_view string) {
+	file << '"';
+	for (char c : string) {
+		if (c == '"' || c == '\\') {
+			file << '\\' << c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			char escaped[8];
+			std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+			file << escaped;
+		} else {
+			file << c;
+		}
+	}
+	file << '"';
+}
+
+// Complete event, times in nanoseconds are written as microseconds
+void WriteTraceEvent(std::ofstream& file, std::string_view name, char const* category, u32 thread, u64 start_ns,
+					 u64 duration_ns, bool cache_hit, bool valid) {
+	char numbers[128];
+	std::snprintf(numbers, sizeof(numbers), "\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", thread,
+				  static_cast<double>(start_ns) / 1000.0, static_cast<double>(duration_ns) / 1000.0);
+	file << "{\"name\":";
+	WriteJsonString(file, name);
+	file << ",\"cat\":\"" << category << "\",\"ph\":\"X\"," << numbers << ",\"args\":{\"cache_hit\":"
+		 << (cache_hit ? "true" : "false") << ",\"feedback_valid\":" << (valid ? "true" : "false") << "}}";
+}
+} // namespace
+
+void Device::RecordPipelineCreation(std::string_view name, PipelineFeedback const& feedback,
+									std::span<vk::PipelineShaderStageCreateInfo const> stages) {
+	auto const end = feedback.end == std::chrono::steady_clock::time_point{} ? std::chrono::steady_clock::now()
+																			  : feedback.end;
+	RecordPipelineCacheFeedback(feedback.pipeline);
+	if (pipeline_creation_stats_capacity == 0) {
+		return;
+	}
+
+	auto is_valid = [](vk::PipelineCreationFeedback const& f) -> bool {
+		return bool(f.flags & vk::PipelineCreationFeedbackFlagBits::eValid);
+	};
+	auto is_hit = [](vk::PipelineCreationFeedback const& f) -> bool {
+		return bool(f.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+	};
+
+	PipelineCreationStats stats{
+		.name             = std::string(name),
+		.start_ns         = ToNanoseconds(feedback.start - creation_time),
+		.host_duration_ns = ToNanoseconds(end - feedback.start),
+		.duration_ns      = is_valid(feedback.pipeline) ? feedback.pipeline.duration : 0,
+		.cache_hit        = is_hit(feedback.pipeline),
+		.valid            = is_valid(feedback.pipeline),
+		.thread           = GetThreadIndex(),
+	};
+	for (std::size_t i = 0; i < feedback.stages.size() && i < stages.size(); ++i) {
+		auto const& stage_feedback = feedback.stages[i];
+		stats.stages.push_back({
+			.stage       = stages[i].stage,
+			.duration_ns = is_valid(stage_feedback) ? stage_feedback.duration : 0,
+			.cache_hit   = is_hit(stage_feedback),
+			.valid       = is_valid(stage_feedback),
+		});
+	}
+
+	std::lock_guard lock(pipeline_creation_stats_mutex);
+	if (pipeline_creation_stats.size() < pipeline_creation_stats_capacity) {
+		pipeline_creation_stats.push_back(std::move(stats));
+		return;
+	}
+	// Full, overwrite the oldest record
+	pipeline_creation_stats[pipeline_creation_stats_next] = std::move(stats);
+	pipeline_creation_stats_next = (pipeline_creation_stats_next + 1) % pipeline_creation_stats_capacity;
+}
+
+auto Device::GetPipelineCreationStats() const -> std::vector<PipelineCreationStats> {
+	std::lock_guard lock(pipeline_creation_stats_mutex);
+	auto const oldest = pipeline_creation_stats.begin() + pipeline_creation_stats_next;
+	std::vector<PipelineCreationStats> stats(oldest, pipeline_creation_stats.end());
+	stats.insert(stats.end(), pipeline_creation_stats.begin(), oldest);
+	return stats;
+}
+
+void Device::ClearPipelineCreationStats() {
+	std::lock_guard lock(pipeline_creation_stats_mutex);
+	pipeline_creation_stats.clear();
+	pipeline_creation_stats_next = 0;
+}
+
+auto Device::WritePipelineCreationTrace(std::string_view path) const -> vk::Result {
+	std::vector<PipelineCreationStats> const stats = GetPipelineCreationStats();
+	std::ofstream file{std::string(path)};
+	if (!file.is_open()) {
+		VB_LOG_WARN("Failed to open %.*s for pipeline creation trace", static_cast<int>(path.size()), path.data());
+		return vk::Result::eErrorInitializationFailed;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	for (auto const& pipeline : stats) {
+		if (!first) {
+			file << ",\n";
+		}
+		first = false;
+		// Driver time is preferred, it excludes waiting for locks and shader loading
+		u64 const duration = pipeline.valid ? pipeline.duration_ns : pipeline.host_duration_ns;
+		WriteTraceEvent(file, pipeline.name, "pipeline", pipeline.thread, pipeline.start_ns, duration,
+						pipeline.cache_hit, pipeline.valid);
+		// Driver does not report when stages start, place them one after another
+		u64 stage_start = pipeline.start_ns;
+		for (auto const& stage : pipeline.stages) {
+			file << ",\n";
+			WriteTraceEvent(file, vk::to_string(stage.stage), "stage", pipeline.thread, stage_start, stage.duration_ns,
+							stage.cache_hit, stage.valid);
+			stage_start += stage.duration_ns;
+		}
+	}
+	file << "\n]}\n";
+	if (!file) {
+		VB_LOG_WARN("Failed to write pipeline creation trace to %.*s", static_cast<int>(path.size()), path.data());
+		return vk::Result::eErrorUnknown;
+	}
+	VB_LOG_TRACE("Wrote %zu pipeline creation records to %.*s", stats.size(), static_cast<int>(path.size()),
+				 path.data());
+	return vk::Result::eSuccess;
+}
+
+} // namespace VB_NAMESPACE
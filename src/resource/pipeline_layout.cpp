@@ -50,6 +50,8 @@ auto PipelineLayout::Create(Device& device, PipelineLayoutInfo const& info) -> v
 
 	VB_VERIFY_VK_RESULT(device.createPipelineLayout(&pipeline_layout_info, device.GetAllocator(), this),
 						info.check_vk_results, "Failed to create pipeline layout!", {});
+	device.RegisterPipelineLayout(*this, info);
+	device.RecordPipelineManifest(*this, info);
 	return vk::Result::eSuccess;
 }
 
@@ -57,7 +59,7 @@ void PipelineLayout::Free() {
 	if (!vk::PipelineLayout::operator bool())
 		return;
 	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), GetResourceTypeName());
-	GetDevice().destroyPipelineLayout(*this, GetDevice().GetAllocator());
+	GetDevice().DestroyPipelineLayout(*this);
 	vk::PipelineLayout::operator=(vk::PipelineLayout{});
 }
 }; // namespace VB_NAMESPACE
\ No newline at end of file
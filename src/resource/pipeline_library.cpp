@@ -1,5 +1,14 @@
 #ifndef VB_USE_STD_MODULE
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #else
 import std;
 #endif
@@ -12,7 +21,11 @@ import vulkan_hpp;
 
 // #include <vulkan/vulkan.h>
 
+#include "vulkan_backend/classes/structure_chain.hpp"
+#include "vulkan_backend/compile_shader.hpp"
 #include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/pipeline_library/pipeline_library.hpp"
+#include "vulkan_backend/log.hpp"
 #include "vulkan_backend/macros.hpp"
 #include "vulkan_backend/util/conversion.hpp"
 #include "vulkan_backend/util/pipeline.hpp"
@@ -92,10 +105,13 @@ auto Device::CreateVertexInputInterface(VertexInputInfo const& info) -> vk::Pipe
 		.pDynamicState       = nullptr
 	};
 
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_library_info, pipeline_library_info.stageCount, pipeline_creation_feedback);
 	vk::Pipeline pipeline;
 	VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, 1, 
 		&pipeline_library_info, GetAllocator(), &pipeline);
 	VB_CHECK_VK_RESULT(result, "Failed to create vertex input interface!");
+	RecordPipelineCreation("Vertex input interface", feedback);
 	return pipeline;
 }
 
@@ -108,25 +124,35 @@ auto Device::CreatePreRasterizationShaders(PreRasterizationInfo const& info) ->
 	// the shader code to the pipeline
 	VB_VLA(vk::ShaderModuleCreateInfo, shader_module_infos, info.stages.size());
 	VB_VLA(vk::PipelineShaderStageCreateInfo, shader_stages, info.stages.size());
-	VB_VLA(std::vector<char>, bytes, info.stages.size());
-	CreateShaderModuleInfos(info.stages, bytes.data(), shader_module_infos.data(), shader_stages.data());
+	VB_VLA(ShaderCode, code, info.stages.size());
+	u32 stage_count = 0;
+	for (std::size_t i = 0; i < info.stages.size(); ++i) {
+		// Fragment stage belongs to fragment shader part
+		if (IsFragmentShaderPartStage(info.stages[i].stage)) continue;
+		CreateShaderModuleInfos(info.stages.subspan(i, 1), &code[stage_count], &shader_module_infos[stage_count],
+								&shader_stages[stage_count]);
+		++stage_count;
+	}
 	
 	vk::PipelineDynamicStateCreateInfo dynamic_info = util::DynamicStateInfo(info.dynamic_states);
 	vk::GraphicsPipelineCreateInfo pipeline_library_info {
 		.pNext               = &library_info,
 		.flags               = vk::PipelineCreateFlagBits::eLibraryKHR |
 								vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT,
-		.stageCount          = static_cast<u32>(shader_stages.size()),
+		.stageCount          = stage_count,
 		.pStages             = shader_stages.data(),
 		.pViewportState      = &info.viewport,
 		.pRasterizationState = &info.rasterization,
 		.pDynamicState       = &dynamic_info,
 		.layout              = info.layout,
 	};
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_library_info, pipeline_library_info.stageCount, pipeline_creation_feedback);
 	vk::Pipeline pipeline;
 	VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, 1,
 		&pipeline_library_info, GetAllocator(), &pipeline);
 	VB_CHECK_VK_RESULT(result, "Failed to create pre-rasterization shaders!");
+	RecordPipelineCreation("Pre-rasterization shaders", feedback, shader_stages.first(stage_count));
 	return pipeline;
 }
 
@@ -137,24 +163,33 @@ auto Device::CreateFragmentShader(FragmentShaderInfo const& info) -> vk::Pipelin
 
 	VB_VLA(vk::ShaderModuleCreateInfo, shader_module_infos, info.stages.size());
 	VB_VLA(vk::PipelineShaderStageCreateInfo, shader_stages, info.stages.size());
-	VB_VLA(std::vector<char>, bytes, info.stages.size());
-	CreateShaderModuleInfos(info.stages, bytes.data(), shader_module_infos.data(), shader_stages.data());
+	VB_VLA(ShaderCode, code, info.stages.size());
+	u32 stage_count = 0;
+	for (std::size_t i = 0; i < info.stages.size(); ++i) {
+		if (!IsFragmentShaderPartStage(info.stages[i].stage)) continue;
+		CreateShaderModuleInfos(info.stages.subspan(i, 1), &code[stage_count], &shader_module_infos[stage_count],
+								&shader_stages[stage_count]);
+		++stage_count;
+	}
 
 	vk::GraphicsPipelineCreateInfo pipeline_library_info {
 		.pNext              = &library_info,
 		.flags              = vk::PipelineCreateFlagBits::eLibraryKHR |
 								vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT,
-		.stageCount          = static_cast<u32>(shader_stages.size()),
+		.stageCount          = stage_count,
 		.pStages             = shader_stages.data(),
 		.pDepthStencilState = &info.depth_stencil,
 		.layout             = info.layout,
 	};
 
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_library_info, pipeline_library_info.stageCount, pipeline_creation_feedback);
 	//todo: Thread pipeline cache
 	vk::Pipeline pipeline;
 	VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, 1,
 		&pipeline_library_info, GetAllocator(), &pipeline);
 	VB_CHECK_VK_RESULT(result, "Failed to create fragment shader!");
+	RecordPipelineCreation("Fragment shader", feedback, shader_stages.first(stage_count));
 	return pipeline;
 }
 
@@ -191,10 +226,13 @@ auto Device::CreateFragmentOutputInterface(FragmentOutputInfo const& info) -> vk
 		// .layout = info.layout,
 	};
 
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_library_info, pipeline_library_info.stageCount, pipeline_creation_feedback);
 	vk::Pipeline pipeline;
 	VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, 1,
 		&pipeline_library_info, nullptr, &pipeline);
 	VB_CHECK_VK_RESULT(result, "Failed to create fragment output interface!");
+	RecordPipelineCreation("Fragment output interface", feedback);
 	return pipeline;
 }
 
@@ -215,11 +253,204 @@ auto Device::LinkPipeline(std::array<vk::Pipeline, 4> const& pipelines, vk::Pipe
 		pipeline_info.flags = vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
 	}
 
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_info, pipeline_info.stageCount, pipeline_creation_feedback);
 	//todo: Thread pipeline cache
 	vk::Pipeline pipeline;
 	VB_VK_RESULT result = createGraphicsPipelines(pipeline_cache, 1, &pipeline_info, nullptr, &pipeline);
 	VB_CHECK_VK_RESULT(result, "Failed to link pipeline!");
+	RecordPipelineCreation(link_time_optimization ? "Linked pipeline (optimized)" : "Linked pipeline", feedback);
 	return pipeline;
 }
 
+auto detail::LinkedPipelineKeyHash::operator()(LinkedPipelineKey const& key) const -> std::size_t {
+	std::size_t hash = 0;
+	for (vk::Pipeline part : key.parts) {
+		hash = HashCombine(hash, std::hash<vk::Pipeline>{}(part));
+	}
+	return HashCombine(hash, std::hash<vk::PipelineLayout>{}(key.layout));
+}
+
+namespace {
+auto MakeStageKeys(std::span<PipelineStage const> stages, bool fragment_part) -> std::vector<detail::PipelineStageKey> {
+	std::vector<detail::PipelineStageKey> keys;
+	for (auto const& stage : stages) {
+		if (IsFragmentShaderPartStage(stage.stage) != fragment_part)
+			continue;
+		auto const& specialization = stage.specialization_info;
+		keys.push_back({
+			.stage           = stage.stage,
+			.type            = stage.source.type,
+			.source          = std::string(stage.source.data),
+			.entry_point     = std::string(stage.entry_point),
+			.compiler        = std::string(stage.compiler),
+			.compile_options = std::string(stage.compile_options),
+			.map_entries     = {specialization.pMapEntries, specialization.pMapEntries + specialization.mapEntryCount},
+			.specialization_data =
+				std::string(static_cast<char const*>(specialization.pData), specialization.dataSize),
+		});
+	}
+	return keys;
+}
+
+auto MakeKey(VertexInputInfo const& info) -> detail::VertexInputKey {
+	return {
+		.vertex_attributes = {info.vertex_attributes.begin(), info.vertex_attributes.end()},
+		.input_assembly    = info.input_assembly,
+	};
+}
+
+auto MakeKey(PreRasterizationInfo const& info) -> detail::PreRasterizationKey {
+	return {
+		.layout         = info.layout,
+		.dynamic_states = {info.dynamic_states.begin(), info.dynamic_states.end()},
+		.stages         = MakeStageKeys(info.stages, false),
+		.tessellation   = info.tessellation,
+		.viewport       = info.viewport,
+		.rasterization  = info.rasterization,
+	};
+}
+
+auto MakeKey(FragmentShaderInfo const& info) -> detail::FragmentShaderKey {
+	return {
+		.layout        = info.layout,
+		.stages        = MakeStageKeys(info.stages, true),
+		.depth_stencil = info.depth_stencil,
+	};
+}
+
+auto MakeKey(FragmentOutputInfo const& info) -> detail::FragmentOutputKey {
+	return {
+		.blend_attachments = {info.blend_attachments.begin(), info.blend_attachments.end()},
+		.color_blend       = info.color_blend,
+		.multisample       = info.multisample,
+		.dynamic_states    = {info.dynamic_states.begin(), info.dynamic_states.end()},
+		.color_formats     = {info.color_formats.begin(), info.color_formats.end()},
+		.depth_format      = info.depth_format,
+		.stencil_format    = info.stencil_format,
+	};
+}
+
+// Find library part with the same state as info or create it. Failed parts are not cached
+template <typename Key, typename PartInfo, typename CreateFunction>
+auto GetOrCreatePart(std::unordered_multimap<std::size_t, std::pair<Key, vk::Pipeline>>& parts, PartInfo const& info,
+					 CreateFunction&& create) -> vk::Pipeline {
+	std::size_t const hash   = std::hash<PartInfo>{}(info);
+	Key               key    = MakeKey(info);
+	auto const [first, last] = parts.equal_range(hash);
+	for (auto it = first; it != last; ++it) {
+		if (it->second.first == key) {
+			return it->second.second;
+		}
+	}
+	vk::Pipeline const pipeline = create(info);
+	if (pipeline) {
+		parts.emplace(hash, std::pair{std::move(key), pipeline});
+	}
+	return pipeline;
+}
+} // namespace
+
+PipelineLibrary::PipelineLibrary(Device& device, PipelineLibraryInfo const& info) { Create(device, info); }
+
+PipelineLibrary::~PipelineLibrary() { Free(); }
+
+void PipelineLibrary::Create(Device& device, PipelineLibraryInfo const& info) {
+	ResourceBase::SetOwner(&device);
+	stop_optimizations = false;
+	if (info.background_link_time_optimization) {
+		optimizer = std::make_unique<ThreadPool>(1);
+	}
+}
+
+auto PipelineLibrary::CreatePipeline(GraphicsPipelineInfo const& info) -> Pipeline* {
+	auto const parts = SplitPipelineInfo(info);
+	Device&    device = GetDevice();
+
+	vk::Pipeline const vertex_input =
+		GetOrCreatePart(vertex_input_interfaces, std::get<VertexInputInfo>(parts),
+						[&device](VertexInputInfo const& part_info) { return device.CreateVertexInputInterface(part_info); });
+	vk::Pipeline const pre_rasterization = GetOrCreatePart(
+		pre_rasterization_shaders, std::get<PreRasterizationInfo>(parts),
+		[&device](PreRasterizationInfo const& part_info) { return device.CreatePreRasterizationShaders(part_info); });
+	vk::Pipeline const fragment_shader =
+		GetOrCreatePart(fragment_shaders, std::get<FragmentShaderInfo>(parts),
+						[&device](FragmentShaderInfo const& part_info) { return device.CreateFragmentShader(part_info); });
+	vk::Pipeline const fragment_output = GetOrCreatePart(
+		fragment_output_interfaces, std::get<FragmentOutputInfo>(parts),
+		[&device](FragmentOutputInfo const& part_info) { return device.CreateFragmentOutputInterface(part_info); });
+
+	std::array<vk::Pipeline, 4> const library_parts{vertex_input, pre_rasterization, fragment_shader, fragment_output};
+	detail::LinkedPipelineKey const   key{library_parts, info.layout};
+	if (auto const it = pipelines.find(key); it != pipelines.end()) {
+		return &it->second;
+	}
+
+	if (std::find(library_parts.begin(), library_parts.end(), vk::Pipeline{}) != library_parts.end()) {
+		// Error is already logged, failed parts are created again next time
+		VB_LOG_WARN("Failed to create pipeline library part, pipeline is not linked");
+		return nullptr;
+	}
+	// Only linked pipelines are cached
+	vk::Pipeline const linked = device.LinkPipeline(library_parts, info.layout, false);
+	if (!linked) {
+		return nullptr;
+	}
+	auto const it = pipelines.try_emplace(key, device, linked, info.layout, vk::PipelineBindPoint::eGraphics, info.name).first;
+
+	bool const all_stages_optimizable = std::all_of(info.stages.begin(), info.stages.end(), [](PipelineStage const& stage) {
+		return (stage.flags & PipelineStage::Flags::kLinkTimeOptimization) == PipelineStage::Flags::kLinkTimeOptimization;
+	});
+	if (optimizer && all_stages_optimizable) {
+		// Node pointers of unordered_map are stable, pipeline outlives the task because Free waits for optimizer
+		optimizer->Submit([this, &device, library_parts, layout = info.layout, pipeline = &it->second] {
+			if (stop_optimizations.load(std::memory_order_relaxed))
+				return;
+			vk::Pipeline optimized = device.LinkPipeline(library_parts, layout, true);
+			if (!optimized) {
+				// Unoptimized pipeline stays in use
+				VB_LOG_WARN("Failed to link optimized pipeline, keeping unoptimized one");
+				return;
+			}
+			device.RetirePipeline(pipeline->Exchange(optimized));
+		});
+	}
+	return &it->second;
+}
+
+void PipelineLibrary::WaitOptimizations() {
+	if (optimizer) {
+		optimizer->Wait();
+	}
+}
+
+auto PipelineLibrary::GetPartCount() const -> std::size_t {
+	return vertex_input_interfaces.size() + pre_rasterization_shaders.size() + fragment_shaders.size() +
+		   fragment_output_interfaces.size();
+}
+
+auto PipelineLibrary::GetResourceTypeName() const -> char const* { return "PipelineLibraryResource"; }
+
+void PipelineLibrary::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, parts = %zu, pipelines = %zu", GetResourceTypeName(), GetPartCount(),
+				 GetPipelineCount());
+	// Skip queued optimizations and wait for the running one
+	stop_optimizations = true;
+	optimizer.reset();
+	// Linked pipelines first, they are freed by Pipeline destructor
+	pipelines.clear();
+	auto destroy_parts = [this](auto& parts) {
+		for (auto& [hash, part] : parts) {
+			GetDevice().destroyPipeline(part.second, GetDevice().GetAllocator());
+		}
+		parts.clear();
+	};
+	destroy_parts(vertex_input_interfaces);
+	destroy_parts(pre_rasterization_shaders);
+	destroy_parts(fragment_shaders);
+	destroy_parts(fragment_output_interfaces);
+}
+
 }; // namespace VB_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,630 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "pipeline_manifest.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/pipeline/pipeline.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/hash_functions.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+// Manifest layout:
+//   header: "VBPM", version, VK_HEADER_VERSION, pointer size, counts of set layouts, pipeline layouts and pipelines
+//   records: u32 size followed by record bytes, in order of the counts
+// Vulkan states are stored as raw structs, so manifest is valid only for the same headers and platform
+constexpr char kManifestMagic[4]   = {'V', 'B', 'P', 'M'};
+constexpr u32  kManifestVersion    = 1;
+constexpr u32  kUnknownIndex       = ~0u;
+constexpr u32  kComputePipeline    = 0;
+constexpr u32  kGraphicsPipeline   = 1;
+// Limits for reading corrupted manifest
+constexpr u32  kMaxStages          = 16;
+constexpr u32  kMaxBindings        = 1u << 16;
+
+class ManifestWriter {
+  public:
+	template <typename T>
+	void Write(T const& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		data.append(reinterpret_cast<char const*>(&value), sizeof(T));
+	}
+
+	void WriteString(std::string_view value) {
+		Write(static_cast<u32>(value.size()));
+		data.append(value);
+	}
+
+	template <typename T>
+	void WriteArray(std::span<T const> values) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		Write(static_cast<u32>(values.size()));
+		data.append(reinterpret_cast<char const*>(values.data()), values.size_bytes());
+	}
+
+	// Vulkan state without its pNext chain
+	template <typename T>
+	void WriteState(T state) {
+		state.pNext = nullptr;
+		Write(state);
+	}
+
+	std::string data;
+};
+
+class ManifestReader {
+  public:
+	explicit ManifestReader(std::span<char const> data) : data(data) {}
+
+	template <typename T>
+	auto Read() -> T {
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value{};
+		if (!Has(sizeof(T))) {
+			return value;
+		}
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return value;
+	}
+
+	auto ReadString() -> std::string {
+		u32 const size = Read<u32>();
+		if (!Has(size)) {
+			return {};
+		}
+		std::string value(data.data() + offset, size);
+		offset += size;
+		return value;
+	}
+
+	template <typename T>
+	auto ReadArray() -> std::vector<T> {
+		u32 const count = Read<u32>();
+		if (!Has(std::size_t(count) * sizeof(T))) {
+			return {};
+		}
+		std::vector<T> values(count);
+		std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+		offset += count * sizeof(T);
+		return values;
+	}
+
+	auto ReadRecord() -> ManifestReader {
+		u32 const size = Read<u32>();
+		if (!Has(size)) {
+			return ManifestReader({});
+		}
+		ManifestReader record(data.subspan(offset, size));
+		offset += size;
+		return record;
+	}
+
+	// Element count that must not exceed max
+	auto ReadCount(u32 max) -> u32 {
+		u32 const count = Read<u32>();
+		valid = valid && count <= max;
+		return valid ? count : 0;
+	}
+
+	auto IsValid() const -> bool { return valid; }
+
+  private:
+	auto Has(std::size_t size) -> bool {
+		valid = valid && data.size() - offset >= size;
+		return valid;
+	}
+
+	std::span<char const> data;
+	std::size_t           offset = 0;
+	bool                  valid  = true;
+};
+
+void WriteStages(ManifestWriter& writer, std::span<PipelineStage const> stages) {
+	writer.Write(static_cast<u32>(stages.size()));
+	for (auto const& stage : stages) {
+		writer.Write(static_cast<u32>(stage.stage));
+		writer.Write(static_cast<u32>(stage.source.type));
+		writer.WriteString(stage.source.data);
+		writer.WriteString(stage.out_path);
+		writer.WriteString(stage.entry_point);
+		writer.WriteString(stage.compiler);
+		writer.WriteString(stage.compile_options);
+		writer.Write(static_cast<u32>(static_cast<vk::Flags<PipelineStage::Flags>::MaskType>(stage.flags)));
+		auto const& specialization = stage.specialization_info;
+		writer.WriteArray(std::span(specialization.pMapEntries, specialization.mapEntryCount));
+		writer.WriteArray(std::span(static_cast<char const*>(specialization.pData), specialization.dataSize));
+	}
+}
+
+// Pipeline read back from manifest, owns everything referenced by its info
+struct ManifestStage {
+	vk::ShaderStageFlagBits                 stage;
+	Source::Type                            source_type;
+	std::string                             source;
+	std::string                             out_path;
+	std::string                             entry_point;
+	std::string                             compiler;
+	std::string                             compile_options;
+	u32                                     flags;
+	std::vector<vk::SpecializationMapEntry> map_entries;
+	std::vector<char>                       data;
+	vk::SpecializationInfo                  specialization_info;
+};
+
+struct ManifestPipeline {
+	u32                        type;
+	u32                        layout;
+	std::string                name;
+	std::vector<ManifestStage> stage_data;
+	std::vector<PipelineStage> stages;
+
+	// Graphics states
+	std::vector<vk::Format>                                vertex_attributes;
+	vk::PipelineInputAssemblyStateCreateInfo               input_assembly;
+	std::optional<vk::PipelineTessellationStateCreateInfo> tessellation;
+	vk::PipelineViewportStateCreateInfo                    viewport;
+	std::vector<vk::Viewport>                              viewports;
+	std::vector<vk::Rect2D>                                scissors;
+	vk::PipelineRasterizationStateCreateInfo               rasterization;
+	vk::PipelineMultisampleStateCreateInfo                 multisample;
+	std::vector<vk::SampleMask>                            sample_mask;
+	vk::PipelineDepthStencilStateCreateInfo                depth_stencil;
+	std::vector<vk::PipelineColorBlendAttachmentState>     blend_attachments;
+	vk::PipelineColorBlendStateCreateInfo                  color_blend;
+	std::vector<vk::DynamicState>                          dynamic_states;
+	std::vector<vk::Format>                                color_formats;
+	vk::Format                                             depth_format;
+	vk::Format                                             stencil_format;
+};
+
+auto ReadPipeline(ManifestReader& reader) -> ManifestPipeline {
+	ManifestPipeline pipeline;
+	pipeline.type   = reader.Read<u32>();
+	pipeline.layout = reader.Read<u32>();
+	pipeline.name   = reader.ReadString();
+
+	pipeline.stage_data.resize(reader.ReadCount(kMaxStages));
+	for (auto& stage : pipeline.stage_data) {
+		stage.stage           = static_cast<vk::ShaderStageFlagBits>(reader.Read<u32>());
+		stage.source_type     = static_cast<Source::Type>(reader.Read<u32>());
+		stage.source          = reader.ReadString();
+		stage.out_path        = reader.ReadString();
+		stage.entry_point     = reader.ReadString();
+		stage.compiler        = reader.ReadString();
+		stage.compile_options = reader.ReadString();
+		stage.flags           = reader.Read<u32>();
+		stage.map_entries     = reader.ReadArray<vk::SpecializationMapEntry>();
+		stage.data            = reader.ReadArray<char>();
+		stage.specialization_info = vk::SpecializationInfo{
+			.mapEntryCount = static_cast<u32>(stage.map_entries.size()),
+			.pMapEntries   = stage.map_entries.data(),
+			.dataSize      = stage.data.size(),
+			.pData         = stage.data.data(),
+		};
+	}
+	// Stage data is not resized anymore, its strings and specialization info can be referenced
+	pipeline.stages.reserve(pipeline.stage_data.size());
+	for (auto const& stage : pipeline.stage_data) {
+		pipeline.stages.push_back(PipelineStage{
+			.stage               = stage.stage,
+			.source              = {.data = stage.source, .type = stage.source_type},
+			.out_path            = stage.out_path,
+			.entry_point         = stage.entry_point,
+			.compiler            = stage.compiler,
+			.compile_options     = stage.compile_options,
+			.flags               = vk::Flags<PipelineStage::Flags>(
+				static_cast<vk::Flags<PipelineStage::Flags>::MaskType>(stage.flags)),
+			.specialization_info = stage.specialization_info,
+		});
+	}
+	if (pipeline.type != kGraphicsPipeline) {
+		return pipeline;
+	}
+
+	pipeline.vertex_attributes = reader.ReadArray<vk::Format>();
+	pipeline.input_assembly    = reader.Read<vk::PipelineInputAssemblyStateCreateInfo>();
+	if (reader.Read<u32>() != 0) {
+		pipeline.tessellation = reader.Read<vk::PipelineTessellationStateCreateInfo>();
+	}
+	pipeline.viewport  = reader.Read<vk::PipelineViewportStateCreateInfo>();
+	pipeline.viewports = reader.ReadArray<vk::Viewport>();
+	pipeline.scissors  = reader.ReadArray<vk::Rect2D>();
+	pipeline.viewport.pViewports = pipeline.viewports.empty() ? nullptr : pipeline.viewports.data();
+	pipeline.viewport.pScissors  = pipeline.scissors.empty() ? nullptr : pipeline.scissors.data();
+	pipeline.rasterization = reader.Read<vk::PipelineRasterizationStateCreateInfo>();
+	pipeline.multisample   = reader.Read<vk::PipelineMultisampleStateCreateInfo>();
+	pipeline.sample_mask   = reader.ReadArray<vk::SampleMask>();
+	pipeline.multisample.pSampleMask = pipeline.sample_mask.empty() ? nullptr : pipeline.sample_mask.data();
+	pipeline.depth_stencil     = reader.Read<vk::PipelineDepthStencilStateCreateInfo>();
+	pipeline.blend_attachments = reader.ReadArray<vk::PipelineColorBlendAttachmentState>();
+	pipeline.color_blend       = reader.Read<vk::PipelineColorBlendStateCreateInfo>();
+	pipeline.dynamic_states    = reader.ReadArray<vk::DynamicState>();
+	pipeline.color_formats     = reader.ReadArray<vk::Format>();
+	pipeline.depth_format      = reader.Read<vk::Format>();
+	pipeline.stencil_format    = reader.Read<vk::Format>();
+	return pipeline;
+}
+
+auto ReadManifestFile(std::string_view path) -> std::vector<char> {
+	std::ifstream file(std::string(path), std::ios::ate | std::ios::binary);
+	if (!file.is_open()) {
+		return {};
+	}
+	std::vector<char> data(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(data.data(), data.size());
+	if (!file) {
+		return {};
+	}
+	return data;
+}
+} // namespace
+
+auto PipelineManifestRecorder::AddUnique(std::string&& record, std::vector<std::string>& records,
+										 std::unordered_multimap<u64, u32>& index_by_hash) -> u32 {
+	u64 const hash = HashFnv1a64(record);
+	auto const [first, last] = index_by_hash.equal_range(hash);
+	for (auto it = first; it != last; ++it) {
+		if (records[it->second] == record) {
+			return it->second;
+		}
+	}
+	u32 const index = static_cast<u32>(records.size());
+	index_by_hash.emplace(hash, index);
+	records.push_back(std::move(record));
+	return index;
+}
+
+auto PipelineManifestRecorder::GetLayoutIndex(vk::PipelineLayout layout) const -> u32 {
+	auto it = pipeline_layout_by_handle.find(static_cast<VkPipelineLayout>(layout));
+	return it != pipeline_layout_by_handle.end() ? it->second : kUnknownIndex;
+}
+
+void PipelineManifestRecorder::AddDescriptorSetLayout(vk::DescriptorSetLayout                     layout,
+													  vk::DescriptorSetLayoutCreateInfo const&    info,
+													  std::span<vk::DescriptorBindingFlags const> binding_flags) {
+	// Immutable samplers are not recorded
+	ManifestWriter writer;
+	writer.Write(static_cast<u32>(info.flags));
+	writer.Write(info.bindingCount);
+	for (u32 i = 0; i < info.bindingCount; ++i) {
+		auto const& binding = info.pBindings[i];
+		writer.Write(binding.binding);
+		writer.Write(static_cast<u32>(binding.descriptorType));
+		writer.Write(binding.descriptorCount);
+		writer.Write(static_cast<u32>(binding.stageFlags));
+		writer.Write(static_cast<u32>(i < binding_flags.size() ? binding_flags[i] : vk::DescriptorBindingFlags{}));
+	}
+	std::lock_guard lock(mutex);
+	set_layout_by_handle.insert_or_assign(static_cast<VkDescriptorSetLayout>(layout),
+										  AddUnique(std::move(writer.data), set_layouts, set_layout_by_hash));
+}
+
+void PipelineManifestRecorder::AddPipelineLayout(vk::PipelineLayout layout, PipelineLayoutInfo const& info) {
+	std::lock_guard lock(mutex);
+	ManifestWriter writer;
+	writer.Write(static_cast<u32>(info.descriptor_set_layouts.size()));
+	for (auto set_layout : info.descriptor_set_layouts) {
+		auto it = set_layout_by_handle.find(static_cast<VkDescriptorSetLayout>(set_layout));
+		writer.Write(it != set_layout_by_handle.end() ? it->second : kUnknownIndex);
+	}
+	writer.WriteArray(info.push_constant_ranges);
+	pipeline_layout_by_handle.insert_or_assign(
+		static_cast<VkPipelineLayout>(layout), AddUnique(std::move(writer.data), pipeline_layouts, pipeline_layout_by_hash));
+}
+
+void PipelineManifestRecorder::RemoveDescriptorSetLayout(vk::DescriptorSetLayout layout) {
+	std::lock_guard lock(mutex);
+	set_layout_by_handle.erase(static_cast<VkDescriptorSetLayout>(layout));
+}
+
+void PipelineManifestRecorder::RemovePipelineLayout(vk::PipelineLayout layout) {
+	std::lock_guard lock(mutex);
+	pipeline_layout_by_handle.erase(static_cast<VkPipelineLayout>(layout));
+}
+
+void PipelineManifestRecorder::AddPipeline(PipelineInfo const& info) {
+	std::lock_guard lock(mutex);
+	ManifestWriter writer;
+	writer.Write(kComputePipeline);
+	writer.Write(GetLayoutIndex(info.layout));
+	writer.WriteString(info.name);
+	WriteStages(writer, info.stages);
+	AddUnique(std::move(writer.data), pipelines, pipeline_by_hash);
+}
+
+void PipelineManifestRecorder::AddPipeline(GraphicsPipelineInfo const& info) {
+	std::lock_guard lock(mutex);
+	ManifestWriter writer;
+	writer.Write(kGraphicsPipeline);
+	writer.Write(GetLayoutIndex(info.layout));
+	writer.WriteString(info.name);
+	WriteStages(writer, info.stages);
+
+	writer.WriteArray(info.vertex_attributes);
+	writer.WriteState(info.input_assembly);
+	writer.Write(static_cast<u32>(info.tessellation.has_value()));
+	if (info.tessellation) {
+		writer.WriteState(*info.tessellation);
+	}
+	auto viewport = info.viewport;
+	viewport.pViewports = nullptr;
+	viewport.pScissors  = nullptr;
+	writer.WriteState(viewport);
+	writer.WriteArray(std::span(info.viewport.pViewports, info.viewport.pViewports ? info.viewport.viewportCount : 0));
+	writer.WriteArray(std::span(info.viewport.pScissors, info.viewport.pScissors ? info.viewport.scissorCount : 0));
+	writer.WriteState(info.rasterization);
+	auto multisample = info.multisample;
+	multisample.pSampleMask = nullptr;
+	writer.WriteState(multisample);
+	u32 const sample_mask_words = (static_cast<u32>(info.multisample.rasterizationSamples) + 31) / 32;
+	writer.WriteArray(std::span(info.multisample.pSampleMask, info.multisample.pSampleMask ? sample_mask_words : 0));
+	writer.WriteState(info.depth_stencil);
+	writer.WriteArray(info.blend_attachments);
+	auto color_blend = info.color_blend;
+	color_blend.pAttachments = nullptr;
+	writer.WriteState(color_blend);
+	writer.WriteArray(info.dynamic_states);
+	writer.WriteArray(info.color_formats);
+	writer.Write(info.depth_format);
+	writer.Write(info.stencil_format);
+	AddUnique(std::move(writer.data), pipelines, pipeline_by_hash);
+}
+
+auto PipelineManifestRecorder::Serialize() const -> std::vector<char> {
+	std::lock_guard lock(mutex);
+	ManifestWriter writer;
+	writer.Write(kManifestMagic);
+	writer.Write(kManifestVersion);
+	writer.Write(static_cast<u32>(VK_HEADER_VERSION));
+	writer.Write(static_cast<u32>(sizeof(void*)));
+	writer.Write(static_cast<u32>(set_layouts.size()));
+	writer.Write(static_cast<u32>(pipeline_layouts.size()));
+	writer.Write(static_cast<u32>(pipelines.size()));
+	for (auto const* records : {&set_layouts, &pipeline_layouts, &pipelines}) {
+		for (auto const& record : *records) {
+			writer.WriteString(record);
+		}
+	}
+	return std::vector<char>(writer.data.begin(), writer.data.end());
+}
+
+void Device::RecordPipelineManifest(PipelineInfo const& info) {
+	if (pipeline_manifest) {
+		pipeline_manifest->AddPipeline(info);
+	}
+}
+
+void Device::RecordPipelineManifest(GraphicsPipelineInfo const& info) {
+	if (pipeline_manifest) {
+		pipeline_manifest->AddPipeline(info);
+	}
+}
+
+void Device::RecordPipelineManifest(vk::PipelineLayout layout, PipelineLayoutInfo const& info) {
+	if (pipeline_manifest) {
+		pipeline_manifest->AddPipelineLayout(layout, info);
+	}
+}
+
+void Device::RecordPipelineManifest(vk::DescriptorSetLayout layout, vk::DescriptorSetLayoutCreateInfo const& info,
+									std::span<vk::DescriptorBindingFlags const> binding_flags) {
+	if (pipeline_manifest) {
+		pipeline_manifest->AddDescriptorSetLayout(layout, info, binding_flags);
+	}
+}
+
+void Device::RemoveFromPipelineManifest(vk::PipelineLayout layout) {
+	if (pipeline_manifest) {
+		pipeline_manifest->RemovePipelineLayout(layout);
+	}
+}
+
+void Device::RemoveFromPipelineManifest(vk::DescriptorSetLayout layout) {
+	if (pipeline_manifest) {
+		pipeline_manifest->RemoveDescriptorSetLayout(layout);
+	}
+}
+
+auto Device::GetPipelineManifest() const -> std::vector<char> {
+	return pipeline_manifest ? pipeline_manifest->Serialize() : std::vector<char>{};
+}
+
+auto Device::WritePipelineManifest(std::string_view path) const -> vk::Result {
+	std::vector<char> const data = GetPipelineManifest();
+	std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		VB_LOG_WARN("Failed to open %.*s for pipeline manifest", static_cast<int>(path.size()), path.data());
+		return vk::Result::eErrorInitializationFailed;
+	}
+	file.write(data.data(), data.size());
+	if (!file) {
+		VB_LOG_WARN("Failed to write pipeline manifest to %.*s", static_cast<int>(path.size()), path.data());
+		return vk::Result::eErrorUnknown;
+	}
+	VB_LOG_TRACE("Wrote pipeline manifest to %.*s, size = %zu", static_cast<int>(path.size()), path.data(),
+				 data.size());
+	return vk::Result::eSuccess;
+}
+
+auto Device::WarmUp(std::span<char const> manifest) -> vk::Result {
+	ManifestReader reader(manifest);
+	auto const magic          = reader.Read<std::array<char, 4>>();
+	u32 const  version        = reader.Read<u32>();
+	u32 const  header_version = reader.Read<u32>();
+	u32 const  pointer_size   = reader.Read<u32>();
+	if (!reader.IsValid() || std::memcmp(magic.data(), kManifestMagic, sizeof(kManifestMagic)) != 0 ||
+		version != kManifestVersion) {
+		VB_LOG_WARN("WarmUp: not a pipeline manifest");
+		return vk::Result::eErrorFormatNotSupported;
+	}
+	if (header_version != VK_HEADER_VERSION || pointer_size != sizeof(void*)) {
+		VB_LOG_WARN("WarmUp: pipeline manifest was written by another build, ignoring");
+		return vk::Result::eErrorIncompatibleDriver;
+	}
+	u32 const set_layout_count      = reader.Read<u32>();
+	u32 const pipeline_layout_count = reader.Read<u32>();
+	u32 const pipeline_count        = reader.Read<u32>();
+
+	// Layouts are created like originals and registered, so pipelines created here are recorded as the same
+	std::vector<vk::DescriptorSetLayout> set_layouts;
+	for (u32 i = 0; i < set_layout_count && reader.IsValid(); ++i) {
+		ManifestReader record = reader.ReadRecord();
+		auto const flags = static_cast<vk::DescriptorSetLayoutCreateFlags>(record.Read<u32>());
+		u32 const binding_count = record.ReadCount(kMaxBindings);
+		std::vector<vk::DescriptorSetLayoutBinding> bindings(binding_count);
+		std::vector<vk::DescriptorBindingFlags>     binding_flags(binding_count);
+		for (u32 j = 0; j < binding_count; ++j) {
+			bindings[j] = vk::DescriptorSetLayoutBinding{
+				.binding         = record.Read<u32>(),
+				.descriptorType  = static_cast<vk::DescriptorType>(record.Read<u32>()),
+				.descriptorCount = record.Read<u32>(),
+				.stageFlags      = static_cast<vk::ShaderStageFlags>(record.Read<u32>()),
+			};
+			binding_flags[j] = static_cast<vk::DescriptorBindingFlags>(record.Read<u32>());
+		}
+		vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{
+			.bindingCount  = binding_count,
+			.pBindingFlags = binding_flags.data(),
+		};
+		vk::DescriptorSetLayoutCreateInfo info{
+			.pNext        = &binding_flags_info,
+			.flags        = flags,
+			.bindingCount = binding_count,
+			.pBindings    = bindings.data(),
+		};
+		vk::DescriptorSetLayout layout;
+		if (record.IsValid() && createDescriptorSetLayout(&info, GetAllocator(), &layout) == vk::Result::eSuccess) {
+			RecordPipelineManifest(layout, info, binding_flags);
+		}
+		set_layouts.push_back(layout);
+	}
+
+	std::vector<vk::PipelineLayout> pipeline_layouts;
+	for (u32 i = 0; i < pipeline_layout_count && reader.IsValid(); ++i) {
+		ManifestReader record = reader.ReadRecord();
+		std::vector<u32> const set_indices = record.ReadArray<u32>();
+		std::vector<vk::PushConstantRange> const push_constant_ranges = record.ReadArray<vk::PushConstantRange>();
+		std::vector<vk::DescriptorSetLayout> layout_sets;
+		for (u32 index : set_indices) {
+			layout_sets.push_back(index < set_layouts.size() ? set_layouts[index] : vk::DescriptorSetLayout{});
+		}
+		vk::PipelineLayout layout;
+		// Layouts with unknown sets can not be recreated
+		bool const complete = record.IsValid() && std::ranges::all_of(layout_sets, [](auto set) { return bool(set); });
+		if (complete) {
+			PipelineLayoutInfo const info{
+				.descriptor_set_layouts = layout_sets,
+				.push_constant_ranges   = push_constant_ranges,
+			};
+			layout = CreatePipelineLayout(info);
+		}
+		pipeline_layouts.push_back(layout);
+	}
+
+	std::vector<ManifestPipeline> pipelines;
+	pipelines.reserve(pipeline_count);
+	for (u32 i = 0; i < pipeline_count && reader.IsValid(); ++i) {
+		ManifestReader record = reader.ReadRecord();
+		ManifestPipeline pipeline = ReadPipeline(record);
+		if (!record.IsValid()) {
+			break;
+		}
+		pipelines.push_back(std::move(pipeline));
+	}
+
+	// Stages reference data in vectors of pipelines, which is not moved when pipelines are moved.
+	// Infos reference pipelines, which are not moved anymore
+	std::vector<PipelineInfo>         compute_infos;
+	std::vector<GraphicsPipelineInfo> graphics_infos;
+	compute_infos.reserve(pipelines.size());
+	graphics_infos.reserve(pipelines.size());
+	std::size_t skipped = 0;
+	for (auto const& pipeline : pipelines) {
+		vk::PipelineLayout const layout =
+			pipeline.layout < pipeline_layouts.size() ? pipeline_layouts[pipeline.layout] : vk::PipelineLayout{};
+		if (!layout || pipeline.stages.empty()) {
+			++skipped;
+			continue;
+		}
+		if (pipeline.type == kComputePipeline) {
+			compute_infos.push_back({.stages = pipeline.stages, .layout = layout, .name = pipeline.name});
+			continue;
+		}
+		// Base class can not be designated
+		graphics_infos.push_back(GraphicsPipelineInfo{
+			{.stages = pipeline.stages, .layout = layout, .name = pipeline.name},
+			pipeline.vertex_attributes,
+			pipeline.input_assembly,
+			pipeline.tessellation,
+			pipeline.viewport,
+			pipeline.rasterization,
+			pipeline.multisample,
+			pipeline.depth_stencil,
+			pipeline.blend_attachments,
+			pipeline.color_blend,
+			pipeline.dynamic_states,
+			pipeline.color_formats,
+			pipeline.depth_format,
+			pipeline.stencil_format,
+		});
+	}
+
+	// Created pipelines only fill pipeline cache and shader module cache, they are destroyed right away
+	if (!compute_infos.empty()) {
+		(void)CreatePipelines(std::span<PipelineInfo const>(compute_infos));
+	}
+	if (!graphics_infos.empty()) {
+		(void)CreatePipelines(std::span<GraphicsPipelineInfo const>(graphics_infos));
+	}
+
+	for (auto layout : pipeline_layouts) {
+		DestroyPipelineLayout(layout);
+	}
+	for (auto layout : set_layouts) {
+		RemoveFromPipelineManifest(layout);
+		destroyDescriptorSetLayout(layout, GetAllocator());
+	}
+	VB_LOG_TRACE("WarmUp: created %zu compute and %zu graphics pipelines, skipped %zu", compute_infos.size(),
+				 graphics_infos.size(), skipped);
+	if (!reader.IsValid()) {
+		VB_LOG_WARN("WarmUp: pipeline manifest is truncated");
+		return vk::Result::eIncomplete;
+	}
+	return vk::Result::eSuccess;
+}
+
+auto Device::WarmUpFromFile(std::string_view path) -> vk::Result {
+	std::vector<char> const data = ReadManifestFile(path);
+	if (data.empty()) {
+		VB_LOG_WARN("WarmUp: failed to read pipeline manifest %.*s", static_cast<int>(path.size()), path.data());
+		return vk::Result::eErrorInitializationFailed;
+	}
+	return WarmUp(data);
+}
+
+} // namespace VB_NAMESPACE
@@ -1,4 +1,6 @@
 #ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <atomic>
 #else
 import std;
 #endif
@@ -11,28 +13,48 @@ import vulkan_hpp;
 
 #include "vulkan_backend/interface/queue/queue.hpp"
 #include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/macros.hpp"
 #include "vulkan_backend/vk_result.hpp"
 
 namespace VB_NAMESPACE {
 // Queue::Queue(vk::Queue queue, Device& device, u32 family, u32 index, vk::QueueFlags flags)
 // 	: vk::Queue(queue), device(&device), family(family), index(index), flags(flags) {}
 
-void Queue::Submit(
+auto Queue::Submit(
 		std::span<vk::CommandBufferSubmitInfo const> cmds,
 		vk::Fence fence,
-		SubmitInfo const& info) const {
+		SubmitInfo const& info) const -> SubmitTicket {
+	VB_VLA(vk::SemaphoreSubmitInfo, signal_infos, info.signalSemaphoreInfos.size() + 1);
+	std::copy(info.signalSemaphoreInfos.begin(), info.signalSemaphoreInfos.end(), signal_infos.begin());
+	signal_infos.back() = GetNextTimelineSignal();
+	u64 const value = signal_infos.back().value;
 
 	vk::SubmitInfo2 submitInfo {
 		.waitSemaphoreInfoCount = static_cast<u32>(info.waitSemaphoreInfos.size()),
 		.pWaitSemaphoreInfos = info.waitSemaphoreInfos.data(),
 		.commandBufferInfoCount = static_cast<u32>(cmds.size()),
 		.pCommandBufferInfos = cmds.data(),
-		.signalSemaphoreInfoCount = static_cast<u32>(info.signalSemaphoreInfos.size()),
-		.pSignalSemaphoreInfos = info.signalSemaphoreInfos.data(),
+		.signalSemaphoreInfoCount = static_cast<u32>(signal_infos.size()),
+		.pSignalSemaphoreInfos = signal_infos.data(),
 	};
 
 	auto result = submit2(submitInfo, fence);
 	VB_CHECK_VK_RESULT(result, "Failed to submit command buffer");
+	SetSubmitted(value);
+	return {this, value};
+}
+
+auto Queue::GetNextTimelineSignal() const -> vk::SemaphoreSubmitInfo {
+	// Submissions to a queue are externally synchronized, so values grow in submission order
+	return {
+		.semaphore = timeline,
+		.value     = std::atomic_ref(submitted_value).load(std::memory_order_relaxed) + 1,
+		.stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+	};
+}
+
+void Queue::SetSubmitted(u64 value) const {
+	std::atomic_ref(submitted_value).store(value, std::memory_order_release);
 }
 
 void Queue::Wait() const {
@@ -40,6 +62,51 @@ void Queue::Wait() const {
 	VB_CHECK_VK_RESULT(result, "Failed to wait queue idle");
 }
 
+auto Queue::Wait(SubmitTicket const& ticket, u64 timeout) const -> bool {
+	if (IsComplete(ticket)) {
+		return true;
+	}
+	vk::SemaphoreWaitInfo wait_info{
+		.semaphoreCount = 1,
+		.pSemaphores    = &timeline,
+		.pValues        = &ticket.value,
+	};
+	auto result = device->waitSemaphores(&wait_info, timeout);
+	if (result == vk::Result::eTimeout) {
+		return false;
+	}
+	VB_CHECK_VK_RESULT(result, "Failed to wait for timeline semaphore");
+	UpdateCompleted(ticket.value);
+	return true;
+}
+
+auto Queue::IsComplete(SubmitTicket const& ticket) const -> bool {
+	VB_ASSERT(ticket.queue == nullptr || ticket.queue == this, "Ticket is from another queue");
+	if (ticket.value <= std::atomic_ref(completed_value).load(std::memory_order_acquire)) {
+		return true;
+	}
+	u64  value;
+	auto result = device->getSemaphoreCounterValue(timeline, &value);
+	VB_CHECK_VK_RESULT(result, "Failed to get timeline semaphore value");
+	UpdateCompleted(value);
+	return ticket.value <= value;
+}
+
+void Queue::UpdateCompleted(u64 value) const {
+	std::atomic_ref completed(completed_value);
+	u64 current = completed.load(std::memory_order_relaxed);
+	while (current < value && !completed.compare_exchange_weak(current, value, std::memory_order_release)) {
+	}
+}
+
+auto Queue::GetLastSubmitted() const -> SubmitTicket {
+	return {this, std::atomic_ref(submitted_value).load(std::memory_order_acquire)};
+}
+
+auto Queue::GetTimelineSemaphore() const -> vk::Semaphore {
+	return timeline;
+}
+
 
 auto Queue::GetFamilyIndex() const -> u32 {
 	return family;
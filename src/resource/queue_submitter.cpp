@@ -0,0 +1,191 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/queue/queue_submitter.hpp"
+#include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/interface/queue/queue.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+QueueSubmitter::QueueSubmitter(Queue const& queue, QueueSubmitterInfo const& info)
+	: queue(&queue), info(info), first_value(queue.GetLastSubmitted().value) {
+	u64 const capacity = std::bit_ceil(std::max(info.capacity, 2u));
+	this->info.max_batch = std::max(info.max_batch, 1u);
+	slots = std::make_unique<Slot[]>(capacity);
+	mask  = capacity - 1;
+	for (u64 i = 0; i < capacity; ++i) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	thread = std::thread(&QueueSubmitter::SubmitLoop, this);
+}
+
+QueueSubmitter::~QueueSubmitter() {
+	stop.store(true, std::memory_order_release);
+	published.fetch_add(1, std::memory_order_release);
+	published.notify_one();
+	thread.join();
+}
+
+auto QueueSubmitter::Submit(Command& cmd, SubmitInfo const& submit_info) -> SubmitTicket {
+	// Dropping semaphores would break synchronization, so the submission is rejected
+	if (submit_info.waitSemaphoreInfos.size() > QueueSubmitterInfo::kMaxSemaphores ||
+		submit_info.signalSemaphoreInfos.size() > QueueSubmitterInfo::kMaxSemaphores) [[unlikely]] {
+		VB_LOG_ERROR("Too many semaphores for QueueSubmitter: %zu waits, %zu signals, at most %u of each",
+					 submit_info.waitSemaphoreInfos.size(), submit_info.signalSemaphoreInfos.size(),
+					 QueueSubmitterInfo::kMaxSemaphores);
+		return {};
+	}
+
+	// Claim a free slot
+	u64   position = enqueue_position.load(std::memory_order_relaxed);
+	Slot* slot;
+	bool  counted_full = false;
+	while (true) {
+		slot = &slots[position & mask];
+		u64 const sequence = slot->sequence.load(std::memory_order_acquire);
+		auto const diff	   = static_cast<std::int64_t>(sequence - position);
+		if (diff == 0) {
+			if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// Full, slot is still used by position - capacity
+			if (!counted_full) {
+				full_waits.fetch_add(1, std::memory_order_relaxed);
+				counted_full = true;
+			}
+			std::this_thread::yield();
+			position = enqueue_position.load(std::memory_order_relaxed);
+		} else {
+			position = enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->command_buffer = cmd;
+	slot->wait_count	 = static_cast<u32>(submit_info.waitSemaphoreInfos.size());
+	slot->signal_count	 = static_cast<u32>(submit_info.signalSemaphoreInfos.size());
+	std::copy(submit_info.waitSemaphoreInfos.begin(), submit_info.waitSemaphoreInfos.end(), slot->waits.begin());
+	std::copy(submit_info.signalSemaphoreInfos.begin(), submit_info.signalSemaphoreInfos.end(), slot->signals.begin());
+	slot->sequence.store(position + 1, std::memory_order_release);
+
+	u32 const depth = static_cast<u32>(position + 1 - dequeue_position.load(std::memory_order_relaxed));
+	u32 max			= max_depth.load(std::memory_order_relaxed);
+	while (depth > max && !max_depth.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+	}
+
+	published.fetch_add(1, std::memory_order_release);
+	published.notify_one();
+
+	cmd.ticket = {queue, first_value + position + 1};
+	return cmd.ticket;
+}
+
+void QueueSubmitter::SubmitLoop() {
+	std::vector<vk::SubmitInfo2>			 submit_infos;
+	std::vector<vk::CommandBufferSubmitInfo> command_infos;
+	std::vector<vk::SemaphoreSubmitInfo>	 semaphore_infos;
+	submit_infos.reserve(info.max_batch);
+	command_infos.reserve(info.max_batch);
+	// Pointers into semaphore_infos must stay valid
+	semaphore_infos.reserve(info.max_batch * QueueSubmitterInfo::kMaxSemaphores * 2 + 1);
+
+	u64 position = dequeue_position.load(std::memory_order_relaxed);
+	while (true) {
+		u64 const seen = published.load(std::memory_order_acquire);
+		auto is_ready  = [&] {
+			return slots[position & mask].sequence.load(std::memory_order_acquire) == position + 1;
+		};
+		if (!is_ready()) {
+			if (stop.load(std::memory_order_acquire) &&
+				enqueue_position.load(std::memory_order_acquire) == position) {
+				break;
+			}
+			// Also wakes up if slot is claimed but not filled yet, sleeps again until it is
+			published.wait(seen, std::memory_order_acquire);
+			continue;
+		}
+
+		// Give submissions arriving close together a chance to share the submit2
+		if (info.coalesce_window > std::chrono::nanoseconds::zero()) {
+			auto const deadline = std::chrono::steady_clock::now() + info.coalesce_window;
+			while (enqueue_position.load(std::memory_order_relaxed) - position < info.max_batch &&
+				   std::chrono::steady_clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+		}
+
+		submit_infos.clear();
+		command_infos.clear();
+		semaphore_infos.clear();
+		while (submit_infos.size() < info.max_batch && is_ready()) {
+			Slot& slot = slots[position & mask];
+			command_infos.push_back({.commandBuffer = slot.command_buffer});
+			auto const waits = semaphore_infos.insert(semaphore_infos.end(), slot.waits.begin(),
+													   slot.waits.begin() + slot.wait_count);
+			auto const signals = semaphore_infos.insert(semaphore_infos.end(), slot.signals.begin(),
+														 slot.signals.begin() + slot.signal_count);
+			submit_infos.push_back({
+				.waitSemaphoreInfoCount	  = slot.wait_count,
+				.pWaitSemaphoreInfos	  = std::to_address(waits),
+				.commandBufferInfoCount	  = 1,
+				.pCommandBufferInfos	  = &command_infos.back(),
+				.signalSemaphoreInfoCount = slot.signal_count,
+				.pSignalSemaphoreInfos	  = std::to_address(signals),
+			});
+			// Release slot for position + capacity
+			slot.sequence.store(position + mask + 1, std::memory_order_release);
+			++position;
+		}
+
+		// Signal operations include all commands earlier in submission order,
+		// so signaling the value of the last submission after the last entry covers all of them
+		u64 const value = first_value + position;
+		semaphore_infos.push_back({
+			.semaphore = queue->timeline,
+			.value	   = value,
+			.stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+		});
+		auto& last = submit_infos.back();
+		if (last.signalSemaphoreInfoCount == 0) {
+			last.pSignalSemaphoreInfos = &semaphore_infos.back();
+		}
+		// Signals of the last entry are at the end of semaphore_infos, followed by the timeline signal
+		++last.signalSemaphoreInfoCount;
+
+		auto result = queue->submit2(static_cast<u32>(submit_infos.size()), submit_infos.data(), nullptr);
+		VB_CHECK_VK_RESULT(result, "Failed to submit command buffers");
+		queue->SetSubmitted(value);
+		dequeue_position.store(position, std::memory_order_release);
+		submit_calls.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+auto QueueSubmitter::GetStats() const -> QueueSubmitterStats {
+	u64 const dequeued = dequeue_position.load(std::memory_order_acquire);
+	return {
+		.submissions  = dequeued,
+		.submit_calls = submit_calls.load(std::memory_order_relaxed),
+		.full_waits	  = full_waits.load(std::memory_order_relaxed),
+		.depth		  = static_cast<u32>(enqueue_position.load(std::memory_order_relaxed) - dequeued),
+		.max_depth	  = max_depth.load(std::memory_order_relaxed),
+	};
+}
+} // namespace VB_NAMESPACE
@@ -0,0 +1,469 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#ifndef VB_USE_VMA_MODULE
+#include <vk_mem_alloc.h>
+#else
+import vk_mem_alloc;
+#endif
+
+#include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/physical_device/physical_device.hpp"
+#include "vulkan_backend/interface/render_graph/render_graph.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/hash_functions.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+template <typename T>
+auto HashValue(T const& value, u64 hash) -> u64 {
+	return HashFnv1a64(reinterpret_cast<char const*>(&value), sizeof(value), hash);
+}
+
+// Accesses to same memory from different states to combine for the next user of it
+void MergeAccessState(AccessState& state, AccessState const& other) {
+	state.write_stages |= other.write_stages;
+	state.write_access |= other.write_access;
+	state.read_stages |= other.read_stages;
+	state.read_access |= other.read_access;
+}
+} // namespace
+
+RenderGraph::RenderGraph(Device& device) { Create(device); }
+
+RenderGraph::~RenderGraph() { Free(); }
+
+void RenderGraph::Create(Device& device) { ResourceBase::SetOwner(&device); }
+
+void RenderGraph::Reset() {
+	resources.clear();
+	accesses.clear();
+	passes.clear();
+}
+
+auto RenderGraph::CreateImage(RenderGraphImageInfo const& info) -> RenderGraphImage {
+	VB_ASSERT(info.array_layers == 1 || info.array_layers == 6, "Layered transient images are cube maps");
+	resources.push_back({.name = std::string(info.name), .is_image = true, .image_info = info});
+	return {static_cast<u32>(resources.size() - 1)};
+}
+
+auto RenderGraph::CreateBuffer(RenderGraphBufferInfo const& info) -> RenderGraphBuffer {
+	resources.push_back({.name = std::string(info.name), .is_image = false, .buffer_info = info});
+	return {static_cast<u32>(resources.size() - 1)};
+}
+
+auto RenderGraph::ImportImage(Image& image) -> RenderGraphImage {
+	resources.push_back({.name = std::string(image.GetName()), .is_image = true, .imported_image = &image});
+	return {static_cast<u32>(resources.size() - 1)};
+}
+
+auto RenderGraph::ImportBuffer(Buffer& buffer) -> RenderGraphBuffer {
+	resources.push_back({.name = std::string(buffer.GetName()), .is_image = false, .imported_buffer = &buffer});
+	return {static_cast<u32>(resources.size() - 1)};
+}
+
+void RenderGraph::AddPass(RenderGraphPassInfo const& info) {
+	u32 const first_access = static_cast<u32>(accesses.size());
+	for (auto const& use : info.images) {
+		VB_ASSERT(use.image.index < resources.size() && resources[use.image.index].is_image, "Invalid image handle");
+		accesses.push_back({use.image.index, use.stages, use.access, use.layout});
+	}
+	for (auto const& use : info.buffers) {
+		VB_ASSERT(use.buffer.index < resources.size() && !resources[use.buffer.index].is_image, "Invalid buffer handle");
+		accesses.push_back({use.buffer.index, use.stages, use.access, vk::ImageLayout::eUndefined});
+	}
+	passes.push_back({
+		.name         = std::string(info.name),
+		.first_access = first_access,
+		.access_count = static_cast<u32>(accesses.size()) - first_access,
+		.execute      = info.execute,
+		.side_effects = info.side_effects,
+	});
+}
+
+auto RenderGraph::GetTopologyHash() const -> u64 {
+	u64 hash = kFnv1a64OffsetBasis;
+	hash = HashValue(resources.size(), hash);
+	for (auto const& resource : resources) {
+		bool const imported = resource.imported_image || resource.imported_buffer;
+		hash = HashValue(resource.is_image, hash);
+		hash = HashValue(imported, hash);
+		if (imported) {
+			continue;
+		}
+		if (resource.is_image) {
+			auto const& info = resource.image_info;
+			hash = HashValue(info.format, hash);
+			hash = HashValue(info.extent.width, hash);
+			hash = HashValue(info.extent.height, hash);
+			hash = HashValue(static_cast<VkImageUsageFlags>(info.usage), hash);
+			hash = HashValue(static_cast<VkImageAspectFlags>(info.aspect), hash);
+			hash = HashValue(info.mip_levels, hash);
+			hash = HashValue(info.array_layers, hash);
+		} else {
+			hash = HashValue(resource.buffer_info.size, hash);
+			hash = HashValue(static_cast<VkBufferUsageFlags>(resource.buffer_info.usage), hash);
+		}
+	}
+	hash = HashValue(passes.size(), hash);
+	for (auto const& pass : passes) {
+		hash = HashValue(pass.side_effects, hash);
+		hash = HashValue(pass.access_count, hash);
+	}
+	for (auto const& access : accesses) {
+		hash = HashValue(access.resource, hash);
+		hash = HashValue(static_cast<VkPipelineStageFlags2>(access.stages), hash);
+		hash = HashValue(static_cast<VkAccessFlags2>(access.access), hash);
+		hash = HashValue(access.layout, hash);
+	}
+	return hash;
+}
+
+void RenderGraph::Compile() {
+	FreeTransients();
+	compiled_hash = GetTopologyHash();
+	compiled      = true;
+	u32 const pass_count     = static_cast<u32>(passes.size());
+	u32 const resource_count = static_cast<u32>(resources.size());
+	auto const pass_accesses = [this](Pass const& pass) {
+		return std::span(accesses).subspan(pass.first_access, pass.access_count);
+	};
+	auto const is_imported = [this](u32 resource) {
+		return resources[resource].imported_image || resources[resource].imported_buffer;
+	};
+
+	// Cull passes from last to first: a pass is used if it writes a resource read by a used pass
+	// or an imported resource. Partial writes are possible, so earlier writers of a read resource stay used
+	std::vector<bool> used_passes(pass_count);
+	std::vector<bool> read_resources(resource_count);
+	for (u32 pass_index = pass_count; pass_index-- > 0;) {
+		Pass const& pass = passes[pass_index];
+		bool        used = pass.side_effects;
+		for (auto const& access : pass_accesses(pass)) {
+			if (access.access & kWriteAccess) {
+				used |= is_imported(access.resource) || read_resources[access.resource];
+			}
+		}
+		if (!used) {
+			continue;
+		}
+		used_passes[pass_index] = true;
+		for (auto const& access : pass_accesses(pass)) {
+			read_resources[access.resource] = true;
+		}
+	}
+
+	// Batch of a pass follows batches of passes it depends on: writes depend on all earlier accesses,
+	// reads on the last write and on reads in other layouts
+	struct ResourceState {
+		i32             last_write  = -1;
+		i32             last_read   = -1;
+		vk::ImageLayout read_layout = vk::ImageLayout::eUndefined;
+	};
+	std::vector<ResourceState> states(resource_count);
+	std::vector<u32>           pass_batches(pass_count);
+	u32                        batch_count = 0;
+	for (u32 pass_index = 0; pass_index < pass_count; ++pass_index) {
+		if (!used_passes[pass_index]) {
+			continue;
+		}
+		i32 batch = 0;
+		for (auto const& access : pass_accesses(passes[pass_index])) {
+			auto const& state = states[access.resource];
+			batch             = std::max(batch, state.last_write + 1);
+			if ((access.access & kWriteAccess) || access.layout != state.read_layout) {
+				batch = std::max(batch, state.last_read + 1);
+			}
+		}
+		for (auto const& access : pass_accesses(passes[pass_index])) {
+			auto& state = states[access.resource];
+			if (access.access & kWriteAccess) {
+				state = {.last_write = batch};
+			} else {
+				// A read in the same layout may land before earlier reads, writers must follow all of them
+				state.last_read   = std::max(state.last_read, batch);
+				state.read_layout = access.layout;
+			}
+		}
+		pass_batches[pass_index] = batch;
+		batch_count              = std::max(batch_count, static_cast<u32>(batch) + 1);
+	}
+
+	// Stable order by batch keeps declaration order of passes inside a batch
+	schedule.clear();
+	batch_offsets.assign(batch_count + 1, 0);
+	for (u32 pass_index = 0; pass_index < pass_count; ++pass_index) {
+		if (used_passes[pass_index]) {
+			schedule.push_back(pass_index);
+			++batch_offsets[pass_batches[pass_index] + 1];
+		}
+	}
+	std::stable_sort(schedule.begin(), schedule.end(),
+					 [&](u32 lhs, u32 rhs) { return pass_batches[lhs] < pass_batches[rhs]; });
+	std::partial_sum(batch_offsets.begin(), batch_offsets.end(), batch_offsets.begin());
+
+	// Lifetimes of transient resources used by scheduled passes
+	resource_transients.assign(resource_count, kInvalidRenderGraphResource);
+	for (u32 pass_index : schedule) {
+		u32 const batch = pass_batches[pass_index];
+		for (auto const& access : pass_accesses(passes[pass_index])) {
+			if (is_imported(access.resource)) {
+				continue;
+			}
+			u32& transient = resource_transients[access.resource];
+			if (transient == kInvalidRenderGraphResource) {
+				transient = static_cast<u32>(transients.size());
+				transients.emplace_back();
+				transients.back().resource    = access.resource;
+				transients.back().first_batch = batch;
+			}
+			transients[transient].last_batch = batch;
+		}
+	}
+
+	// Memory requirements. Buffer::Create() pads size by less than minStorageBufferOffsetAlignment
+	vk::DeviceSize const buffer_padding =
+		GetDevice().GetPhysicalDevice().GetProperties().GetCore10().limits.minStorageBufferOffsetAlignment;
+	auto const make_image_create_info = [](RenderGraphImageInfo const& info) -> vk::ImageCreateInfo {
+		return {
+			// Image::Create() makes cube views for layered images
+			.flags         = info.array_layers == 6 ? vk::ImageCreateFlagBits::eCubeCompatible : vk::ImageCreateFlags{},
+			.imageType     = vk::ImageType::e2D,
+			.format        = info.format,
+			.extent        = {info.extent.width, info.extent.height, 1},
+			.mipLevels     = info.mip_levels,
+			.arrayLayers   = info.array_layers,
+			.samples       = vk::SampleCountFlagBits::e1,
+			.tiling        = vk::ImageTiling::eOptimal,
+			.usage         = info.usage,
+			.sharingMode   = vk::SharingMode::eExclusive,
+			.initialLayout = vk::ImageLayout::eUndefined,
+		};
+	};
+	auto const make_buffer_create_info = [](RenderGraphBufferInfo const& info) -> vk::BufferCreateInfo {
+		return {
+			.size        = info.size,
+			.usage       = info.usage,
+			.sharingMode = vk::SharingMode::eExclusive,
+		};
+	};
+	for (auto& transient : transients) {
+		Resource const&         resource = resources[transient.resource];
+		vk::MemoryRequirements2 requirements;
+		if (resource.is_image) {
+			vk::ImageCreateInfo const             create_info = make_image_create_info(resource.image_info);
+			vk::DeviceImageMemoryRequirements const info{.pCreateInfo = &create_info};
+			GetDevice().getImageMemoryRequirements(&info, &requirements);
+		} else {
+			vk::BufferCreateInfo create_info = make_buffer_create_info(resource.buffer_info);
+			create_info.size += buffer_padding;
+			vk::DeviceBufferMemoryRequirements const info{.pCreateInfo = &create_info};
+			GetDevice().getBufferMemoryRequirements(&info, &requirements);
+		}
+		transient.requirements = requirements.memoryRequirements;
+	}
+
+	// Largest first into the first memory block whose transients all have disjoint lifetimes
+	std::vector<u32> by_size(transients.size());
+	std::iota(by_size.begin(), by_size.end(), 0);
+	std::stable_sort(by_size.begin(), by_size.end(), [this](u32 lhs, u32 rhs) {
+		return transients[lhs].requirements.size > transients[rhs].requirements.size;
+	});
+	for (u32 index : by_size) {
+		Transient& transient = transients[index];
+		auto const fits      = [&](MemoryBlock const& block) {
+			return (block.requirements.memoryTypeBits & transient.requirements.memoryTypeBits) &&
+				   std::none_of(block.transients.begin(), block.transients.end(), [&](u32 other) {
+					   return transients[other].first_batch <= transient.last_batch &&
+							  transient.first_batch <= transients[other].last_batch;
+				   });
+		};
+		auto block = std::find_if(memories.begin(), memories.end(), fits);
+		if (block == memories.end()) {
+			memories.push_back({.requirements = transient.requirements});
+			block = std::prev(memories.end());
+		}
+		block->requirements.size      = std::max(block->requirements.size, transient.requirements.size);
+		block->requirements.alignment = std::max(block->requirements.alignment, transient.requirements.alignment);
+		block->requirements.memoryTypeBits &= transient.requirements.memoryTypeBits;
+		block->transients.push_back(index);
+		transient.memory = static_cast<u32>(block - memories.begin());
+	}
+
+	// Allocate memory and bind transient resources to it
+	VmaAllocationCreateInfo const allocation_info = {
+		.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+	};
+	for (auto& block : memories) {
+		VB_VK_RESULT result = vk::Result(vmaAllocateMemory(
+			GetDevice().GetVmaAllocator(), reinterpret_cast<VkMemoryRequirements const*>(&block.requirements),
+			&allocation_info, &block.allocation, nullptr));
+		VB_CHECK_VK_RESULT(result, "Failed to allocate render graph memory!");
+		stats.allocated_size += block.requirements.size;
+	}
+	for (auto& transient : transients) {
+		Resource const& resource   = resources[transient.resource];
+		VmaAllocation   allocation = memories[transient.memory].allocation;
+		if (resource.is_image) {
+			transient.image.Create(GetDevice(), {
+				.create_info      = make_image_create_info(resource.image_info),
+				.aspect           = resource.image_info.aspect,
+				.name             = resource.name,
+				.alias_allocation = allocation,
+			});
+		} else {
+			transient.buffer.Create(GetDevice(), {
+				.create_info      = make_buffer_create_info(resource.buffer_info),
+				.name             = resource.name,
+				.alias_allocation = allocation,
+			});
+		}
+		stats.required_size += transient.requirements.size;
+	}
+
+	stats.passes              = static_cast<u32>(schedule.size());
+	stats.culled_passes       = pass_count - stats.passes;
+	stats.barrier_batches     = batch_count;
+	stats.transient_resources = static_cast<u32>(transients.size());
+	stats.allocations         = static_cast<u32>(memories.size());
+	++stats.compilations;
+	VB_LOG_TRACE("[ RenderGraph ] passes = %u, culled = %u, batches = %u, transients = %u, allocations = %u",
+				 stats.passes, stats.culled_passes, stats.barrier_batches, stats.transient_resources, stats.allocations);
+}
+
+void RenderGraph::Execute(Command& cmd) {
+	if (!compiled || GetTopologyHash() != compiled_hash) {
+		Compile();
+	}
+	for (u32 batch = 0; batch + 1 < batch_offsets.size(); ++batch) {
+		for (u32 transient = 0; transient < transients.size(); ++transient) {
+			if (transients[transient].first_batch == batch) {
+				AcquireMemory(transient);
+			}
+		}
+		// Barriers of all passes in batch are recorded together
+		for (u32 i = batch_offsets[batch]; i < batch_offsets[batch + 1]; ++i) {
+			Pass const& pass = passes[schedule[i]];
+			for (u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a) {
+				Access const& access = accesses[a];
+				if (resources[access.resource].is_image) {
+					cmd.Access(GetImage({access.resource}), access.stages, access.access, access.layout);
+				} else {
+					cmd.Access(GetBuffer({access.resource}), access.stages, access.access);
+				}
+			}
+		}
+		// Not an action command, so commands of passes that declare their accesses again need no other barrier
+		cmd.RecordBarriers();
+		for (u32 i = batch_offsets[batch]; i < batch_offsets[batch + 1]; ++i) {
+			Pass const& pass = passes[schedule[i]];
+			// Passes of a batch are independent, so barriers of the batch cover the first
+			// action command of each pass, not only of the first one
+			for (u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a) {
+				Access const& access = accesses[a];
+				if (resources[access.resource].is_image) {
+					cmd.ContinuePendingScope(GetImage({access.resource}));
+				} else {
+					cmd.ContinuePendingScope(GetBuffer({access.resource}));
+				}
+			}
+			if (pass.execute) {
+				pass.execute(cmd);
+			}
+		}
+	}
+}
+
+void RenderGraph::AcquireMemory(u32 index) {
+	Transient&   transient = transients[index];
+	MemoryBlock& block     = memories[transient.memory];
+	// Previous user of the memory in this or last execution, its accesses must finish before ours
+	AccessState state;
+	if (block.last_transient != kInvalidRenderGraphResource) {
+		Transient const& previous = transients[block.last_transient];
+		if (resources[previous.resource].is_image) {
+			state = previous.image.access_state;
+			for (auto const& subresource : previous.image.subresource_states) {
+				MergeAccessState(state, subresource.access);
+			}
+		} else {
+			state = previous.buffer.access_state;
+		}
+	}
+	block.last_transient = index;
+	if (resources[transient.resource].is_image) {
+		// Contents are discarded, first access transitions from undefined layout
+		transient.image.SetLayout(vk::ImageLayout::eUndefined);
+		transient.image.access_state = state;
+	} else {
+		transient.buffer.access_state = state;
+	}
+}
+
+auto RenderGraph::GetImage(RenderGraphImage image) -> Image& {
+	VB_ASSERT(image.index < resources.size() && resources[image.index].is_image, "Invalid image handle");
+	Resource const& resource = resources[image.index];
+	if (resource.imported_image) {
+		return *resource.imported_image;
+	}
+	VB_ASSERT(compiled && resource_transients[image.index] != kInvalidRenderGraphResource,
+			  "Transient image is not used by any scheduled pass");
+	return transients[resource_transients[image.index]].image;
+}
+
+auto RenderGraph::GetBuffer(RenderGraphBuffer buffer) -> Buffer& {
+	VB_ASSERT(buffer.index < resources.size() && !resources[buffer.index].is_image, "Invalid buffer handle");
+	Resource const& resource = resources[buffer.index];
+	if (resource.imported_buffer) {
+		return *resource.imported_buffer;
+	}
+	VB_ASSERT(compiled && resource_transients[buffer.index] != kInvalidRenderGraphResource,
+			  "Transient buffer is not used by any scheduled pass");
+	return transients[resource_transients[buffer.index]].buffer;
+}
+
+void RenderGraph::FreeTransients() {
+	// Resources before the memory they are bound to
+	transients.clear();
+	for (auto& block : memories) {
+		vmaFreeMemory(GetDevice().GetVmaAllocator(), block.allocation);
+	}
+	memories.clear();
+	resource_transients.clear();
+	stats.required_size  = 0;
+	stats.allocated_size = 0;
+	compiled             = false;
+}
+
+auto RenderGraph::GetResourceTypeName() const -> char const* { return "RenderGraphResource"; }
+
+void RenderGraph::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, transients = %zu", GetResourceTypeName(), transients.size());
+	FreeTransients();
+	Reset();
+	schedule.clear();
+	batch_offsets.clear();
+}
+
+} // namespace VB_NAMESPACE
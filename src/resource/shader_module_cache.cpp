@@ -0,0 +1,162 @@
+#ifndef VB_USE_STD_MODULE
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/compile_shader.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/shader_module_cache/shader_module_cache.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/hash_functions.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+// Key of stage source that does not require loading SPIR-V
+auto GetSourceKey(PipelineStage const& stage) -> u64 {
+	if (stage.source.type == Source::Type::RawSpirV) {
+		return HashFnv1a64(stage.source.data);
+	}
+	if (stage.source.type == Source::Type::FileSpirV) {
+		// File may be rewritten with the same name
+		std::error_code ec;
+		std::filesystem::path const path = stage.source.data;
+		auto const time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+		auto const size = std::filesystem::file_size(path, ec);
+		u64 hash = HashFnv1a64(stage.source.data);
+		hash = HashFnv1a64(reinterpret_cast<char const*>(&time), sizeof(time), hash);
+		return HashFnv1a64(reinterpret_cast<char const*>(&size), sizeof(size), hash);
+	}
+	return GetShaderCacheKey(stage);
+}
+} // namespace
+
+ShaderModuleCache::ShaderModuleCache(Device& device, bool use_identifiers) { Create(device, use_identifiers); }
+
+ShaderModuleCache::~ShaderModuleCache() { Free(); }
+
+void ShaderModuleCache::Create(Device& device, bool use_identifiers) {
+	ResourceBase::SetOwner(&device);
+	this->use_identifiers = use_identifiers;
+}
+
+auto ShaderModuleCache::Get(PipelineStage const& stage, bool allow_identifier)
+	-> std::shared_ptr<CachedShaderModule const> {
+	u64 const source_key = GetSourceKey(stage);
+	{
+		std::lock_guard lock(mutex);
+		if (auto source = sources.find(source_key); source != sources.end()) {
+			if (auto it = modules_by_hash.find(source->second.hash); it != modules_by_hash.end()) {
+				++stats.hits;
+				return it->second;
+			}
+			if (allow_identifier && !source->second.identifier.empty()) {
+				++stats.identifier_hits;
+				auto identifier_only        = std::make_shared<CachedShaderModule>();
+				identifier_only->hash       = source->second.hash;
+				identifier_only->identifier = source->second.identifier;
+				return identifier_only;
+			}
+		}
+		++stats.misses;
+	}
+
+	auto entry = std::make_shared<CachedShaderModule>();
+	{
+		ShaderCode const code = LoadShaderCode(stage);
+		if (code.IsEmpty()) {
+			// Error is already logged, nothing is cached so the source is loaded again next time
+			return nullptr;
+		}
+		entry->hash = HashFnv1a64(reinterpret_cast<char const*>(code.GetData()), code.GetSize());
+		entry->spirv.assign(code.GetData(), code.GetData() + code.GetSize() / sizeof(u32));
+	}
+
+	{
+		// Same SPIR-V from another source, e.g. precompiled and compiled at runtime
+		std::lock_guard lock(mutex);
+		if (auto it = modules_by_hash.find(entry->hash); it != modules_by_hash.end()) {
+			sources.insert_or_assign(source_key, SourceRecord{entry->hash, it->second->identifier});
+			return it->second;
+		}
+	}
+
+	vk::ShaderModuleCreateInfo create_info{
+		.codeSize = entry->spirv.size() * sizeof(u32),
+		.pCode    = entry->spirv.data(),
+	};
+	VB_VK_RESULT result = GetDevice().createShaderModule(&create_info, GetDevice().GetAllocator(), &entry->module);
+	VB_CHECK_VK_RESULT(result, "Failed to create shader module!");
+	if (result != vk::Result::eSuccess) {
+		return nullptr;
+	}
+	if (use_identifiers) {
+		vk::ShaderModuleIdentifierEXT identifier{};
+		GetDevice().getShaderModuleIdentifierEXT(entry->module, &identifier);
+		entry->identifier.assign(identifier.identifier.begin(),
+								 identifier.identifier.begin() + identifier.identifierSize);
+	}
+
+	std::lock_guard lock(mutex);
+	// Another thread might have created the same module meanwhile
+	auto [it, inserted] = modules_by_hash.try_emplace(entry->hash, entry);
+	if (!inserted) {
+		GetDevice().destroyShaderModule(entry->module, GetDevice().GetAllocator());
+	} else {
+		stats.spirv_bytes += entry->spirv.size() * sizeof(u32);
+	}
+	sources.insert_or_assign(source_key, SourceRecord{it->second->hash, it->second->identifier});
+	return it->second;
+}
+
+void ShaderModuleCache::Trim() {
+	std::lock_guard lock(mutex);
+	std::erase_if(modules_by_hash, [this](auto const& pair) {
+		auto const& [hash, entry] = pair;
+		if (entry.use_count() > 1)
+			return false;
+		GetDevice().destroyShaderModule(entry->module, GetDevice().GetAllocator());
+		stats.spirv_bytes -= entry->spirv.size() * sizeof(u32);
+		return true;
+	});
+	if (!use_identifiers) {
+		// Without identifiers source records only save hashing of sources
+		std::erase_if(sources, [this](auto const& pair) { return !modules_by_hash.contains(pair.second.hash); });
+	}
+}
+
+auto ShaderModuleCache::GetStats() const -> ShaderModuleCacheStats {
+	std::lock_guard lock(mutex);
+	ShaderModuleCacheStats result = stats;
+	result.modules = modules_by_hash.size();
+	return result;
+}
+
+auto ShaderModuleCache::GetResourceTypeName() const -> char const* { return "ShaderModuleCacheResource"; }
+
+void ShaderModuleCache::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, modules = %zu", GetResourceTypeName(), modules_by_hash.size());
+	for (auto& [hash, entry] : modules_by_hash) {
+		GetDevice().destroyShaderModule(entry->module, GetDevice().GetAllocator());
+	}
+	modules_by_hash.clear();
+	sources.clear();
+	stats = {};
+}
+
+} // namespace VB_NAMESPACE
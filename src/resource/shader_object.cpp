@@ -0,0 +1,88 @@
+#ifndef VB_USE_STD_MODULE
+#include <utility>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/compile_shader.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/shader_object/shader_object.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/format.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+ShaderObject::ShaderObject(Device& device, ShaderObjectInfo const& info) {
+	VB_VK_RESULT result = Create(device, info);
+}
+
+ShaderObject::ShaderObject(ShaderObject&& other)
+	: Named(std::move(other)), ResourceBase<Device>(std::move(other)), shader(std::exchange(other.shader, {})),
+	  stage(other.stage) {}
+
+ShaderObject& ShaderObject::operator=(ShaderObject&& other) {
+	if (this != &other) {
+		Free();
+		Named::operator=(std::move(other));
+		ResourceBase::operator=(std::move(other));
+		shader = std::exchange(other.shader, {});
+		stage  = other.stage;
+	}
+	return *this;
+}
+
+ShaderObject::~ShaderObject() { Free(); }
+
+auto ShaderObject::Create(Device& device, ShaderObjectInfo const& info) -> vk::Result {
+	// Shader created before is replaced
+	Free();
+	ResourceBase::SetOwner(&device);
+	SetName(info.name);
+	stage = info.stage.stage;
+	if (!device.IsShaderObjectEnabled()) {
+		VB_VERIFY_VK_RESULT(vk::Result::eErrorExtensionNotPresent, info.check_vk_results,
+							"VK_EXT_shader_object is not enabled on device!", {});
+	}
+
+	ShaderCode const code = LoadShaderCode(info.stage);
+	if (code.IsEmpty()) {
+		// Load error is already logged
+		VB_VERIFY_VK_RESULT(vk::Result::eErrorInitializationFailed, info.check_vk_results,
+							"Failed to load shader code for shader object!", {});
+	}
+	vk::ShaderCreateInfoEXT create_info{
+		.stage                  = info.stage.stage,
+		.nextStage              = info.next_stages,
+		.codeType               = vk::ShaderCodeTypeEXT::eSpirv,
+		.codeSize               = code.GetSize(),
+		.pCode                  = code.GetData(),
+		.pName                  = info.stage.entry_point.data(),
+		.setLayoutCount         = static_cast<u32>(info.descriptor_set_layouts.size()),
+		.pSetLayouts            = info.descriptor_set_layouts.data(),
+		.pushConstantRangeCount = static_cast<u32>(info.push_constant_ranges.size()),
+		.pPushConstantRanges    = info.push_constant_ranges.data(),
+		.pSpecializationInfo    = &info.stage.specialization_info,
+	};
+	VB_VERIFY_VK_RESULT(device.createShadersEXT(1, &create_info, device.GetAllocator(), &shader),
+						info.check_vk_results, "Failed to create shader object!", {});
+	VB_LOG_TRACE("Created shader object, name = %s", detail::FormatName(GetName()).data());
+	return vk::Result::eSuccess;
+}
+
+auto ShaderObject::GetResourceTypeName() const -> char const* { return "ShaderObjectResource"; }
+
+void ShaderObject::Free() {
+	if (GetOwner() == nullptr || !shader)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), detail::FormatName(GetName()).data());
+	GetDevice().destroyShaderEXT(shader, GetDevice().GetAllocator());
+	shader = vk::ShaderEXT{};
+}
+} // namespace VB_NAMESPACE
@@ -0,0 +1,355 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "vulkan_backend/compile_shader.hpp"
+#include "vulkan_backend/interface/device/device.hpp"
+#include "vulkan_backend/interface/pipeline/pipeline.hpp"
+#include "vulkan_backend/interface/shader_watcher/shader_watcher.hpp"
+#include "vulkan_backend/log.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/util/pipeline.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+
+namespace {
+auto AbsolutePath(std::string_view path) -> std::string {
+	std::error_code ec;
+	std::filesystem::path absolute = std::filesystem::absolute(std::filesystem::path(path), ec);
+	return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+// Time to wait for more events after the first one, editors often write a file in several steps
+constexpr auto kSettleTime = std::chrono::milliseconds(50);
+constexpr int  kPollTimeoutMs = 100;
+} // namespace
+
+ShaderWatcher::ShaderWatcher(Device& device) { Create(device); }
+
+ShaderWatcher::~ShaderWatcher() { Free(); }
+
+void ShaderWatcher::Create(Device& device) {
+	ResourceBase::SetOwner(&device);
+	stop = false;
+#ifdef __linux__
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd < 0) {
+		VB_LOG_WARN("[ ShaderWatcher ] inotify is not available, polling files instead");
+	}
+#endif
+	thread = std::thread(&ShaderWatcher::WatchLoop, this);
+}
+
+void ShaderWatcher::Watch(Pipeline& pipeline, PipelineInfo const& info) {
+	VB_ASSERT(info.stages.size() == 1, "Compute pipeline supports only 1 stage.");
+	PipelineStage const& stage = info.stages[0];
+	vk::SpecializationInfo const& specialization = stage.specialization_info;
+
+	WatchedPipeline watched{
+		.stage = {
+			.stage           = stage.stage,
+			.source_type     = stage.source.type,
+			.source          = std::string(stage.source.data),
+			.out_path        = std::string(stage.out_path),
+			.entry_point     = std::string(stage.entry_point),
+			.compiler        = std::string(stage.compiler),
+			.compile_options = std::string(stage.compile_options),
+			.flags           = stage.flags,
+			.map_entries     = {specialization.pMapEntries, specialization.pMapEntries + specialization.mapEntryCount},
+			.specialization_data = {static_cast<char const*>(specialization.pData),
+									static_cast<char const*>(specialization.pData) + specialization.dataSize},
+		},
+		.layout = info.layout,
+		.name   = std::string(info.name),
+	};
+	for (auto const& file : GetShaderDependencies(stage)) {
+		watched.files.push_back(AbsolutePath(file));
+	}
+	WatchFiles(watched.files);
+
+	std::lock_guard lock(mutex);
+	watched.version = ++next_version;
+	watched_pipelines.insert_or_assign(&pipeline, std::move(watched));
+}
+
+void ShaderWatcher::Unwatch(Pipeline& pipeline) {
+	std::lock_guard lock(mutex);
+	watched_pipelines.erase(&pipeline);
+	auto it = std::find_if(ready_pipelines.begin(), ready_pipelines.end(),
+						   [&pipeline](auto const& ready) { return ready.first == &pipeline; });
+	if (it != ready_pipelines.end()) {
+		// Never used, safe to destroy now
+		GetDevice().destroyPipeline(it->second, GetDevice().GetAllocator());
+		ready_pipelines.erase(it);
+	}
+}
+
+auto ShaderWatcher::Update() -> u32 {
+	std::vector<std::pair<Pipeline*, vk::Pipeline>> swaps;
+	{
+		std::lock_guard lock(mutex);
+		swaps.swap(ready_pipelines);
+	}
+	for (auto [pipeline, handle] : swaps) {
+		GetDevice().RetirePipeline(pipeline->Exchange(handle));
+		VB_LOG_INFO("[ ShaderWatcher ] Reloaded %.*s", static_cast<int>(pipeline->GetName().size()),
+					pipeline->GetName().data());
+	}
+	// Handles retired by earlier updates are released once the GPU is done with them, even if nothing changed since
+	GetDevice().ReleaseRetiredPipelines();
+	return static_cast<u32>(swaps.size());
+}
+
+void ShaderWatcher::WatchFiles(std::span<std::string const> files) {
+#ifdef __linux__
+	if (inotify_fd >= 0) {
+		// Watch directories, editors often replace files instead of writing them in place
+		for (auto const& file : files) {
+			std::string const directory = std::filesystem::path(file).parent_path().string();
+			int const descriptor = inotify_add_watch(inotify_fd, directory.c_str(),
+													 IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+			if (descriptor < 0) {
+				VB_LOG_WARN("[ ShaderWatcher ] Failed to watch %s", directory.c_str());
+				continue;
+			}
+			std::lock_guard lock(mutex);
+			watched_directories.insert_or_assign(descriptor, directory);
+		}
+		return;
+	}
+#endif
+	(void)files;
+}
+
+auto ShaderWatcher::WaitForChanges() -> std::vector<std::string> {
+	std::vector<std::string> changed;
+#ifdef __linux__
+	if (inotify_fd >= 0) {
+		pollfd descriptor{.fd = inotify_fd, .events = POLLIN, .revents = 0};
+		if (poll(&descriptor, 1, kPollTimeoutMs) <= 0) {
+			return changed;
+		}
+		alignas(inotify_event) char buffer[4096];
+		for (;;) {
+			ssize_t const length = read(inotify_fd, buffer, sizeof(buffer));
+			if (length <= 0) {
+				break;
+			}
+			std::lock_guard lock(mutex);
+			for (char const* it = buffer; it < buffer + length;) {
+				auto const* event = reinterpret_cast<inotify_event const*>(it);
+				it += sizeof(inotify_event) + event->len;
+				auto directory = watched_directories.find(event->wd);
+				if (event->len == 0 || directory == watched_directories.end()) {
+					continue;
+				}
+				changed.push_back((std::filesystem::path(directory->second) / event->name).lexically_normal().string());
+			}
+		}
+		return changed;
+	}
+#endif
+	// Compare modification times of all watched files
+	std::this_thread::sleep_for(std::chrono::milliseconds(kPollTimeoutMs));
+	std::vector<std::string> files;
+	{
+		std::lock_guard lock(mutex);
+		for (auto const& [pipeline, watched] : watched_pipelines) {
+			files.insert(files.end(), watched.files.begin(), watched.files.end());
+		}
+	}
+	for (auto const& file : files) {
+		std::error_code ec;
+		auto const time = std::filesystem::last_write_time(file, ec);
+		if (ec) {
+			continue;
+		}
+		auto [it, inserted] = file_times.try_emplace(file, time);
+		if (!inserted && it->second != time) {
+			it->second = time;
+			changed.push_back(file);
+		}
+	}
+	return changed;
+}
+
+void ShaderWatcher::WatchLoop() {
+	while (!stop.load(std::memory_order_relaxed)) {
+		std::vector<std::string> changed = WaitForChanges();
+		if (changed.empty()) {
+			continue;
+		}
+		std::this_thread::sleep_for(kSettleTime);
+		std::vector<std::string> more = WaitForChanges();
+		changed.insert(changed.end(), more.begin(), more.end());
+		std::sort(changed.begin(), changed.end());
+		changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+		Rebuild(changed);
+	}
+}
+
+void ShaderWatcher::Rebuild(std::span<std::string const> changed_files) {
+	// Copy affected pipelines, compilation runs without the lock
+	std::vector<std::pair<Pipeline*, WatchedPipeline>> affected;
+	{
+		std::lock_guard lock(mutex);
+		for (auto const& [pipeline, watched] : watched_pipelines) {
+			bool const is_affected = std::any_of(watched.files.begin(), watched.files.end(), [&](auto const& file) {
+				return std::binary_search(changed_files.begin(), changed_files.end(), file);
+			});
+			if (is_affected) {
+				affected.emplace_back(pipeline, watched);
+			}
+		}
+	}
+
+	for (auto& [pipeline, watched] : affected) {
+		if (stop.load(std::memory_order_relaxed)) {
+			return;
+		}
+		VB_LOG_TRACE("[ ShaderWatcher ] Rebuilding %s", watched.name.c_str());
+		vk::Pipeline const handle = BuildPipeline(watched);
+		if (!handle) {
+			// Keep the old pipeline, error was logged by compiler
+			continue;
+		}
+
+		std::lock_guard lock(mutex);
+		auto it = watched_pipelines.find(pipeline);
+		if (it == watched_pipelines.end() || it->second.version != watched.version) {
+			// Unwatched or watched again while building
+			GetDevice().destroyPipeline(handle, GetDevice().GetAllocator());
+			continue;
+		}
+		// Includes might have changed
+		it->second.files = std::move(watched.files);
+		auto ready = std::find_if(ready_pipelines.begin(), ready_pipelines.end(),
+								  [pipeline](auto const& ready) { return ready.first == pipeline; });
+		if (ready != ready_pipelines.end()) {
+			// Previous rebuild was not swapped in yet and is never used
+			GetDevice().destroyPipeline(std::exchange(ready->second, handle), GetDevice().GetAllocator());
+		} else {
+			ready_pipelines.emplace_back(pipeline, handle);
+		}
+	}
+}
+
+auto ShaderWatcher::BuildPipeline(WatchedPipeline& watched) -> vk::Pipeline {
+	WatchedStage const& watched_stage = watched.stage;
+	vk::SpecializationInfo const specialization_info{
+		.mapEntryCount = static_cast<u32>(watched_stage.map_entries.size()),
+		.pMapEntries   = watched_stage.map_entries.data(),
+		.dataSize      = watched_stage.specialization_data.size(),
+		.pData         = watched_stage.specialization_data.data(),
+	};
+	PipelineStage const stage{
+		.stage               = watched_stage.stage,
+		.source              = {.data = watched_stage.source, .type = watched_stage.source_type},
+		.out_path            = watched_stage.out_path,
+		.entry_point         = watched_stage.entry_point,
+		.compiler            = watched_stage.compiler,
+		.compile_options     = watched_stage.compile_options,
+		.flags               = watched_stage.flags,
+		.specialization_info = specialization_info,
+	};
+
+	// Watch newly included files
+	std::vector<std::string> files;
+	for (auto const& file : GetShaderDependencies(stage)) {
+		files.push_back(AbsolutePath(file));
+	}
+	WatchFiles(files);
+	watched.files = std::move(files);
+
+	ShaderCode code = LoadShaderCode(stage);
+	if (code.IsEmpty()) {
+		return nullptr;
+	}
+
+	Device& device = GetDevice();
+	vk::ShaderModuleCreateInfo module_info{
+		.codeSize = code.GetSize(),
+		.pCode    = code.GetData(),
+	};
+	vk::ShaderModule module;
+	VB_VK_RESULT result = device.createShaderModule(&module_info, device.GetAllocator(), &module);
+	if (result != vk::Result::eSuccess) {
+		VB_LOG_ERROR("[ ShaderWatcher ] Failed to create shader module for %s", watched.name.c_str());
+		return nullptr;
+	}
+
+	vk::ComputePipelineCreateInfo pipeline_info{
+		.stage = {
+			.stage               = stage.stage,
+			.module              = module,
+			.pName               = watched_stage.entry_point.c_str(),
+			.pSpecializationInfo = &specialization_info,
+		},
+		.layout             = watched.layout,
+		.basePipelineHandle = nullptr,
+		.basePipelineIndex  = -1,
+	};
+	PipelineFeedback feedback;
+	feedback.Chain(pipeline_info, 1, device.pipeline_creation_feedback);
+	vk::Pipeline pipeline;
+	result = device.createComputePipelines(device.GetPipelineCache(), 1, &pipeline_info, device.GetAllocator(), &pipeline);
+	device.destroyShaderModule(module, device.GetAllocator());
+	if (result != vk::Result::eSuccess) {
+		VB_LOG_ERROR("[ ShaderWatcher ] Failed to create pipeline %s", watched.name.c_str());
+		return nullptr;
+	}
+	device.RecordPipelineCreation(watched.name, feedback, {&pipeline_info.stage, 1});
+	return pipeline;
+}
+
+auto ShaderWatcher::GetResourceTypeName() const -> char const* { return "ShaderWatcherResource"; }
+
+void ShaderWatcher::Free() {
+	if (GetOwner() == nullptr)
+		return;
+	VB_LOG_TRACE("[ Free ] type = %s, pipelines = %zu", GetResourceTypeName(), watched_pipelines.size());
+	stop = true;
+	if (thread.joinable()) {
+		thread.join();
+	}
+#ifdef __linux__
+	if (inotify_fd >= 0) {
+		close(inotify_fd);
+		inotify_fd = -1;
+	}
+#endif
+	for (auto& [pipeline, handle] : ready_pipelines) {
+		GetDevice().destroyPipeline(handle, GetDevice().GetAllocator());
+	}
+	ready_pipelines.clear();
+	watched_pipelines.clear();
+	watched_directories.clear();
+	file_times.clear();
+}
+
+} // namespace VB_NAMESPACE
@@ -0,0 +1,125 @@
+#ifndef VB_USE_STD_MODULE
+#include <chrono>
+#include <span>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#include "vulkan_backend/interface/queue/submit_batch.hpp"
+#include "vulkan_backend/interface/command/command.hpp"
+#include "vulkan_backend/interface/queue/queue.hpp"
+#include "vulkan_backend/macros.hpp"
+#include "vulkan_backend/vk_result.hpp"
+
+namespace VB_NAMESPACE {
+SubmitBatch::SubmitBatch(Queue const& queue, SubmitBatchInfo const& info) : queue(&queue), info(info) {}
+
+SubmitBatch::~SubmitBatch() {
+	Flush();
+}
+
+auto SubmitBatch::GetSubmit(bool for_wait) -> Submit& {
+	// Waits of an entry happen before all its command buffers, signals after them
+	if (submits.empty() || submits.back().signal_count > 0 || (for_wait && submits.back().cmd_count > 0)) {
+		submits.push_back({
+			.first_wait   = static_cast<u32>(waits.size()),
+			.first_cmd    = static_cast<u32>(command_infos.size()),
+			.first_signal = static_cast<u32>(signals.size()),
+		});
+	}
+	return submits.back();
+}
+
+void SubmitBatch::Add(Command& cmd, SubmitInfo const& info) {
+	for (auto const& wait : info.waitSemaphoreInfos) {
+		Wait(wait);
+	}
+
+	if (command_infos.empty()) {
+		first_add_time = std::chrono::steady_clock::now();
+	}
+	++GetSubmit(false).cmd_count;
+	command_infos.push_back({.commandBuffer = cmd});
+	commands.push_back(&cmd);
+
+	for (auto const& signal : info.signalSemaphoreInfos) {
+		Signal(signal);
+	}
+
+	if (this->info.max_commands > 0 && command_infos.size() >= this->info.max_commands) {
+		Flush();
+		return;
+	}
+	FlushIfDue();
+}
+
+auto SubmitBatch::FlushIfDue() -> SubmitTicket {
+	bool const delay_reached = !command_infos.empty() && info.max_delay > std::chrono::nanoseconds::zero() &&
+							   std::chrono::steady_clock::now() - first_add_time >= info.max_delay;
+	return delay_reached ? Flush() : SubmitTicket{};
+}
+
+void SubmitBatch::Wait(vk::SemaphoreSubmitInfo const& wait) {
+	++GetSubmit(true).wait_count;
+	waits.push_back(wait);
+}
+
+void SubmitBatch::Signal(vk::SemaphoreSubmitInfo const& signal) {
+	if (submits.empty()) {
+		GetSubmit(false);
+	}
+	++submits.back().signal_count;
+	signals.push_back(signal);
+}
+
+auto SubmitBatch::Flush(vk::Fence fence) -> SubmitTicket {
+	if (submits.empty()) {
+		return {};
+	}
+
+	// Signal operations include all commands earlier in submission order,
+	// so one timeline signal after the last entry covers the whole batch
+	vk::SemaphoreSubmitInfo const timeline_signal = queue->GetNextTimelineSignal();
+	Signal(timeline_signal);
+
+	VB_VLA(vk::SubmitInfo2, submit_infos, submits.size());
+	for (u32 i = 0; i < submits.size(); ++i) {
+		Submit const& submit = submits[i];
+		submit_infos[i] = {
+			.waitSemaphoreInfoCount   = submit.wait_count,
+			.pWaitSemaphoreInfos      = waits.data() + submit.first_wait,
+			.commandBufferInfoCount   = submit.cmd_count,
+			.pCommandBufferInfos      = command_infos.data() + submit.first_cmd,
+			.signalSemaphoreInfoCount = submit.signal_count,
+			.pSignalSemaphoreInfos    = signals.data() + submit.first_signal,
+		};
+	}
+
+	auto result = queue->submit2(static_cast<u32>(submit_infos.size()), submit_infos.data(), fence);
+	VB_CHECK_VK_RESULT(result, "Failed to submit batch");
+	queue->SetSubmitted(timeline_signal.value);
+
+	SubmitTicket const ticket = {queue, timeline_signal.value};
+	for (Command* cmd : commands) {
+		cmd->ticket = ticket;
+	}
+
+	++stats.flushes;
+	stats.submit_infos += static_cast<u32>(submits.size());
+	stats.command_buffers += static_cast<u32>(commands.size());
+
+	submits.clear();
+	waits.clear();
+	command_infos.clear();
+	signals.clear();
+	commands.clear();
+	return ticket;
+}
+} // namespace VB_NAMESPACE
@@ -95,7 +95,7 @@ bool Swapchain::AcquireNextImage() {
 }
 
 // EndCommandBuffer + vkQueuePresentKHR
-void Swapchain::SubmitAndPresent(vk::Queue const& submit, vk::Queue const& present) {
+void Swapchain::SubmitAndPresent(Queue const& submit, vk::Queue const& present) {
 	auto& cmd = GetCommandBuffer();
 
 	cmd.End();
@@ -133,10 +133,8 @@ void Swapchain::SubmitAndPresent(vk::Queue const& submit, vk::Queue const& prese
 
 void Swapchain::Recreate(u32 width, u32 height) {
 	VB_ASSERT(width > 0 && height > 0, "Window size is 0, swapchain NOT to be recreated");
-	VB_VK_RESULT result;
 	for (auto& cmd: commands) {
-		result = GetDevice().waitForFences(1, &cmd.fence, vk::True, std::numeric_limits<u32>::max());
-		VB_CHECK_VK_RESULT(result, "Failed to wait for fence!");
+		cmd.Wait();
 	}
 
 	for (auto& image : images) {
@@ -392,10 +390,8 @@ auto Swapchain::GetResourceTypeName() const -> char const* {
 
 void Swapchain::Free() {
 	VB_LOG_TRACE("[ Free ] type = %s, name = %s", GetResourceTypeName(), GetName().data());
-	VB_VK_RESULT result;
 	for (auto& cmd: commands) {
-		result = GetDevice().waitForFences(1, &cmd.fence, vk::True, std::numeric_limits<u32>::max());
-		VB_CHECK_VK_RESULT(result, "Failed to wait for fence!");
+		cmd.Wait();
 	}
 
 	for (auto& image : images) {
@@ -0,0 +1,378 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#else
+import std;
+#endif
+
+#ifndef VB_USE_VULKAN_MODULE
+#include <vulkan/vulkan.hpp>
+#else
+import vulkan_hpp;
+#endif
+
+#ifndef VB_NO_SHADERC
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#endif // VB_NO_SHADERC
+
+#include "shaderc_compiler.hpp"
+#include "vulkan_backend/log.hpp"
+
+namespace VB_NAMESPACE {
+#ifdef VB_NO_SHADERC
+auto CompileWithShaderc(PipelineStage const&, std::string_view, char const*, ShaderCompileResult&) -> bool {
+	return false;
+}
+#else
+namespace {
+// Subset of shaderc C API (libshaderc/include/shaderc/shaderc.h), declared here to not require shaderc headers
+using shaderc_compiler_t            = struct shaderc_compiler*;
+using shaderc_compile_options_t     = struct shaderc_compile_options*;
+using shaderc_compilation_result_t  = struct shaderc_compilation_result*;
+
+enum shaderc_shader_kind {
+	shaderc_vertex_shader          = 0,
+	shaderc_fragment_shader        = 1,
+	shaderc_compute_shader         = 2,
+	shaderc_geometry_shader        = 3,
+	shaderc_tess_control_shader    = 4,
+	shaderc_tess_evaluation_shader = 5,
+	shaderc_raygen_shader          = 14,
+	shaderc_anyhit_shader          = 15,
+	shaderc_closesthit_shader      = 16,
+	shaderc_miss_shader            = 17,
+	shaderc_intersection_shader    = 18,
+	shaderc_callable_shader        = 19,
+	shaderc_task_shader            = 26,
+	shaderc_mesh_shader            = 27,
+};
+
+enum shaderc_optimization_level {
+	shaderc_optimization_level_zero        = 0,
+	shaderc_optimization_level_size        = 1,
+	shaderc_optimization_level_performance = 2,
+};
+
+enum shaderc_target_env { shaderc_target_env_vulkan = 0 };
+enum shaderc_include_type { shaderc_include_type_relative = 0, shaderc_include_type_standard = 1 };
+enum shaderc_compilation_status { shaderc_compilation_status_success = 0 };
+
+struct shaderc_include_result {
+	char const* source_name;
+	std::size_t source_name_length;
+	char const* content;
+	std::size_t content_length;
+	void*       user_data;
+};
+
+using shaderc_include_resolve_fn = shaderc_include_result* (*)(void* user_data, char const* requested_source, int type,
+															   char const* requesting_source, std::size_t include_depth);
+using shaderc_include_result_release_fn = void (*)(void* user_data, shaderc_include_result* include_result);
+
+struct ShadercFunctions {
+	shaderc_compiler_t (*compiler_initialize)();
+	void (*compiler_release)(shaderc_compiler_t);
+	shaderc_compile_options_t (*compile_options_initialize)();
+	void (*compile_options_release)(shaderc_compile_options_t);
+	void (*compile_options_add_macro_definition)(shaderc_compile_options_t, char const*, std::size_t, char const*,
+												 std::size_t);
+	void (*compile_options_set_optimization_level)(shaderc_compile_options_t, shaderc_optimization_level);
+	void (*compile_options_set_generate_debug_info)(shaderc_compile_options_t);
+	void (*compile_options_set_target_env)(shaderc_compile_options_t, shaderc_target_env, std::uint32_t);
+	void (*compile_options_set_target_spirv)(shaderc_compile_options_t, std::uint32_t);
+	void (*compile_options_set_include_callbacks)(shaderc_compile_options_t, shaderc_include_resolve_fn,
+												  shaderc_include_result_release_fn, void*);
+	shaderc_compilation_result_t (*compile_into_spv)(shaderc_compiler_t, char const*, std::size_t, shaderc_shader_kind,
+													 char const*, char const*, shaderc_compile_options_t);
+	void (*result_release)(shaderc_compilation_result_t);
+	std::size_t (*result_get_length)(shaderc_compilation_result_t);
+	int (*result_get_compilation_status)(shaderc_compilation_result_t);
+	char const* (*result_get_bytes)(shaderc_compilation_result_t);
+	char const* (*result_get_error_message)(shaderc_compilation_result_t);
+};
+
+// Library stays loaded until process exit, compiler object is thread-safe
+struct Shaderc {
+	ShadercFunctions   functions{};
+	shaderc_compiler_t compiler = nullptr;
+};
+
+auto LoadSymbol(void* library, char const* name) -> void* {
+#ifdef _WIN32
+	return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+#else
+	return dlsym(library, name);
+#endif
+}
+
+auto LoadShaderc() -> Shaderc* {
+#ifdef _WIN32
+	char const* const names[] = {"shaderc_shared.dll"};
+#elif defined(__APPLE__)
+	char const* const names[] = {"libshaderc_shared.dylib", "libshaderc_shared.1.dylib"};
+#else
+	char const* const names[] = {"libshaderc_shared.so", "libshaderc_shared.so.1"};
+#endif
+	void* library = nullptr;
+	for (char const* name : names) {
+#ifdef _WIN32
+		library = reinterpret_cast<void*>(LoadLibraryA(name));
+#else
+		library = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+#endif
+		if (library) break;
+	}
+	if (!library) {
+		VB_LOG_TRACE("[ ShaderCompiler ] shaderc shared library not found, using command line compiler");
+		return nullptr;
+	}
+
+	static Shaderc shaderc;
+	auto& f   = shaderc.functions;
+	bool  all = true;
+	auto  load = [&](auto& function, char const* name) {
+		function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(LoadSymbol(library, name));
+		all      = all && function != nullptr;
+	};
+	load(f.compiler_initialize, "shaderc_compiler_initialize");
+	load(f.compiler_release, "shaderc_compiler_release");
+	load(f.compile_options_initialize, "shaderc_compile_options_initialize");
+	load(f.compile_options_release, "shaderc_compile_options_release");
+	load(f.compile_options_add_macro_definition, "shaderc_compile_options_add_macro_definition");
+	load(f.compile_options_set_optimization_level, "shaderc_compile_options_set_optimization_level");
+	load(f.compile_options_set_generate_debug_info, "shaderc_compile_options_set_generate_debug_info");
+	load(f.compile_options_set_target_env, "shaderc_compile_options_set_target_env");
+	load(f.compile_options_set_target_spirv, "shaderc_compile_options_set_target_spirv");
+	load(f.compile_options_set_include_callbacks, "shaderc_compile_options_set_include_callbacks");
+	load(f.compile_into_spv, "shaderc_compile_into_spv");
+	load(f.result_release, "shaderc_result_release");
+	load(f.result_get_length, "shaderc_result_get_length");
+	load(f.result_get_compilation_status, "shaderc_result_get_compilation_status");
+	load(f.result_get_bytes, "shaderc_result_get_bytes");
+	load(f.result_get_error_message, "shaderc_result_get_error_message");
+	if (!all) {
+		VB_LOG_WARN("[ ShaderCompiler ] shaderc shared library is missing functions, using command line compiler");
+		return nullptr;
+	}
+	shaderc.compiler = f.compiler_initialize();
+	if (!shaderc.compiler) {
+		return nullptr;
+	}
+	VB_LOG_TRACE("[ ShaderCompiler ] Using shaderc shared library");
+	return &shaderc;
+}
+
+auto GetShaderc() -> Shaderc* {
+	static Shaderc* const shaderc = LoadShaderc();
+	return shaderc;
+}
+
+auto ShaderKind(vk::ShaderStageFlagBits stage, shaderc_shader_kind& kind) -> bool {
+	switch (stage) {
+	case vk::ShaderStageFlagBits::eVertex:                 kind = shaderc_vertex_shader; return true;
+	case vk::ShaderStageFlagBits::eFragment:               kind = shaderc_fragment_shader; return true;
+	case vk::ShaderStageFlagBits::eCompute:                kind = shaderc_compute_shader; return true;
+	case vk::ShaderStageFlagBits::eGeometry:               kind = shaderc_geometry_shader; return true;
+	case vk::ShaderStageFlagBits::eTessellationControl:    kind = shaderc_tess_control_shader; return true;
+	case vk::ShaderStageFlagBits::eTessellationEvaluation: kind = shaderc_tess_evaluation_shader; return true;
+	case vk::ShaderStageFlagBits::eRaygenKHR:              kind = shaderc_raygen_shader; return true;
+	case vk::ShaderStageFlagBits::eAnyHitKHR:              kind = shaderc_anyhit_shader; return true;
+	case vk::ShaderStageFlagBits::eClosestHitKHR:          kind = shaderc_closesthit_shader; return true;
+	case vk::ShaderStageFlagBits::eMissKHR:                kind = shaderc_miss_shader; return true;
+	case vk::ShaderStageFlagBits::eIntersectionKHR:        kind = shaderc_intersection_shader; return true;
+	case vk::ShaderStageFlagBits::eCallableKHR:            kind = shaderc_callable_shader; return true;
+	case vk::ShaderStageFlagBits::eTaskEXT:                kind = shaderc_task_shader; return true;
+	case vk::ShaderStageFlagBits::eMeshEXT:                kind = shaderc_mesh_shader; return true;
+	default: return false;
+	}
+}
+
+// Compile options understood in-process, same syntax as glslc
+struct ParsedOptions {
+	std::vector<std::pair<std::string, std::string>> macros;
+	std::vector<std::filesystem::path>               include_directories;
+	shaderc_optimization_level optimization = shaderc_optimization_level_zero;
+	bool          debug_info   = false;
+	std::uint32_t target_env   = 0;
+	std::uint32_t target_spirv = 0;
+};
+
+auto ParseVulkanVersion(std::string_view version, std::uint32_t& result) -> bool {
+	// shaderc_env_version_vulkan_1_X == VK_MAKE_API_VERSION(0, 1, X, 0)
+	if (version == "vulkan" || version == "vulkan1.0") result = 1u << 22;
+	else if (version == "vulkan1.1") result = (1u << 22) | (1u << 12);
+	else if (version == "vulkan1.2") result = (1u << 22) | (2u << 12);
+	else if (version == "vulkan1.3") result = (1u << 22) | (3u << 12);
+	else if (version == "vulkan1.4") result = (1u << 22) | (4u << 12);
+	else return false;
+	return true;
+}
+
+auto ParseSpirvVersion(std::string_view version, std::uint32_t& result) -> bool {
+	// shaderc_spirv_version_1_X == 0x010X00
+	if (version.size() != 6 || !version.starts_with("spv1.") || version[5] < '0' || version[5] > '6') return false;
+	result = 0x010000u | (static_cast<std::uint32_t>(version[5] - '0') << 8);
+	return true;
+}
+
+auto ParseOptions(std::string_view options, ParsedOptions& parsed) -> bool {
+	std::vector<std::string_view> tokens;
+	while (!options.empty()) {
+		std::size_t const begin = options.find_first_not_of(" \t");
+		if (begin == std::string_view::npos) break;
+		options.remove_prefix(begin);
+		std::size_t const end = std::min(options.find_first_of(" \t"), options.size());
+		tokens.push_back(options.substr(0, end));
+		options.remove_prefix(end);
+	}
+
+	auto add_macro = [&parsed](std::string_view definition) {
+		std::size_t const equals = definition.find('=');
+		if (equals == std::string_view::npos) {
+			parsed.macros.emplace_back(definition, "");
+		} else {
+			parsed.macros.emplace_back(definition.substr(0, equals), definition.substr(equals + 1));
+		}
+	};
+
+	for (std::size_t i = 0; i < tokens.size(); ++i) {
+		std::string_view const token = tokens[i];
+		if (token == "-D" || token == "-I") {
+			if (i + 1 == tokens.size()) return false;
+			std::string_view const value = tokens[++i];
+			if (token == "-D") add_macro(value);
+			else parsed.include_directories.emplace_back(value);
+		} else if (token.starts_with("-D")) {
+			add_macro(token.substr(2));
+		} else if (token.starts_with("-I")) {
+			parsed.include_directories.emplace_back(token.substr(2));
+		} else if (token == "-O") {
+			parsed.optimization = shaderc_optimization_level_performance;
+		} else if (token == "-Os") {
+			parsed.optimization = shaderc_optimization_level_size;
+		} else if (token == "-O0") {
+			parsed.optimization = shaderc_optimization_level_zero;
+		} else if (token == "-g") {
+			parsed.debug_info = true;
+		} else if (token.starts_with("--target-env=")) {
+			if (!ParseVulkanVersion(token.substr(sizeof("--target-env=") - 1), parsed.target_env)) return false;
+		} else if (token.starts_with("--target-spv=")) {
+			if (!ParseSpirvVersion(token.substr(sizeof("--target-spv=") - 1), parsed.target_spirv)) return false;
+		} else {
+			VB_LOG_TRACE("[ ShaderCompiler ] Option %.*s is not supported in-process", static_cast<int>(token.size()),
+						 token.data());
+			return false;
+		}
+	}
+	return true;
+}
+
+// Include result with storage for resolved name and file contents
+struct IncludeResult : shaderc_include_result {
+	std::string name_storage;
+	std::string content_storage;
+};
+
+struct IncludeContext {
+	std::vector<std::filesystem::path> const* include_directories;
+};
+
+auto ResolveInclude(void* user_data, char const* requested_source, int type, char const* requesting_source,
+					std::size_t /* include_depth */) -> shaderc_include_result* {
+	auto const& context = *static_cast<IncludeContext*>(user_data);
+	auto*       result  = new IncludeResult{};
+
+	std::error_code       ec;
+	std::filesystem::path found;
+	if (type == shaderc_include_type_relative) {
+		std::filesystem::path const candidate = std::filesystem::path(requesting_source).parent_path() / requested_source;
+		if (std::filesystem::exists(candidate, ec)) found = candidate;
+	}
+	if (found.empty()) {
+		for (auto const& directory : *context.include_directories) {
+			if (std::filesystem::exists(directory / requested_source, ec)) {
+				found = directory / requested_source;
+				break;
+			}
+		}
+	}
+
+	std::ifstream file(found, std::ios::binary);
+	if (found.empty() || !file.is_open()) {
+		// Empty name reports an error, content is the message
+		result->content_storage = std::string("Cannot find or open include file ") + requested_source;
+	} else {
+		result->name_storage = found.string();
+		result->content_storage.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	result->source_name        = result->name_storage.data();
+	result->source_name_length = result->name_storage.size();
+	result->content            = result->content_storage.data();
+	result->content_length     = result->content_storage.size();
+	result->user_data          = nullptr;
+	return result;
+}
+
+void ReleaseInclude(void* /* user_data */, shaderc_include_result* include_result) {
+	delete static_cast<IncludeResult*>(include_result);
+}
+} // namespace
+
+auto CompileWithShaderc(PipelineStage const& stage, std::string_view source, char const* source_name,
+						ShaderCompileResult& result) -> bool {
+	Shaderc* const shaderc = GetShaderc();
+	if (!shaderc) return false;
+
+	shaderc_shader_kind kind;
+	ParsedOptions       parsed;
+	if (!ShaderKind(stage.stage, kind) || !ParseOptions(stage.compile_options, parsed)) return false;
+
+	auto const& f       = shaderc->functions;
+	auto const  options = f.compile_options_initialize();
+	for (auto const& [name, value] : parsed.macros) {
+		f.compile_options_add_macro_definition(options, name.data(), name.size(), value.data(), value.size());
+	}
+	f.compile_options_set_optimization_level(options, parsed.optimization);
+	if (parsed.debug_info) f.compile_options_set_generate_debug_info(options);
+	if (parsed.target_env) f.compile_options_set_target_env(options, shaderc_target_env_vulkan, parsed.target_env);
+	if (parsed.target_spirv) f.compile_options_set_target_spirv(options, parsed.target_spirv);
+	IncludeContext include_context{.include_directories = &parsed.include_directories};
+	f.compile_options_set_include_callbacks(options, ResolveInclude, ReleaseInclude, &include_context);
+
+	// Entry point must be null-terminated
+	std::string const entry_point(stage.entry_point);
+	auto const compilation = f.compile_into_spv(shaderc->compiler, source.data(), source.size(), kind, source_name,
+												entry_point.c_str(), options);
+	char const* message = f.result_get_error_message(compilation);
+	result.diagnostics  = message ? message : "";
+	if (f.result_get_compilation_status(compilation) == shaderc_compilation_status_success) {
+		char const* bytes = f.result_get_bytes(compilation);
+		result.spirv.assign(bytes, bytes + f.result_get_length(compilation));
+		result.result = vk::Result::eSuccess;
+	} else {
+		result.spirv.clear();
+		result.result = vk::Result::eErrorUnknown;
+	}
+	f.result_release(compilation);
+	f.compile_options_release(options);
+	return true;
+}
+#endif // VB_NO_SHADERC
+} // namespace VB_NAMESPACE
@@ -0,0 +1,18 @@
+#pragma once
+
+#ifndef VB_USE_STD_MODULE
+#include <string_view>
+#else
+import std;
+#endif
+
+#include "vulkan_backend/compile_shader.hpp"
+#include "vulkan_backend/config.hpp"
+
+namespace VB_NAMESPACE {
+// Compile GLSL source in-process with shaderc shared library, loaded on first use.
+// Returns false without touching result if shaderc is not available
+// or stage.compile_options contain an option it does not support
+auto CompileWithShaderc(PipelineStage const& stage, std::string_view source, char const* source_name,
+						ShaderCompileResult& result) -> bool;
+} // namespace VB_NAMESPACE
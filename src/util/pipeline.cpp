@@ -1,4 +1,5 @@
 #ifndef VB_USE_STD_MODULE
+#include <algorithm>
 #include <string_view>
 #else
 import std;
@@ -18,43 +19,55 @@ import vulkan_hpp;
 #include "vulkan_backend/vk_result.hpp"
 
 namespace VB_NAMESPACE {
-void CreateShaderModulesAndStagesInfos(Device const& device, std::span<const PipelineStage> stages,
-						vk::ShaderModule*				   p_shader_modules,
-						vk::PipelineShaderStageCreateInfo* p_shader_stages) {
+auto ShaderStagesCreateState::Fill(Device& device, std::span<PipelineStage const> stages, bool allow_identifiers)
+	-> vk::Result {
+	modules.resize(stages.size());
+	identifier_infos.resize(stages.size());
+	stage_infos.resize(stages.size());
+	uses_identifiers = false;
 	for (auto [i, stage] : util::enumerate(stages)) {
-		// Load or compile shader
-		std::vector<char> bytes = LoadShader(stage);
+		// Load or compile shader only if its module is not cached
+		modules[i] = device.GetShaderModuleCache().Get(stage, allow_identifiers);
+		if (!modules[i]) {
+			// Error is already logged by shader module cache
+			return vk::Result::eErrorInitializationFailed;
+		}
+		CachedShaderModule const& module = *modules[i];
 
-		// Create shader module
-		vk::ShaderModuleCreateInfo createInfo{
-			.codeSize = bytes.size(),
-			.pCode	  = reinterpret_cast<const u32*>(bytes.data()),
-		};
-		VB_VK_RESULT result =
-			device.createShaderModule(&createInfo, device.GetAllocator(), &p_shader_modules[i]);
-		VB_CHECK_VK_RESULT(result, "Failed to create shader module!");
-		
-		// Create shader stage info
-		p_shader_stages[i] = vk::PipelineShaderStageCreateInfo{
+		stage_infos[i] = vk::PipelineShaderStageCreateInfo{
 			.stage				 = stage.stage,
-			.module				 = p_shader_modules[i],
+			.module				 = module.module,
 			.pName				 = stage.entry_point.data(),
 			.pSpecializationInfo = &stage.specialization_info,
 		};
+		if (!module.module && !module.identifier.empty()) {
+			identifier_infos[i] = vk::PipelineShaderStageModuleIdentifierCreateInfoEXT{
+				.identifierSize = static_cast<u32>(module.identifier.size()),
+				.pIdentifier	= module.identifier.data(),
+			};
+			stage_infos[i].pNext = &identifier_infos[i];
+			uses_identifiers	 = true;
+		}
 	}
+	return vk::Result::eSuccess;
 }
 
-void CreateShaderModuleInfos(std::span<const PipelineStage> stages, std::vector<char>* p_bytes,
+auto ShaderStagesCreateState::GetPipelineFlags() const -> vk::PipelineCreateFlags {
+	// Identifier is enough only if pipeline is found in pipeline cache
+	return uses_identifiers ? vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequired : vk::PipelineCreateFlags{};
+}
+
+void CreateShaderModuleInfos(std::span<const PipelineStage> stages, ShaderCode* p_code,
 							 vk::ShaderModuleCreateInfo*		p_shader_module_create_infos,
 							 vk::PipelineShaderStageCreateInfo* p_shader_stages) {
 	for (auto [i, stage] : util::enumerate(stages)) {
 		// Load or compile shader
-		p_bytes[i] = LoadShader(stage);
+		p_code[i] = LoadShaderCode(stage);
 
 		// Create shader module info
 		p_shader_module_create_infos[i] = vk::ShaderModuleCreateInfo{
-			.codeSize = p_bytes[i].size(),
-			.pCode	  = reinterpret_cast<const u32*>(p_bytes[i].data()),
+			.codeSize = p_code[i].GetSize(),
+			.pCode	  = p_code[i].GetData(),
 		};
 		
 		// Create shader stage info
@@ -94,4 +107,71 @@ void CreateVertexDescriptionsFromAttributes(std::span<vk::Format const>			 verte
 	*p_stride = attribute_size;
 }
 
-} // namespace VB_NAMESPACE
+auto GraphicsPipelineCreateState::Fill(GraphicsPipelineInfo const&                      info,
+									   std::span<vk::PipelineShaderStageCreateInfo const> shader_stages)
+	-> vk::GraphicsPipelineCreateInfo {
+	attribute_descs.resize(info.vertex_attributes.size());
+	u32 attribute_size = 0;
+	CreateVertexDescriptionsFromAttributes(info.vertex_attributes, attribute_descs.data(), &attribute_size);
+
+	binding_description = vk::VertexInputBindingDescription{
+		.binding   = 0,
+		.stride	   = attribute_size,
+		.inputRate = vk::VertexInputRate::eVertex,
+	};
+
+	vertex_input = vk::PipelineVertexInputStateCreateInfo{
+		.vertexBindingDescriptionCount	 = 1,
+		.pVertexBindingDescriptions		 = &binding_description,
+		.vertexAttributeDescriptionCount = static_cast<u32>(attribute_descs.size()),
+		.pVertexAttributeDescriptions	 = attribute_descs.data(),
+	};
+
+	dynamic = vk::PipelineDynamicStateCreateInfo{
+		.dynamicStateCount = static_cast<u32>(info.dynamic_states.size()),
+		.pDynamicStates	   = reinterpret_cast<const vk::DynamicState*>(info.dynamic_states.data()),
+	};
+
+	rendering = vk::PipelineRenderingCreateInfo{
+		.viewMask				 = 0,
+		.colorAttachmentCount	 = static_cast<u32>(info.color_formats.size()),
+		.pColorAttachmentFormats = reinterpret_cast<const vk::Format*>(info.color_formats.data()),
+		.depthAttachmentFormat	 = info.depth_format,
+		.stencilAttachmentFormat = info.stencil_format,
+	};
+
+	// if we have less blend attachments, than color attachments, just fill with the first one
+	blend_attachments.resize(info.color_formats.size());
+	auto end = std::copy_n(info.blend_attachments.begin(),
+						   std::min(info.blend_attachments.size(), info.color_formats.size()),
+						   blend_attachments.begin());
+	std::fill(end, blend_attachments.end(), defaults::kBlendAttachment);
+
+	color_blend = vk::PipelineColorBlendStateCreateInfo{
+		.logicOpEnable	 = info.color_blend.logicOpEnable,
+		.logicOp		 = info.color_blend.logicOp,
+		.attachmentCount = static_cast<u32>(blend_attachments.size()),
+		.pAttachments	 = blend_attachments.data(),
+		.blendConstants	 = info.color_blend.blendConstants,
+	};
+
+	return vk::GraphicsPipelineCreateInfo{
+		.pNext				 = &rendering,
+		.stageCount			 = static_cast<u32>(shader_stages.size()),
+		.pStages			 = shader_stages.data(),
+		.pVertexInputState	 = &vertex_input,
+		.pInputAssemblyState = &info.input_assembly,
+		.pTessellationState	 = info.tessellation ? &info.tessellation.value() : nullptr,
+		.pViewportState		 = &info.viewport,
+		.pRasterizationState = &info.rasterization,
+		.pMultisampleState	 = &info.multisample,
+		.pDepthStencilState	 = &info.depth_stencil,
+		.pColorBlendState	 = &color_blend,
+		.pDynamicState		 = &dynamic,
+		.layout				 = info.layout,
+		.basePipelineHandle	 = nullptr,
+		.basePipelineIndex	 = -1,
+	};
+}
+
+} // namespace VB_NAMESPACE
\ No newline at end of file
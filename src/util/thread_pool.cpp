@@ -0,0 +1,93 @@
+#ifndef VB_USE_STD_MODULE
+#include <algorithm>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <utility>
+#else
+import std;
+#endif
+
+#include "vulkan_backend/util/thread_pool.hpp"
+
+namespace VB_NAMESPACE {
+ThreadPool::ThreadPool(u32 thread_count) {
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads.reserve(thread_count);
+	for (u32 i = 0; i < thread_count; ++i) {
+		threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(mutex);
+		stop = true;
+	}
+	task_available.notify_all();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	{
+		std::lock_guard lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	task_available.notify_one();
+}
+
+void ThreadPool::Wait() {
+	std::unique_lock lock(mutex);
+	tasks_done.wait(lock, [this] { return tasks.empty() && active_tasks == 0; });
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::function<void(std::size_t begin, std::size_t end)> const& function) {
+	if (count == 0) {
+		return;
+	}
+	std::size_t const range_count = std::min<std::size_t>(count, threads.size());
+	std::size_t const range_size  = count / range_count;
+	std::size_t const remainder   = count % range_count;
+
+	std::latch done(static_cast<std::ptrdiff_t>(range_count));
+	std::size_t begin = 0;
+	for (std::size_t i = 0; i < range_count; ++i) {
+		std::size_t const end = begin + range_size + (i < remainder ? 1 : 0);
+		Submit([&function, &done, begin, end] {
+			function(begin, end);
+			done.count_down();
+		});
+		begin = end;
+	}
+	done.wait();
+}
+
+void ThreadPool::WorkerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex);
+			task_available.wait(lock, [this] { return stop || !tasks.empty(); });
+			if (tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+			++active_tasks;
+		}
+		task();
+		{
+			std::lock_guard lock(mutex);
+			--active_tasks;
+			if (tasks.empty() && active_tasks == 0) {
+				tasks_done.notify_all();
+			}
+		}
+	}
+}
+} // namespace VB_NAMESPACE
@@ -122,4 +122,197 @@ void LoadInstanceCooperativeMatrix2FunctionsNV(vk::Instance instance) {
 namespace VB_NAMESPACE {
 void LoadDeviceCooperativeMatrix2FunctionsNV(vk::Device device) {}
 } // namespace VB_NAMESPACE
-#endif // VK_NV_cooperative_matrix2
\ No newline at end of file
+#endif // VK_NV_cooperative_matrix2
+
+#ifdef VK_EXT_shader_module_identifier
+PFN_vkGetShaderModuleIdentifierEXT pfn_vkGetShaderModuleIdentifierEXT = nullptr;
+
+#ifndef VK_NO_LOAD_FUNCTIONS
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleIdentifierEXT(VkDevice device, VkShaderModule shaderModule,
+														  VkShaderModuleIdentifierEXT* pIdentifier) {
+	return pfn_vkGetShaderModuleIdentifierEXT(device, shaderModule, pIdentifier);
+}
+#endif // !VK_NO_LOAD_FUNCTIONS
+
+namespace VB_NAMESPACE {
+void LoadDeviceShaderModuleIdentifierFunctionsEXT(vk::Device device) {
+	pfn_vkGetShaderModuleIdentifierEXT = reinterpret_cast<PFN_vkGetShaderModuleIdentifierEXT>(
+		vkGetDeviceProcAddr(device, "vkGetShaderModuleIdentifierEXT"));
+}
+} // namespace VB_NAMESPACE
+#else  // VK_EXT_shader_module_identifier
+namespace VB_NAMESPACE {
+void LoadDeviceShaderModuleIdentifierFunctionsEXT(vk::Device device) {}
+} // namespace VB_NAMESPACE
+#endif // VK_EXT_shader_module_identifier
+
+#ifdef VK_EXT_shader_object
+// Commands of VK_EXT_shader_object, including dynamic state commands it requires
+PFN_vkCreateShadersEXT pfn_vkCreateShadersEXT = nullptr;
+PFN_vkDestroyShaderEXT pfn_vkDestroyShaderEXT = nullptr;
+PFN_vkCmdBindShadersEXT pfn_vkCmdBindShadersEXT = nullptr;
+PFN_vkCmdSetVertexInputEXT pfn_vkCmdSetVertexInputEXT = nullptr;
+PFN_vkCmdSetPatchControlPointsEXT pfn_vkCmdSetPatchControlPointsEXT = nullptr;
+PFN_vkCmdSetLogicOpEXT pfn_vkCmdSetLogicOpEXT = nullptr;
+PFN_vkCmdSetTessellationDomainOriginEXT pfn_vkCmdSetTessellationDomainOriginEXT = nullptr;
+PFN_vkCmdSetDepthClampEnableEXT pfn_vkCmdSetDepthClampEnableEXT = nullptr;
+PFN_vkCmdSetPolygonModeEXT pfn_vkCmdSetPolygonModeEXT = nullptr;
+PFN_vkCmdSetRasterizationSamplesEXT pfn_vkCmdSetRasterizationSamplesEXT = nullptr;
+PFN_vkCmdSetSampleMaskEXT pfn_vkCmdSetSampleMaskEXT = nullptr;
+PFN_vkCmdSetAlphaToCoverageEnableEXT pfn_vkCmdSetAlphaToCoverageEnableEXT = nullptr;
+PFN_vkCmdSetLogicOpEnableEXT pfn_vkCmdSetLogicOpEnableEXT = nullptr;
+PFN_vkCmdSetColorBlendEnableEXT pfn_vkCmdSetColorBlendEnableEXT = nullptr;
+PFN_vkCmdSetColorBlendEquationEXT pfn_vkCmdSetColorBlendEquationEXT = nullptr;
+PFN_vkCmdSetColorWriteMaskEXT pfn_vkCmdSetColorWriteMaskEXT = nullptr;
+
+#ifndef VK_NO_LOAD_FUNCTIONS
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateShadersEXT(
+	VkDevice device, uint32_t createInfoCount, const VkShaderCreateInfoEXT* pCreateInfos,
+	const VkAllocationCallbacks* pAllocator, VkShaderEXT* pShaders) {
+	return pfn_vkCreateShadersEXT(device, createInfoCount, pCreateInfos, pAllocator, pShaders);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyShaderEXT(
+	VkDevice device, VkShaderEXT shader, const VkAllocationCallbacks* pAllocator) {
+	return pfn_vkDestroyShaderEXT(device, shader, pAllocator);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindShadersEXT(
+	VkCommandBuffer commandBuffer, uint32_t stageCount, const VkShaderStageFlagBits* pStages,
+	const VkShaderEXT* pShaders) {
+	return pfn_vkCmdBindShadersEXT(commandBuffer, stageCount, pStages, pShaders);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetVertexInputEXT(
+	VkCommandBuffer commandBuffer, uint32_t vertexBindingDescriptionCount,
+	const VkVertexInputBindingDescription2EXT* pVertexBindingDescriptions,
+	uint32_t vertexAttributeDescriptionCount,
+	const VkVertexInputAttributeDescription2EXT* pVertexAttributeDescriptions) {
+	return pfn_vkCmdSetVertexInputEXT(
+		commandBuffer, vertexBindingDescriptionCount, pVertexBindingDescriptions, vertexAttributeDescriptionCount,
+		pVertexAttributeDescriptions);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPatchControlPointsEXT(
+	VkCommandBuffer commandBuffer, uint32_t patchControlPoints) {
+	return pfn_vkCmdSetPatchControlPointsEXT(commandBuffer, patchControlPoints);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetLogicOpEXT(VkCommandBuffer commandBuffer, VkLogicOp logicOp) {
+	return pfn_vkCmdSetLogicOpEXT(commandBuffer, logicOp);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetTessellationDomainOriginEXT(
+	VkCommandBuffer commandBuffer, VkTessellationDomainOrigin domainOrigin) {
+	return pfn_vkCmdSetTessellationDomainOriginEXT(commandBuffer, domainOrigin);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthClampEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthClampEnable) {
+	return pfn_vkCmdSetDepthClampEnableEXT(commandBuffer, depthClampEnable);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPolygonModeEXT(VkCommandBuffer commandBuffer, VkPolygonMode polygonMode) {
+	return pfn_vkCmdSetPolygonModeEXT(commandBuffer, polygonMode);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetRasterizationSamplesEXT(
+	VkCommandBuffer commandBuffer, VkSampleCountFlagBits rasterizationSamples) {
+	return pfn_vkCmdSetRasterizationSamplesEXT(commandBuffer, rasterizationSamples);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetSampleMaskEXT(
+	VkCommandBuffer commandBuffer, VkSampleCountFlagBits samples, const VkSampleMask* pSampleMask) {
+	return pfn_vkCmdSetSampleMaskEXT(commandBuffer, samples, pSampleMask);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetAlphaToCoverageEnableEXT(
+	VkCommandBuffer commandBuffer, VkBool32 alphaToCoverageEnable) {
+	return pfn_vkCmdSetAlphaToCoverageEnableEXT(commandBuffer, alphaToCoverageEnable);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetLogicOpEnableEXT(VkCommandBuffer commandBuffer, VkBool32 logicOpEnable) {
+	return pfn_vkCmdSetLogicOpEnableEXT(commandBuffer, logicOpEnable);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorBlendEnableEXT(
+	VkCommandBuffer commandBuffer, uint32_t firstAttachment, uint32_t attachmentCount,
+	const VkBool32* pColorBlendEnables) {
+	return pfn_vkCmdSetColorBlendEnableEXT(commandBuffer, firstAttachment, attachmentCount, pColorBlendEnables);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorBlendEquationEXT(
+	VkCommandBuffer commandBuffer, uint32_t firstAttachment, uint32_t attachmentCount,
+	const VkColorBlendEquationEXT* pColorBlendEquations) {
+	return pfn_vkCmdSetColorBlendEquationEXT(commandBuffer, firstAttachment, attachmentCount, pColorBlendEquations);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorWriteMaskEXT(
+	VkCommandBuffer commandBuffer, uint32_t firstAttachment, uint32_t attachmentCount,
+	const VkColorComponentFlags* pColorWriteMasks) {
+	return pfn_vkCmdSetColorWriteMaskEXT(commandBuffer, firstAttachment, attachmentCount, pColorWriteMasks);
+}
+#endif // !VK_NO_LOAD_FUNCTIONS
+
+namespace VB_NAMESPACE {
+void LoadDeviceShaderObjectFunctionsEXT(vk::Device device) {
+	pfn_vkCreateShadersEXT = reinterpret_cast<PFN_vkCreateShadersEXT>(
+		vkGetDeviceProcAddr(device, "vkCreateShadersEXT"));
+	pfn_vkDestroyShaderEXT = reinterpret_cast<PFN_vkDestroyShaderEXT>(
+		vkGetDeviceProcAddr(device, "vkDestroyShaderEXT"));
+	pfn_vkCmdBindShadersEXT = reinterpret_cast<PFN_vkCmdBindShadersEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdBindShadersEXT"));
+	pfn_vkCmdSetVertexInputEXT = reinterpret_cast<PFN_vkCmdSetVertexInputEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetVertexInputEXT"));
+	pfn_vkCmdSetPatchControlPointsEXT = reinterpret_cast<PFN_vkCmdSetPatchControlPointsEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetPatchControlPointsEXT"));
+	pfn_vkCmdSetLogicOpEXT = reinterpret_cast<PFN_vkCmdSetLogicOpEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetLogicOpEXT"));
+	pfn_vkCmdSetTessellationDomainOriginEXT = reinterpret_cast<PFN_vkCmdSetTessellationDomainOriginEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetTessellationDomainOriginEXT"));
+	pfn_vkCmdSetDepthClampEnableEXT = reinterpret_cast<PFN_vkCmdSetDepthClampEnableEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetDepthClampEnableEXT"));
+	pfn_vkCmdSetPolygonModeEXT = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetPolygonModeEXT"));
+	pfn_vkCmdSetRasterizationSamplesEXT = reinterpret_cast<PFN_vkCmdSetRasterizationSamplesEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetRasterizationSamplesEXT"));
+	pfn_vkCmdSetSampleMaskEXT = reinterpret_cast<PFN_vkCmdSetSampleMaskEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetSampleMaskEXT"));
+	pfn_vkCmdSetAlphaToCoverageEnableEXT = reinterpret_cast<PFN_vkCmdSetAlphaToCoverageEnableEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetAlphaToCoverageEnableEXT"));
+	pfn_vkCmdSetLogicOpEnableEXT = reinterpret_cast<PFN_vkCmdSetLogicOpEnableEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetLogicOpEnableEXT"));
+	pfn_vkCmdSetColorBlendEnableEXT = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetColorBlendEnableEXT"));
+	pfn_vkCmdSetColorBlendEquationEXT = reinterpret_cast<PFN_vkCmdSetColorBlendEquationEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetColorBlendEquationEXT"));
+	pfn_vkCmdSetColorWriteMaskEXT = reinterpret_cast<PFN_vkCmdSetColorWriteMaskEXT>(
+		vkGetDeviceProcAddr(device, "vkCmdSetColorWriteMaskEXT"));
+}
+} // namespace VB_NAMESPACE
+#else  // VK_EXT_shader_object
+namespace VB_NAMESPACE {
+void LoadDeviceShaderObjectFunctionsEXT(vk::Device device) {}
+} // namespace VB_NAMESPACE
+#endif // VK_EXT_shader_object
+
+#ifdef VK_KHR_maintenance6
+PFN_vkCmdBindDescriptorSets2KHR pfn_vkCmdBindDescriptorSets2KHR = nullptr;
+
+#ifndef VK_NO_LOAD_FUNCTIONS
+VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorSets2KHR(
+	VkCommandBuffer commandBuffer, const VkBindDescriptorSetsInfoKHR* pBindDescriptorSetsInfo) {
+	return pfn_vkCmdBindDescriptorSets2KHR(commandBuffer, pBindDescriptorSetsInfo);
+}
+#endif // !VK_NO_LOAD_FUNCTIONS
+
+namespace VB_NAMESPACE {
+void LoadDeviceMaintenance6FunctionsKHR(vk::Device device) {
+	pfn_vkCmdBindDescriptorSets2KHR = reinterpret_cast<PFN_vkCmdBindDescriptorSets2KHR>(
+		vkGetDeviceProcAddr(device, "vkCmdBindDescriptorSets2KHR"));
+}
+} // namespace VB_NAMESPACE
+#else  // VK_KHR_maintenance6
+namespace VB_NAMESPACE {
+void LoadDeviceMaintenance6FunctionsKHR(vk::Device device) {}
+} // namespace VB_NAMESPACE
+#endif // VK_KHR_maintenance6